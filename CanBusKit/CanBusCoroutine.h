@@ -0,0 +1,79 @@
+/**
+ * \file CanBusCoroutine.h
+ * \brief Contains the coroutine awaitables for \c CanBusIo.
+ * \date 2026-10-16 15:02:47
+ * \author Rolando J. Nieves
+ *
+ * Requires C++20 coroutine support; see \c CoreKit/Coroutine.h.
+ */
+
+#ifndef _FOUNDATION_CANBUSKIT_CANBUSCOROUTINE_H_
+#define _FOUNDATION_CANBUSKIT_CANBUSCOROUTINE_H_
+
+#include <CoreKit/Coroutine.h>
+
+#if defined(RF_CK_HAS_COROUTINES)
+
+#include "CanBusFrameNotification.h"
+#include "CanBusIo.h"
+
+namespace CanBusKit
+{
+
+/**
+ * \brief Awaitable that suspends until the next CAN Bus frame arrives.
+ *
+ * The frame is handed over by reference, without copying; it remains
+ * valid until the coroutine suspends again.
+ */
+class NextFrameAwaiter : public CanBusIo::FrameWaiter
+{
+public:
+    explicit NextFrameAwaiter(CanBusIo& canIo)
+    : m_canIo(canIo), m_frame(nullptr)
+    {
+
+    }
+
+    inline bool await_ready() const noexcept { return false; }
+
+    inline void await_suspend(std::coroutine_handle<> waiter)
+    {
+        m_waiter = waiter;
+        m_canIo.addFrameWaiter(this);
+    }
+
+    inline CanBusFrameNotification const& await_resume() const noexcept { return *m_frame; }
+
+    virtual void frameReceived(CanBusFrameNotification const& theNotification)
+    {
+        m_frame = &theNotification;
+        m_waiter.resume();
+    }
+
+private:
+    CanBusIo& m_canIo;
+    CanBusFrameNotification const *m_frame;
+    std::coroutine_handle<> m_waiter;
+};
+
+
+/**
+ * \brief Wait for the next frame received by a CAN Bus device.
+ *
+ * \param[in] canIo - CAN Bus device to receive from.
+ *
+ * \return Awaitable; \c co_await it to suspend until a frame arrives.
+ */
+inline NextFrameAwaiter nextFrame(CanBusIo& canIo)
+{
+    return NextFrameAwaiter(canIo);
+}
+
+} // end namespace CanBusKit
+
+#endif /* RF_CK_HAS_COROUTINES */
+
+#endif /* !_FOUNDATION_CANBUSKIT_CANBUSCOROUTINE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
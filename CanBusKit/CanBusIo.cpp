@@ -34,6 +34,7 @@ using std::ptr_fun;
 using std::mem_fun;
 using CoreKit::InterruptListener;
 using CoreKit::InputSource;
+using CoreKit::PreReadData;
 using CoreKit::RunLoop;
 using CoreKit::PreconditionNotMetException;
 using CoreKit::OsErrorException;
@@ -50,17 +51,19 @@ static void deleteCanBusCallback(CanBusFrameCallback *aCallback)
 
 CanBusIo::CanBusIo(std::string const& canIfName, RunLoop* theRunLoop)
 : m_canBusIfName(canIfName), m_canBusIfIndex(-1), m_canFilterCount(0u), m_canBusFd(-1),
-  m_runLoop(theRunLoop), m_canIfState(CREATED)
+  m_runLoop(theRunLoop), m_canIfState(CREATED), m_firstWaiter(NULL), m_lastWaiter(NULL)
 {
 	memset(m_canFilters, 0x00, sizeof(m_canFilters));
+	this->setPreReadMode(PRM_DATA);
 }
 
 
 CanBusIo::CanBusIo(std::string const& canIfName, RunLoop* theRunLoop, std::vector<struct can_filter> const& inputFilter)
 : m_canBusIfName(canIfName), m_canBusIfIndex(-1), m_canFilterCount(0u), m_canBusFd(-1),
-  m_runLoop(theRunLoop), m_canIfState(CREATED)
+  m_runLoop(theRunLoop), m_canIfState(CREATED), m_firstWaiter(NULL), m_lastWaiter(NULL)
 {
 	memset(m_canFilters, 0x00, sizeof(m_canFilters));
+	this->setPreReadMode(PRM_DATA);
 	if (inputFilter.size() > RF_CBK_MAX_FILTER_COUNT)
 	{
 		throw InvalidInputException("CAN Bus Filter Count Too Large",
@@ -72,7 +75,6 @@ CanBusIo::CanBusIo(std::string const& canIfName, RunLoop* theRunLoop, std::vecto
 }
 
 
-
 CanBusIo::~CanBusIo()
 {
 	for_each(m_callbacks.begin(), m_callbacks.end(), &deleteCanBusCallback);
@@ -80,10 +82,6 @@ CanBusIo::~CanBusIo()
 }
 
 
-
-
-
-
 void CanBusIo::addCanFrameCallback(CanBusFrameCallback* theCallback)
 {
 	m_callbacks.push_back(theCallback);
@@ -139,18 +137,115 @@ void CanBusIo::inputAvailableFrom(InputSource* theInputSource)
 	 */
 	for (cbIdx = 0u; cbIdx < readCount; cbIdx++)
 	{
-		m_prototypeNotif.m_canId = aFrame[cbIdx].can_id;
-		m_prototypeNotif.decodeCanId();
-		m_prototypeNotif.m_canPayload.resize(aFrame[cbIdx].can_dlc, 0x00);
-		copy(&aFrame[cbIdx].data[0], &aFrame[cbIdx].data[aFrame[cbIdx].can_dlc], m_prototypeNotif.m_canPayload.begin());
-		clock_gettime(CLOCK_REALTIME, &m_prototypeNotif.m_acqTime);
-		for_each(m_callbacks.begin(), m_callbacks.end(),
-				bind2nd(mem_fun(&CanBusFrameCallback::operator()), &m_prototypeNotif));
+		this->deliverFrame(aFrame[cbIdx]);
+	}
+}
+
+
+void CanBusIo::dataAvailable(PreReadData const& readData)
+{
+	struct can_frame aFrame;
+
+	/*
+	 * CAN sockets hand out one whole frame per read, just as they do to
+	 * inputAvailableFrom().
+	 */
+	if (static_cast<ssize_t>(sizeof(struct can_frame)) == readData.result)
+
+	{
+		memcpy(&aFrame, readData.data, sizeof(aFrame));
+		this->deliverFrame(aFrame);
+	}
+}
+
+
+void CanBusIo::deliverFrame(struct can_frame const& aFrame)
+{
+	m_prototypeNotif.m_canId = aFrame.can_id;
+	m_prototypeNotif.decodeCanId();
+	m_prototypeNotif.m_canPayload.resize(aFrame.can_dlc, 0x00);
+	copy(&aFrame.data[0], &aFrame.data[aFrame.can_dlc], m_prototypeNotif.m_canPayload.begin());
+	clock_gettime(CLOCK_REALTIME, &m_prototypeNotif.m_acqTime);
+	for_each(m_callbacks.begin(), m_callbacks.end(),
+			bind2nd(mem_fun(&CanBusFrameCallback::operator()), &m_prototypeNotif));
+	this->notifyFrameWaiters();
+}
+
+
+void CanBusIo::addFrameWaiter(CanBusIo::FrameWaiter* theWaiter)
+{
+	if (NULL == theWaiter)
+	{
+		throw PreconditionNotMetException("Can not register NULL frame waiter");
+	}
+
+	theWaiter->m_nextWaiter = NULL;
+	if (NULL == m_lastWaiter)
+	{
+		m_firstWaiter = theWaiter;
+	}
+	else
+	{
+		m_lastWaiter->m_nextWaiter = theWaiter;
+	}
+	m_lastWaiter = theWaiter;
+}
+
+
+void CanBusIo::removeFrameWaiter(CanBusIo::FrameWaiter* theWaiter)
+{
+	FrameWaiter *prevWaiter = NULL;
+	FrameWaiter *aWaiter = m_firstWaiter;
+
+	while ((aWaiter != NULL) && (aWaiter != theWaiter))
+	{
+		prevWaiter = aWaiter;
+		aWaiter = aWaiter->m_nextWaiter;
+	}
+
+	if (aWaiter != NULL)
+	{
+		if (NULL == prevWaiter)
+		{
+			m_firstWaiter = aWaiter->m_nextWaiter;
+		}
+		else
+		{
+			prevWaiter->m_nextWaiter = aWaiter->m_nextWaiter;
+		}
+		if (m_lastWaiter == aWaiter)
+		{
+			m_lastWaiter = prevWaiter;
+		}
+		aWaiter->m_nextWaiter = NULL;
+	}
+}
+
+
+void CanBusIo::notifyFrameWaiters()
+{
+	FrameWaiter *aWaiter = m_firstWaiter;
+	FrameWaiter *nextWaiter = NULL;
+
+	/*
+	 * Detach the current waiters before notifying them. Waiters commonly
+	 * add themselves (or a successor) back while being notified, and those
+	 * are meant for the next frame, not this one.
+	 */
+	m_firstWaiter = NULL;
+	m_lastWaiter = NULL;
+	while (aWaiter != NULL)
+	{
+		nextWaiter = aWaiter->m_nextWaiter;
+		aWaiter->m_nextWaiter = NULL;
+		aWaiter->frameReceived(m_prototypeNotif);
+		aWaiter = nextWaiter;
 	}
 }
 
 
 void CanBusIo::fireCallback()
+
 {
 	this->inputAvailableFrom(this);
 }
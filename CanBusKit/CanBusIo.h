@@ -31,6 +31,33 @@ namespace CanBusKit
 	{
 		RF_CK_FACTORY_COMPATIBLE(CanBusIo);
 	public:
+		/**
+		 * \brief One-Shot Listener for the Next Received CAN Bus Frame
+		 *
+		 * Unlike \c CanBusFrameCallback instances, waiters are not owned by
+		 * the \c CanBusIo instance and are dropped after being notified of a
+		 * single frame, which suits listeners that live on the stack or in a
+		 * coroutine frame (see \c CanBusKit/CanBusCoroutine.h).
+		 */
+		class FrameWaiter
+		{
+		public:
+			FrameWaiter() : m_nextWaiter(NULL) {}
+			virtual ~FrameWaiter() {}
+			/**
+			 * \brief Receive the Next CAN Bus Frame
+			 *
+			 * \param theNotification Frame received; only valid for the
+			 *                        duration of the call.
+			 */
+			virtual void frameReceived(CanBusFrameNotification const& theNotification) = 0;
+
+		private:
+			FrameWaiter *m_nextWaiter;
+
+			friend class CanBusIo;
+		};
+
 		CanBusIo(std::string const& canIfName, CoreKit::RunLoop* theRunLoop);
 		CanBusIo(std::string const& canIfName, CoreKit::RunLoop* theRunLoop, std::vector<struct can_filter> const& inputFilter);
 		virtual ~CanBusIo();
@@ -38,10 +65,24 @@ namespace CanBusKit
 		inline std::string const& canBusIfName() const { return m_canBusIfName; }
 		inline size_t canFilterCount() const { return m_canFilterCount; }
 		void addCanFrameCallback(CanBusFrameCallback* theCallback);
+		/**
+		 * \brief Notify a Waiter of the Next Frame Received
+		 *
+		 * \param theWaiter Waiter to notify; must remain valid until it is
+		 *                  notified or removed.
+		 */
+		void addFrameWaiter(FrameWaiter* theWaiter);
+		/**
+		 * \brief Cancel a Waiter Added via \c addFrameWaiter()
+		 *
+		 * \param theWaiter Waiter to cancel.
+		 */
+		void removeFrameWaiter(FrameWaiter* theWaiter);
 		virtual int fileDescriptor() const;
 		virtual InterruptListener* interruptListener() const;
 		virtual void inputAvailableFrom(InputSource* theInputSource);
 		virtual void fireCallback();
+		virtual void dataAvailable(CoreKit::PreReadData const& readData);
 		void sendCanFrame(struct can_frame* theFrame);
 		void startCan();
 		void stopCan();
@@ -56,9 +97,12 @@ namespace CanBusKit
 		std::string m_canBusIfName;
 		CoreKit::RunLoop *m_runLoop;
 		CanBusFrameNotification m_prototypeNotif;
+		FrameWaiter *m_firstWaiter;
+		FrameWaiter *m_lastWaiter;
 
 		void decipherCanBusIfIndex();
-
+		void deliverFrame(struct can_frame const& aFrame);
+		void notifyFrameWaiters();
 	};
 
 }
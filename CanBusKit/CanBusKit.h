@@ -17,7 +17,9 @@
 /*
  * CanBusKit Headers
  */
+#include <CanBusKit/CanBusCoroutine.h>
 #include <CanBusKit/CanBusFrameCallback.h>
+
 #include <CanBusKit/CanBusFrameCallbackT.h>
 #include <CanBusKit/CanBusFrameCallbackWithPredT.h>
 #include <CanBusKit/CanBusFrameNotification.h>
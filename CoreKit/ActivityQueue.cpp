@@ -0,0 +1,162 @@
+/**
+ * \file ActivityQueue.cpp
+ * \brief Contains the implementation of the \c ActivityQueue class.
+ * \date 2026-10-16 13:05:32
+ * \author Rolando J. Nieves
+ */
+
+#include <cstring>
+
+#include <CoreKit/InputSource.h>
+
+#include "ActivityQueue.h"
+
+
+namespace CoreKit
+{
+
+const unsigned ActivityQueue::NumLevels;
+
+
+ActivityQueue::ActivityQueue():
+    m_usedNodes(0u),
+    m_size(0u)
+{
+    this->clear();
+}
+
+
+void
+ActivityQueue::reserve(size_t capacity)
+{
+    if (m_nodes.size() < capacity)
+    {
+        m_nodes.resize(capacity);
+    }
+}
+
+
+void
+ActivityQueue::push(InputSource *source, uint64_t handle, uint64_t payload)
+{
+    unsigned level = source->relativePriority();
+    int32_t nodeIdx = -1;
+
+    /*
+     * Nodes are handed out sequentially and only recycled once the queue
+     * empties out, which keeps this path free of any bookkeeping. Growing
+     * the node array only happens if more input sources are queued than
+     * were reserved for.
+     */
+    if (m_usedNodes == m_nodes.size())
+    {
+        m_nodes.resize((m_nodes.size() > 0u) ? (m_nodes.size() * 2u) : 16u);
+    }
+    nodeIdx = static_cast<int32_t>(m_usedNodes++);
+    m_nodes[nodeIdx].source = source;
+    m_nodes[nodeIdx].handle = handle;
+    m_nodes[nodeIdx].payload = payload;
+    m_nodes[nodeIdx].next = -1;
+
+    if (-1 == m_tails[level])
+    {
+        m_heads[level] = nodeIdx;
+        m_levelBitmap[level / 64u] |= (1uLL << (level % 64u));
+    }
+    else
+    {
+        m_nodes[m_tails[level]].next = nodeIdx;
+    }
+    m_tails[level] = nodeIdx;
+    ++m_size;
+}
+
+
+InputSource*
+ActivityQueue::top() const
+{
+    int level = this->topLevel();
+
+    return (level != -1) ? m_nodes[m_heads[level]].source : nullptr;
+}
+
+
+uint64_t
+ActivityQueue::topHandle() const
+{
+    int level = this->topLevel();
+
+    return (level != -1) ? m_nodes[m_heads[level]].handle : 0u;
+}
+
+
+uint64_t
+ActivityQueue::topPayload() const
+{
+    int level = this->topLevel();
+
+    return (level != -1) ? m_nodes[m_heads[level]].payload : 0u;
+}
+
+
+void
+ActivityQueue::pop()
+{
+    int level = this->topLevel();
+    int32_t nodeIdx = -1;
+
+    if (-1 == level)
+    {
+        return;
+    }
+
+    nodeIdx = m_heads[level];
+    m_heads[level] = m_nodes[nodeIdx].next;
+    if (-1 == m_heads[level])
+    {
+        m_tails[level] = -1;
+        m_levelBitmap[level / 64u] &= ~(1uLL << (level % 64u));
+    }
+
+    if (0u == --m_size)
+    {
+        m_usedNodes = 0u;
+    }
+}
+
+
+void
+ActivityQueue::clear()
+{
+    for (unsigned level = 0u; level < NumLevels; ++level)
+    {
+        m_heads[level] = -1;
+        m_tails[level] = -1;
+    }
+    memset(&m_levelBitmap[0], 0x00, sizeof(m_levelBitmap));
+    m_usedNodes = 0u;
+    m_size = 0u;
+}
+
+
+int
+ActivityQueue::topLevel() const
+{
+    /*
+     * Lower relative priority values translate to a higher priority, so the
+     * front of the queue is the lowest set bit in the bitmap.
+     */
+    for (unsigned wordIdx = 0u; wordIdx < (NumLevels / 64u); ++wordIdx)
+    {
+        if (m_levelBitmap[wordIdx] != 0u)
+        {
+            return static_cast<int>(wordIdx * 64u) + __builtin_ctzll(m_levelBitmap[wordIdx]);
+        }
+    }
+
+    return -1;
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
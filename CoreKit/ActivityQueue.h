@@ -0,0 +1,133 @@
+/**
+ * \file ActivityQueue.h
+ * \brief Contains the definition of the \c ActivityQueue class.
+ * \date 2026-10-16 13:05:32
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_ACTIVITYQUEUE_H_
+#define _FOUNDATION_COREKIT_ACTIVITYQUEUE_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace CoreKit
+{
+
+class InputSource;
+
+/**
+ * \brief Priority ordered queue of input sources that exhibit activity.
+ *
+ * Input source priorities are eight bit values, so instead of a comparison
+ * based heap this queue keeps one FIFO list per priority level plus a
+ * bitmap of the levels that are not empty. Both \c push() and \c pop() are
+ * constant time operations, input sources with the same priority are
+ * serviced in the order they were pushed, and, as long as the number of
+ * queued input sources stays within the reserved capacity, no memory is
+ * allocated.
+ */
+class ActivityQueue
+{
+public:
+    /**
+     * \brief Number of distinct priority levels.
+     */
+    static const unsigned NumLevels = 256u;
+
+private:
+    struct Node
+    {
+        InputSource *source;
+        uint64_t handle;
+        uint64_t payload;
+        int32_t next;
+    };
+
+    std::vector< Node > m_nodes;
+    size_t m_usedNodes;
+    size_t m_size;
+    int32_t m_heads[NumLevels];
+    int32_t m_tails[NumLevels];
+    uint64_t m_levelBitmap[NumLevels / 64u];
+
+    int topLevel() const;
+
+public:
+    /**
+     * \brief Default constructor.
+     */
+    ActivityQueue();
+
+    /**
+     * \brief Ensure room for a number of queued input sources.
+     *
+     * \param[in] capacity - Number of input sources the queue must be able
+     *            to hold without allocating memory.
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * \brief Add an input source behind all others of the same priority.
+     *
+     * \param[in] source - Input source to queue.
+     * \param[in] handle - Opaque value stored alongside the input source;
+     *            see \c topHandle().
+     * \param[in] payload - Second opaque value stored alongside the input
+     *            source; see \c topPayload().
+     */
+    void push(InputSource *source, uint64_t handle = 0u, uint64_t payload = 0u);
+
+    /**
+     * \brief Access the highest priority input source in the queue.
+     *
+     * \return Input source at the front of the queue; \c nullptr if the
+     *         queue is empty.
+     */
+    InputSource* top() const;
+
+    /**
+     * \brief Access the value pushed alongside the input source reported by \c top().
+     *
+     * \return Opaque value given to \c push(); zero if the queue is empty.
+     */
+    uint64_t topHandle() const;
+
+    /**
+     * \brief Access the payload pushed alongside the input source reported by \c top().
+     *
+     * \return Opaque payload given to \c push(); zero if the queue is empty.
+     */
+    uint64_t topPayload() const;
+
+    /**
+     * \brief Remove the input source reported by \c top().
+     */
+    void pop();
+
+    /**
+     * \brief Remove all input sources from the queue.
+     */
+    void clear();
+
+    /**
+     * \brief Count the input sources in the queue.
+     *
+     * \return Number of queued input sources.
+     */
+    inline size_t size() const { return m_size; }
+
+    /**
+     * \brief Check whether the queue is empty.
+     *
+     * \return \c true if no input sources are queued.
+     */
+    inline bool empty() const { return (0u == m_size); }
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_ACTIVITYQUEUE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
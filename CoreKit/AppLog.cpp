@@ -5,25 +5,57 @@
  * \author Rolando J. Nieves
  */
 
+#include <sys/eventfd.h>
 #include <sys/types.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
 #include <unistd.h>
+#include <atomic>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <vector>
 #if defined(HAVE_SYSLOG_H) && (HAVE_SYSLOG_H == 1)
 # include <syslog.h>
 #endif /* defined(HAVE_SYSLOG_H) && (HAVE_SYSLOG_H == 1) */
 
+#include <CoreKit/BlockGuard.h>
+#include <CoreKit/OsErrorException.h>
+#include <CoreKit/PreconditionNotMetException.h>
 #include <CoreKit/SystemTime.h>
 
 #include "AppLog.h"
 
 using std::string;
-using std::ends;
 using std::clog;
-using std::endl;
 using CoreKit::AppLog;
 
 #define RF_AL_MAX_LOG_FIELD_SIZE (64u)
+/**
+ * \brief Bytes each thread sets aside for assembling log messages at first.
+ */
+#define RF_AL_MESSAGE_RESERVE (1024u)
+/**
+ * \brief Size of the buffer summaries of held back messages are built in.
+ */
+#define RF_AL_NOTICE_SIZE (256u)
+/**
+ * \brief Times a thread blocked on a full log ring yields before it sleeps.
+ */
+#define RF_AL_ASYNC_SPIN_LIMIT (64u)
+/**
+ * \brief Nanoseconds a thread blocked on a full log ring sleeps per attempt.
+ */
+#define RF_AL_ASYNC_BACKOFF_NSECS (50000L)
+/**
+ * \brief Bytes of formatted output the log writer gathers before a \c write().
+ */
+#define RF_AL_ASYNC_BATCH_BYTES (64u * 1024u)
+
 const CoreKit::AppLog::End CoreKit::EndLog = CoreKit::AppLog::End();
 
 #if defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1)
@@ -78,9 +110,9 @@ static int logLevelToSyslogPriority(AppLog::Level logLevel)
  * \return Human readable character string describing the provided severity
  *         level.
  */
-static string logLevelToString(AppLog::Level logLevel)
+static char const* logLevelToString(AppLog::Level logLevel)
 {
-	string result = "<unknown>";
+	char const *result = "<unknown>";
 
 	switch(logLevel)
 	{
@@ -104,6 +136,49 @@ static string logLevelToString(AppLog::Level logLevel)
 }
 
 
+/**
+ * \brief Append a Log Message to a Line of Output
+ *
+ * Formats the message the way \c AppLog writes to \c stderr, newline
+ * included, reusing the storage of both strings provided.
+ *
+ * \param lineText String the formatted line is appended to.
+ * \param timeText Scratch string for the time stamp.
+ */
+static void appendLogLine(string& lineText, string& timeText, double timestamp, string const& appName,
+	pid_t processId, AppLog::Level logLevel, char const *text, size_t length)
+{
+	char pidText[RF_AL_MAX_LOG_FIELD_SIZE];
+
+	snprintf(pidText, sizeof(pidText), "%d", static_cast<int>(processId));
+	lineText.append("[");
+	lineText.append(CoreKit::SystemTime::secsToIsoTstamp(timestamp, timeText));
+	lineText.append("] [");
+	lineText.append(appName);
+	lineText.append("] [");
+	lineText.append(pidText);
+	lineText.append("] [");
+	lineText.append(logLevelToString(logLevel));
+	lineText.append("]: ");
+	lineText.append(text, length);
+	lineText.append("\n");
+}
+
+
+/**
+ * \brief Turn the Result of \c snprintf() Into the Length of the Text Stored
+ */
+static size_t printedLength(int printResult, size_t bufferSize)
+{
+	if (printResult < 0)
+	{
+		return 0u;
+	}
+
+	return ((static_cast<size_t>(printResult) < bufferSize) ? static_cast<size_t>(printResult) : (bufferSize - 1u));
+}
+
+
 /*
  * This seems redundant, but the C++ compiler demands that template
  * specializations be defined within the same namespace as they are
@@ -111,10 +186,521 @@ static string logLevelToString(AppLog::Level logLevel)
  * this requirement.
  */
 namespace CoreKit {
+
+/**
+ * \brief Stream Buffer over a Reused Character Array
+ *
+ * The array grows when a message does not fit and never shrinks, so once a
+ * thread has assembled its longest message, assembling another allocates
+ * nothing.
+ */
+class LogMessageBuffer : public std::streambuf
+{
+public:
+	LogMessageBuffer()
+	: m_storage(RF_AL_MESSAGE_RESERVE)
+	{
+		this->reset();
+	}
+
+	inline void reset() { this->setp(m_storage.data(), m_storage.data() + m_storage.size()); }
+	inline char const* text() const { return this->pbase(); }
+	inline size_t length() const { return static_cast<size_t>(this->pptr() - this->pbase()); }
+
+protected:
+	virtual int_type overflow(int_type ch) override
+	{
+		size_t used = this->length();
+
+		if (traits_type::eq_int_type(ch, traits_type::eof()))
+		{
+			return traits_type::not_eof(ch);
+		}
+
+		m_storage.resize(m_storage.size() * 2u);
+		this->setp(m_storage.data(), m_storage.data() + m_storage.size());
+		this->pbump(static_cast<int>(used));
+		*this->pptr() = traits_type::to_char_type(ch);
+		this->pbump(1);
+
+		return ch;
+	}
+
+private:
+	std::vector<char> m_storage;
+};
+
+
+/**
+ * \brief Log Message Being Assembled by a Thread
+ *
+ * Each thread has one, so threads logging at the same time never touch each
+ * other's messages and need no lock until the message is written out. It
+ * serves one \c AppLog instance at a time: starting a message on another
+ * instance discards an unfinished one.
+ */
+struct LogAssembly
+{
+	uint64_t owner;
+	AppLog::Level level;
+	/**
+	 * \brief Rate-limited call site the message comes from, if any.
+	 */
+	LogThrottle *site;
+	LogMessageBuffer buffer;
+	std::ostream stream;
+	string lineText;
+	string timeText;
+
+	LogAssembly()
+	: owner(0u), level(AppLog::LL_DEBUG), site(nullptr), stream(&buffer)
+	{
+		lineText.reserve(RF_AL_MESSAGE_RESERVE);
+	}
+};
+
+static thread_local LogAssembly s_assembly;
+static std::atomic<uint64_t> s_lastLogSerial(0u);
+
+
+/**
+ * \brief Access the Calling Thread's Message for an \c AppLog Instance
+ *
+ * \param logSerial Serial number of the \c AppLog instance.
+ *
+ * \return Message under assembly, emptied if it belonged to another instance.
+ */
+static LogAssembly& assemblyFor(uint64_t logSerial)
+{
+	LogAssembly& assembly = s_assembly;
+
+	if (assembly.owner != logSerial)
+	{
+		assembly.owner = logSerial;
+		assembly.level = AppLog::LL_DEBUG;
+		assembly.site = nullptr;
+		assembly.buffer.reset();
+		assembly.stream.clear();
+	}
+
+	return assembly;
+}
+
+
+/**
+ * \brief One Message Waiting in an Asynchronous Log Ring
+ */
+struct AsyncLogRecord
+{
+	double timestamp;
+	AppLog::Level level;
+	size_t length;
+	char text[RF_AL_ASYNC_MESSAGE_SIZE];
+};
+
+
+/**
+ * \brief Messages Logged by One Thread, Waiting for the Log Writer
+ *
+ * Only the owning thread advances \c head. The log writer advances \c tail
+ * once it has copied a record out. Under \c AppLog::OP_DROP_OLDEST the owning
+ * thread also advances \c tail, to discard the oldest record and reuse its
+ * slot; the writer then fails to advance \c tail itself and throws away its
+ * copy, which may have been taken while the slot was being overwritten.
+ */
+struct AsyncLogRing
+{
+	std::vector<AsyncLogRecord> records;
+	uint64_t mask;
+	alignas(64) std::atomic<uint64_t> head;
+	alignas(64) std::atomic<uint64_t> tail;
+	/**
+	 * \brief Set once the owning thread will not log into the ring again,
+	 *        so the writer frees it once drained.
+	 */
+	std::atomic<bool> retired;
+
+	explicit AsyncLogRing(size_t capacity)
+	: records(capacity), mask(capacity - 1u), head(0u), tail(0u), retired(false)
+	{}
+};
+
+
+/**
+ * \brief Ring of the Calling Thread, as Last Looked Up
+ *
+ * Tagged with the asynchronous session it belongs to, so that a ring cached
+ * under an earlier \c startAsync(), or under another \c AppLog instance, is
+ * never used again. The ring is retired when the thread exits, or when the
+ * thread moves on to another session's ring; the weak reference keeps that
+ * from touching a ring its session already released.
+ */
+struct AsyncLogRingCache
+{
+	uint64_t session;
+	AsyncLogRing *ring;
+	std::weak_ptr<AsyncLogRing> handle;
+
+	AsyncLogRingCache()
+	: session(0u), ring(nullptr)
+	{}
+
+	~AsyncLogRingCache()
+	{
+		this->retire();
+	}
+
+	void retire()
+	{
+		std::shared_ptr<AsyncLogRing> theRing = handle.lock();
+
+		if (theRing)
+		{
+			theRing->retired.store(true, std::memory_order_release);
+		}
+		handle.reset();
+		session = 0u;
+		ring = nullptr;
+	}
+};
+
+static thread_local AsyncLogRingCache s_ringCache;
+static std::atomic<uint64_t> s_lastAsyncSession(0u);
+
+
+/**
+ * \brief Asynchronous Mode State of an \c AppLog Instance
+ */
+struct AppLog::AsyncState
+{
+	std::string appName;
+	bool doStdErr;
+	OverflowPolicy overflowPolicy;
+	size_t ringCapacity;
+	uint64_t session;
+	pid_t processId;
+	int eventFd;
+	pthread_t writerThread;
+	pthread_mutex_t ringsMutex;
+	std::vector< std::shared_ptr<AsyncLogRing> > rings;
+	std::atomic<uint64_t> ringsVersion;
+	std::atomic<bool> wakePending;
+	std::atomic<bool> stopRequested;
+	std::atomic<uint64_t> droppedCount;
+
+	/*
+	 * Used by the writer thread alone.
+	 */
+	std::vector<AsyncLogRing*> writerRings;
+	uint64_t writerRingsVersion;
+	std::string batchText;
+	std::string timeText;
+	AsyncLogRecord current;
+	uint64_t reportedDrops;
+
+	AsyncState(std::string const& theAppName, bool stdErr, OverflowPolicy policy, size_t capacity);
+	~AsyncState();
+
+	AsyncLogRing* ringForCallingThread();
+	void push(Level level, char const *text, size_t length);
+	void wake();
+	bool writeOut();
+	void releaseRetiredRings();
+	void formatRecord(double timestamp, Level level, char const *text, size_t length);
+	void flushBatch();
+
+	static void* writerEntry(void *arg);
+};
+
+
+AppLog::AsyncState::AsyncState(std::string const& theAppName, bool stdErr, OverflowPolicy policy, size_t capacity)
+: appName(theAppName), doStdErr(stdErr), overflowPolicy(policy), ringCapacity(2u),
+  session(++s_lastAsyncSession), processId(getpid()), eventFd(-1), ringsVersion(0u),
+  wakePending(false), stopRequested(false), droppedCount(0u), writerRingsVersion(0u), reportedDrops(0u)
+{
+	while (ringCapacity < capacity)
+	{
+		ringCapacity <<= 1u;
+	}
+
+	eventFd = eventfd(0u, EFD_CLOEXEC);
+	if (-1 == eventFd)
+	{
+		throw OsErrorException("eventfd()", errno);
+	}
+	pthread_mutex_init(&ringsMutex, nullptr);
+	batchText.reserve(RF_AL_ASYNC_BATCH_BYTES + RF_AL_ASYNC_MESSAGE_SIZE + 256u);
+}
+
+
+AppLog::AsyncState::~AsyncState()
+{
+	pthread_mutex_destroy(&ringsMutex);
+	close(eventFd);
+	eventFd = -1;
+}
+
+
+AsyncLogRing* AppLog::AsyncState::ringForCallingThread()
+{
+	if ((s_ringCache.session != session) || (nullptr == s_ringCache.ring))
+	{
+		s_ringCache.retire();
+
+		BlockGuard ringsGuard(&ringsMutex);
+
+		rings.push_back(std::make_shared<AsyncLogRing>(ringCapacity));
+		ringsVersion.fetch_add(1u, std::memory_order_release);
+		s_ringCache.session = session;
+		s_ringCache.ring = rings.back().get();
+		s_ringCache.handle = rings.back();
+	}
+
+	return s_ringCache.ring;
+}
+
+
+void AppLog::AsyncState::push(Level level, char const *text, size_t length)
+{
+	AsyncLogRing *ring = this->ringForCallingThread();
+	uint64_t head = ring->head.load(std::memory_order_relaxed);
+	unsigned spinCount = 0u;
+
+	while ((head - ring->tail.load(std::memory_order_acquire)) >= ringCapacity)
+	{
+		if (OP_DROP_OLDEST == overflowPolicy)
+		{
+			uint64_t oldest = head - ringCapacity;
+
+			/*
+			 * Failure means the writer took the oldest record first, which
+			 * makes room just as well.
+			 */
+			if (ring->tail.compare_exchange_strong(oldest, oldest + 1u, std::memory_order_acq_rel))
+			{
+				droppedCount.fetch_add(1u, std::memory_order_relaxed);
+			}
+		}
+		else
+		{
+			this->wake();
+			if (spinCount < RF_AL_ASYNC_SPIN_LIMIT)
+			{
+				++spinCount;
+				sched_yield();
+			}
+			else
+			{
+				struct timespec backoff = { 0, RF_AL_ASYNC_BACKOFF_NSECS };
+
+				nanosleep(&backoff, nullptr);
+			}
+		}
+	}
+
+	AsyncLogRecord& record = ring->records[head & ring->mask];
+	record.timestamp = SystemTime::now();
+	record.level = level;
+	record.length = (length < RF_AL_ASYNC_MESSAGE_SIZE) ? length : RF_AL_ASYNC_MESSAGE_SIZE;
+
+	memcpy(record.text, text, record.length);
+	ring->head.store(head + 1u, std::memory_order_release);
+
+	this->wake();
+}
+
+
+void AppLog::AsyncState::wake()
+{
+	if (!wakePending.exchange(true, std::memory_order_seq_cst))
+	{
+		eventfd_write(eventFd, 1u);
+	}
+}
+
+
+bool AppLog::AsyncState::writeOut()
+{
+	uint64_t dropsNow = 0u;
+	bool result = false;
+	bool anyRetired = false;
+
+	if (ringsVersion.load(std::memory_order_acquire) != writerRingsVersion)
+	{
+		BlockGuard ringsGuard(&ringsMutex);
+
+		writerRings.clear();
+		for (size_t ringIdx = 0u; ringIdx < rings.size(); ++ringIdx)
+		{
+			writerRings.push_back(rings[ringIdx].get());
+		}
+		writerRingsVersion = ringsVersion.load(std::memory_order_relaxed);
+	}
+
+	for (size_t ringIdx = 0u; ringIdx < writerRings.size(); ++ringIdx)
+	{
+		AsyncLogRing *ring = writerRings[ringIdx];
+		uint64_t tail = ring->tail.load(std::memory_order_acquire);
+		size_t budget = ringCapacity;
+
+		/*
+		 * One ring's worth per pass, so a thread that never stops logging
+		 * can not keep the others waiting; it keeps the writer awake anyway.
+		 */
+		while ((budget > 0u) && (tail != ring->head.load(std::memory_order_acquire)))
+		{
+			AsyncLogRecord const& slot = ring->records[tail & ring->mask];
+
+			current.timestamp = slot.timestamp;
+			current.level = slot.level;
+			current.length = (slot.length < RF_AL_ASYNC_MESSAGE_SIZE) ? slot.length : RF_AL_ASYNC_MESSAGE_SIZE;
+			memcpy(current.text, slot.text, current.length);
+			if (ring->tail.compare_exchange_strong(tail, tail + 1u, std::memory_order_acq_rel))
+			{
+				this->formatRecord(current.timestamp, current.level, current.text, current.length);
+				++tail;
+				--budget;
+			}
+		}
+		result = result || (0u == budget);
+		anyRetired = anyRetired || ring->retired.load(std::memory_order_relaxed);
+	}
+
+	if (anyRetired)
+	{
+		this->releaseRetiredRings();
+	}
+
+	dropsNow = droppedCount.load(std::memory_order_relaxed);
+	if (dropsNow != reportedDrops)
+	{
+		char dropText[RF_AL_MAX_LOG_FIELD_SIZE];
+		int dropTextLen = snprintf(dropText, sizeof(dropText), "%llu log messages dropped.",
+			static_cast<unsigned long long>(dropsNow - reportedDrops));
+
+		reportedDrops = dropsNow;
+		this->formatRecord(SystemTime::now(), AppLog::LL_WARNING, dropText, static_cast<size_t>(dropTextLen));
+	}
+
+	this->flushBatch();
+
+	return result;
+}
+
+
+void AppLog::AsyncState::releaseRetiredRings()
+{
+	BlockGuard ringsGuard(&ringsMutex);
+	size_t keptRings = 0u;
+
+	/*
+	 * A retired ring gets no more messages, so once the writer has caught
+	 * up with it, it is done with. The owning thread may still be on its
+	 * way out, which is why its cache only holds a weak reference.
+	 */
+	for (size_t ringIdx = 0u; ringIdx < rings.size(); ++ringIdx)
+	{
+		AsyncLogRing *ring = rings[ringIdx].get();
+
+		if (!ring->retired.load(std::memory_order_acquire) ||
+			(ring->tail.load(std::memory_order_acquire) != ring->head.load(std::memory_order_acquire)))
+		{
+			rings[keptRings++] = rings[ringIdx];
+		}
+	}
+	if (keptRings == rings.size())
+	{
+		return;
+	}
+	rings.resize(keptRings);
+
+	writerRings.clear();
+	for (size_t ringIdx = 0u; ringIdx < rings.size(); ++ringIdx)
+	{
+		writerRings.push_back(rings[ringIdx].get());
+	}
+	writerRingsVersion = ringsVersion.fetch_add(1u, std::memory_order_release) + 1u;
+}
+
+
+void AppLog::AsyncState::formatRecord(double timestamp, Level level, char const *text, size_t length)
+{
+#if defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1)
+	syslog(logLevelToSyslogPriority(level), "%.*s", static_cast<int>(length), text);
+#endif /* defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1) */
+
+	if (!doStdErr)
+	{
+		return;
+	}
+
+	appendLogLine(batchText, timeText, timestamp, appName, processId, level, text, length);
+	if (batchText.size() >= RF_AL_ASYNC_BATCH_BYTES)
+	{
+		this->flushBatch();
+	}
+}
+
+
+void AppLog::AsyncState::flushBatch()
+{
+	size_t written = 0u;
+
+	while (written < batchText.size())
+	{
+		ssize_t result = write(STDERR_FILENO, batchText.data() + written, batchText.size() - written);
+
+		if (result > 0)
+		{
+			written += static_cast<size_t>(result);
+		}
+		else if ((result < 0) && (EINTR == errno))
+		{
+			continue;
+		}
+		else
+		{
+			// Nowhere left to report the error; the batch is lost.
+			break;
+		}
+	}
+	batchText.clear();
+}
+
+
+void* AppLog::AsyncState::writerEntry(void *arg)
+{
+	AsyncState *state = static_cast<AsyncState*>(arg);
+	bool stopping = false;
+	eventfd_t readValue = 0u;
+
+	while (!stopping)
+	{
+		if ((eventfd_read(state->eventFd, &readValue) < 0) && (EINTR == errno))
+		{
+			continue;
+		}
+
+		/*
+		 * Same reasoning as TaskQueue::fireCallback(): a message pushed after
+		 * the flag is cleared is either written now or raises the flag again.
+		 */
+		stopping = state->stopRequested.load(std::memory_order_seq_cst);
+		state->wakePending.store(false, std::memory_order_seq_cst);
+		while (state->writeOut())
+		{
+			// Some ring still had messages past its share; take another pass.
+		}
+	}
+
+	return nullptr;
+}
+
+
 template<>
 AppLog& AppLog::operator << <AppLog::Level> (AppLog::Level logLevel)
 {
-	m_logLevel = logLevel;
+	assemblyFor(m_serial).level = logLevel;
 
 	return *this;
 }
@@ -123,40 +709,110 @@ AppLog& AppLog::operator << <AppLog::Level> (AppLog::Level logLevel)
 template<>
 AppLog& AppLog::operator << <AppLog::End> (AppLog::End endMark)
 {
-	m_currentLogMsg << ends;
-#if defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1)
-    if (m_logLevel >= m_minLevel)
+	LogAssembly& assembly = assemblyFor(m_serial);
+	LogThrottle *site = assembly.site;
+	uint64_t repeatCount = 0u;
+
+	assembly.site = nullptr;
+    if (assembly.level < m_minLevel)
     {
-        syslog(logLevelToSyslogPriority(m_logLevel), "%s", m_currentLogMsg.str().c_str());
+        // Not published; just start over.
     }
-#endif /* defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1) */
-
-    if (m_doStdErr && (m_logLevel >= m_minLevel))
+    else if (nullptr == site)
     {
-        string log_time;
-        clog
-            << "["
-            << SystemTime::secsToIsoTstamp(SystemTime::now(), log_time)
-            << "] ["
-            << m_appName
-            << "] ["
-            << getpid()
-            << "] ["
-            << logLevelToString(m_logLevel)
-            << "]: "
-            << m_currentLogMsg.str()
-            << endl;
+        this->publish(assembly.level, assembly.buffer.text(), assembly.buffer.length());
     }
-    m_currentLogMsg.str("");
-    m_currentLogMsg.clear();
+    else if (!site->collapse(LogThrottle::hashText(assembly.buffer.text(), assembly.buffer.length()), repeatCount))
+    {
+        if (repeatCount > 0u)
+        {
+            this->publishRepeats(*site, assembly.level, repeatCount);
+        }
+        this->publish(assembly.level, assembly.buffer.text(), assembly.buffer.length());
+    }
+    assembly.buffer.reset();
+    assembly.stream.clear();
 
     return *this;
 }
+
+
+std::ostream& AppLog::messageStream()
+{
+	return assemblyFor(m_serial).stream;
+}
+
+
+bool AppLog::admit(LogThrottle& site, Level logLevel)
+{
+	uint64_t suppressedCount = 0u;
+	uint64_t repeatCount = 0u;
+	bool result = site.admit(suppressedCount, repeatCount);
+
+	if (repeatCount > 0u)
+	{
+		this->publishRepeats(site, logLevel, repeatCount);
+	}
+	if (suppressedCount > 0u)
+	{
+		char noticeText[RF_AL_NOTICE_SIZE];
+		int noticeLength = snprintf(noticeText, sizeof(noticeText), "%llu messages from %s:%u suppressed.",
+			static_cast<unsigned long long>(suppressedCount), site.fileName(), site.lineNumber());
+
+		this->publish(logLevel, noticeText, printedLength(noticeLength, sizeof(noticeText)));
+	}
+	if (result)
+	{
+		assemblyFor(m_serial).site = &site;
+	}
+
+	return result;
+}
+
+
+void AppLog::publishRepeats(LogThrottle& site, Level logLevel, uint64_t repeatCount)
+{
+	char noticeText[RF_AL_NOTICE_SIZE];
+	int noticeLength = snprintf(noticeText, sizeof(noticeText), "Previous message from %s:%u repeated %llu more times.",
+		site.fileName(), site.lineNumber(), static_cast<unsigned long long>(repeatCount));
+
+	this->publish(logLevel, noticeText, printedLength(noticeLength, sizeof(noticeText)));
+}
+
+
+void AppLog::publish(Level logLevel, char const *msgText, size_t msgLength)
+{
+	if (m_async != nullptr)
+	{
+		m_async->push(logLevel, msgText, msgLength);
+		return;
+	}
+
+#if defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1)
+	syslog(logLevelToSyslogPriority(logLevel), "%.*s", static_cast<int>(msgLength), msgText);
+#endif /* defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1) */
+
+	if (m_doStdErr)
+	{
+		LogAssembly& assembly = s_assembly;
+
+		/*
+		 * One write per line, so lines from threads logging at the same
+		 * time do not interleave.
+		 */
+		assembly.lineText.clear();
+		appendLogLine(assembly.lineText, assembly.timeText, SystemTime::now(), m_appName, getpid(),
+			logLevel, msgText, msgLength);
+		clog.write(assembly.lineText.data(), static_cast<std::streamsize>(assembly.lineText.size()));
+		clog.flush();
+	}
+}
 }
 
 
 AppLog::AppLog(std::string const& appName, bool doStdErr)
-: m_appName(appName), m_logLevel(AppLog::LL_DEBUG), m_minLevel(AppLog::LL_DEBUG), m_doStdErr(doStdErr)
+: m_appName(appName), m_minLevel(AppLog::LL_DEBUG), m_doStdErr(doStdErr), m_async(nullptr),
+  m_serial(++s_lastLogSerial)
 {
 #if defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1)
 	int options = LOG_PID;
@@ -167,12 +823,65 @@ AppLog::AppLog(std::string const& appName, bool doStdErr)
 
 AppLog::~AppLog()
 {
+	this->stopAsync();
 #if defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1)
 	closelog();
 #endif /* defined(HAVE_SYSLOG) && (HAVE_SYSLOG == 1) */
 }
 
 
+void AppLog::startAsync(OverflowPolicy overflowPolicy, size_t ringCapacity)
+{
+	std::unique_ptr<AsyncState> newState;
+	sigset_t allSignals;
+	sigset_t origSignals;
+	int result = 0;
+
+	if (m_async != nullptr)
+	{
+		throw PreconditionNotMetException("Asynchronous logging already active.");
+	}
+
+	newState.reset(new AsyncState(m_appName, m_doStdErr, overflowPolicy, ringCapacity));
+
+	/*
+	 * The writer thread starts with every signal blocked, so signals meant
+	 * for a signalfd() registered later on never end up there.
+	 */
+	sigfillset(&allSignals);
+	pthread_sigmask(SIG_SETMASK, &allSignals, &origSignals);
+	result = pthread_create(&newState->writerThread, nullptr, &AsyncState::writerEntry, newState.get());
+	pthread_sigmask(SIG_SETMASK, &origSignals, nullptr);
+	if (result != 0)
+	{
+		throw OsErrorException("pthread_create()", result);
+	}
+
+	m_async = newState.release();
+}
+
+
+void AppLog::stopAsync()
+{
+	if (nullptr == m_async)
+	{
+		return;
+	}
+
+	m_async->stopRequested.store(true, std::memory_order_seq_cst);
+	eventfd_write(m_async->eventFd, 1u);
+	pthread_join(m_async->writerThread, nullptr);
+
+	delete m_async;
+	m_async = nullptr;
+}
+
+
+uint64_t AppLog::droppedCount() const
+{
+	return ((m_async != nullptr) ? m_async->droppedCount.load(std::memory_order_relaxed) : 0u);
+}
+
 
 string CoreKit::format(string const& formatStr, float floatVal)
 {
@@ -7,11 +7,79 @@
 #if !defined(EA_C35AB279_B9B1_4773_8F53_6451BE9F7BE9__INCLUDED_)
 #define EA_C35AB279_B9B1_4773_8F53_6451BE9F7BE9__INCLUDED_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
-#include <sstream>
+#include <ostream>
 
 #include "factory.h"
+#include "LogThrottle.h"
+
+/**
+ * \brief Default number of records each thread's asynchronous log ring holds.
+ */
+#define RF_AL_ASYNC_RING_CAPACITY (256u)
+/**
+ * \brief Longest message text, in bytes, an asynchronous log record holds;
+ *        longer messages are truncated.
+ */
+#define RF_AL_ASYNC_MESSAGE_SIZE (480u)
+
+#if !defined(RF_CK_LOG_COMPILED_LEVEL)
+/**
+ * \brief Least severe level, as a \c CoreKit::AppLog::Level value, that
+ *        \c RF_CK_LOG() statements are compiled in for.
+ *
+ * Normally set through the \c LOG_COMPILED_LEVEL CMake cache variable.
+ */
+# define RF_CK_LOG_COMPILED_LEVEL (0)
+#endif /* !defined(RF_CK_LOG_COMPILED_LEVEL) */
+
+/**
+ * \brief Start a Log Message Only if its Severity Level is Published
+ *
+ * Expands to an \c AppLog stream that the rest of the statement goes into,
+ * as in <tt>RF_CK_LOG(myLog, LL_DEBUG) << "Read " << count << EndLog;</tt>.
+ * Unlike with <tt>myLog << AppLog::LL_DEBUG << ...</tt>, the values that
+ * follow are neither evaluated nor formatted unless \c LL_DEBUG is at or
+ * above the log's minimum level. Statements below
+ * \c RF_CK_LOG_COMPILED_LEVEL are removed by the compiler altogether.
+ *
+ * \param theLog \c AppLog instance to write to.
+ * \param logLevel Severity level, without the \c AppLog:: prefix.
+ */
+#define RF_CK_LOG(theLog, logLevel) \
+	if (!((CoreKit::AppLog::logLevel >= RF_CK_LOG_COMPILED_LEVEL) && (theLog).isEnabled(CoreKit::AppLog::logLevel))) \
+	{} \
+	else \
+		(theLog) << CoreKit::AppLog::logLevel
+
+/**
+ * \brief Start a Log Message from a Rate-Limited, Deduplicated Call Site
+ *
+ * Works like \c RF_CK_LOG(), for statements on paths that may run once per
+ * event while something is failing. The call site publishes at most
+ * \c maxCount messages every \c intervalSecs seconds, and a message that
+ * repeats the call site's previous one is held back for up to
+ * \c intervalSecs seconds; what is held back is reported in one summary
+ * message (see \c CoreKit::LogThrottle). A message that gets through costs
+ * little more than one through \c RF_CK_LOG(); one held back by the rate
+ * limit is never formatted.
+ *
+ * \param theLog \c AppLog instance to write to.
+ * \param logLevel Severity level, without the \c AppLog:: prefix.
+ * \param maxCount Messages published per interval.
+ * \param intervalSecs Length of the interval, in seconds.
+ */
+#define RF_CK_LOG_LIMITED(theLog, logLevel, maxCount, intervalSecs) \
+	if (!((CoreKit::AppLog::logLevel >= RF_CK_LOG_COMPILED_LEVEL) && (theLog).isEnabled(CoreKit::AppLog::logLevel) && \
+	      (theLog).admit( \
+	          [&]() -> CoreKit::LogThrottle& \
+	          { static CoreKit::LogThrottle rfCkLogThrottle(__FILE__, __LINE__, (maxCount), (intervalSecs)); return rfCkLogThrottle; }(), \
+	          CoreKit::AppLog::logLevel))) \
+	{} \
+	else \
+		(theLog) << CoreKit::AppLog::logLevel
 
 namespace CoreKit
 {
@@ -34,6 +102,20 @@ namespace CoreKit
 		 * \brief Log Severity Level for a Message
 		 */
 		enum Level { LL_DEBUG = 0, LL_INFO, LL_WARNING, LL_ERROR };
+		/**
+		 * \brief What a Thread Does when its Asynchronous Log Ring is Full
+		 */
+		enum OverflowPolicy
+		{
+			/**
+			 * \brief Discard the oldest unwritten message to make room.
+			 */
+			OP_DROP_OLDEST = 0,
+			/**
+			 * \brief Wait for the log writer thread to make room.
+			 */
+			OP_BLOCK
+		};
 		/**
 		 * \brief Placeholder that Indicates the End of a Log Message
 		 */
@@ -72,39 +154,143 @@ namespace CoreKit
 		 *                 should use.
 		 */
 		inline void setMinLevel(Level minLevel) { m_minLevel = minLevel; }
+		/**
+		 * \brief Tell Whether Messages of a Severity Level are Published
+		 *
+		 * \param logLevel Severity level to check.
+		 *
+		 * \return \c true if \c logLevel is at or above the minimum level.
+		 */
+		inline bool isEnabled(Level logLevel) const { return (logLevel >= m_minLevel); }
+		/**
+		 * \brief Check a Rate-Limited Call Site Before Starting its Message
+		 *
+		 * Used by \c RF_CK_LOG_LIMITED(). Publishes the summaries of
+		 * messages and repeats the call site held back, if due, and ties the calling
+		 * thread's next message to the call site so that a repeat can be
+		 * held back too.
+		 *
+		 * \param site Rate limit and duplicate filter of the call site.
+		 * \param logLevel Severity level of the message.
+		 *
+		 * \return \c true if the message should be built and ended.
+		 */
+		bool admit(LogThrottle& site, Level logLevel);
+
+		/**
+		 * \brief Hand Log Output Over to a Background Writer Thread
+		 *
+		 * From this point on, ending a log message only copies it, along with
+		 * its severity level and time stamp, into a lock-free ring buffer
+		 * owned by the calling thread. A writer thread started here drains the
+		 * rings of all threads, formats the messages and sends each batch to
+		 * \c stderr with a single \c write() (and, where available, each
+		 * message to \c syslog()), so a burst of messages no longer stalls the
+		 * thread's \c RunLoop on terminal or \c syslog() I/O.\par
+		 *
+		 * Each thread that logs gets its ring the first time it does; the
+		 * writer thread releases it once the thread has exited and every
+		 * message in it is written out, and \c stopAsync() releases the rest.
+		 * Messages longer than \c RF_AL_ASYNC_MESSAGE_SIZE bytes are
+		 * truncated. Messages from one thread come out in order; messages
+		 * from different threads are ordered per batch, not globally.
+		 *
+		 * \param overflowPolicy What a thread does when its ring is full.
+		 * \param ringCapacity Number of messages each thread's ring holds.
+		 *                     Rounded up to the next power of two.
+		 *
+		 * \throw OsErrorException if the writer thread or its \c eventfd()
+		 *        can not be created.
+		 *
+		 * \pre
+		 * Asynchronous mode is not already active.
+		 */
+		void startAsync(OverflowPolicy overflowPolicy = OP_DROP_OLDEST, size_t ringCapacity = RF_AL_ASYNC_RING_CAPACITY);
+		/**
+		 * \brief Write Out Pending Messages and Stop the Writer Thread
+		 *
+		 * Log output returns to the calling thread. Does nothing if
+		 * asynchronous mode is not active.
+		 *
+		 * \pre
+		 * No other thread is logging through this instance.
+		 */
+		void stopAsync();
+		/**
+		 * \brief Tell Whether a Writer Thread Handles Log Output
+		 *
+		 * \return \c true between \c startAsync() and \c stopAsync().
+		 */
+		inline bool isAsync() const { return (m_async != nullptr); }
+		/**
+		 * \brief Count the Messages Discarded Because a Ring Was Full
+		 *
+		 * Only the \c OP_DROP_OLDEST policy discards messages. The writer
+		 * thread also reports new discards in the log itself.
+		 *
+		 * \return Messages discarded since \c startAsync().
+		 */
+		uint64_t droppedCount() const;
 
 		/**
 		 * \brief Add a Value to the Current Log Message
 		 *
+		 * The current log message belongs to the calling thread, so threads
+		 * may build messages at the same time without corrupting each
+		 * other's. Each thread assembles its messages in a buffer it keeps
+		 * reusing, which only allocates memory when a message is longer than
+		 * any the thread built before.
+		 *
 		 * \param streamInVal Value to add to the current log message.
 		 *
 		 * \return This \c AppLog instance after adding the value.
 		 */
 		template<class StreamInType> AppLog& operator <<(StreamInType streamInVal)
-		{ m_currentLogMsg << streamInVal; return *this; }
+		{ this->messageStream() << streamInVal; return *this; }
 
 	private:
+		struct AsyncState;
 
 		/**
 		 * \brief Identification String to go Along With All Log Messages
 		 */
 		std::string m_appName;
-		/**
-		 * \brief Character Stream Containing the Current Log Message
-		 */
-		std::stringstream m_currentLogMsg;
 		/**
 		 * \brief Minimum Severity Level to Obey when Publishing Log Messages
 		 */
 		Level m_minLevel;
-		/**
-		 * \brief Severity Level of the Current Log Message
-		 */
-		Level m_logLevel;
         /**
          * \brief In addition to syslog, if available, log to stderr.
          */
         bool m_doStdErr;
+		/**
+		 * \brief Writer thread and per-thread rings; \c nullptr unless in
+		 *        asynchronous mode.
+		 */
+		AsyncState *m_async;
+		/**
+		 * \brief Tells this instance's messages apart in each thread's
+		 *        message assembly area.
+		 */
+		uint64_t m_serial;
+
+		/**
+		 * \brief Access the Calling Thread's Current Log Message
+		 *
+		 * \return Stream the message is being assembled in.
+		 */
+		std::ostream& messageStream();
+		/**
+		 * \brief Send a Finished Message to \c syslog() and \c stderr, or
+		 *        to the Writer Thread
+		 */
+		void publish(Level logLevel, char const *msgText, size_t msgLength);
+		/**
+		 * \brief Report the Repeats of a Message Held Back by its Call Site
+		 */
+		void publishRepeats(LogThrottle& site, Level logLevel, uint64_t repeatCount);
+		AppLog(AppLog const& other);
+		AppLog& operator=(AppLog const& other);
 	};
 
 	/**
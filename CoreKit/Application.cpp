@@ -9,9 +9,11 @@
 # include <syslog.h>
 #endif /* defined(HAVE_SYSLOG_H) && (HAVE_SYSLOG_H == 1) */
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <getopt.h>
 #include <fcntl.h>
+#include <malloc.h>
 #include <cstdlib>
 #include <csignal>
 #include <cstdio>
@@ -28,6 +30,7 @@
 #include <CoreKit/RuntimeErrorException.h>
 #include <CoreKit/InvalidInputException.h>
 #include <CoreKit/OsErrorException.h>
+#include <CoreKit/SynchronizedRunLoop.h>
 
 #include "Application.h"
 
@@ -46,22 +49,35 @@ using std::cout;
 using std::max;
 using std::ofstream;
 using CoreKit::Application;
+using CoreKit::FrameScheduler;
+using CoreKit::FrameSync;
+using CoreKit::LoopGroup;
+using CoreKit::SynchronizedRunLoop;
 using CoreKit::ThreadDelegate;
 using CoreKit::Thread;
+using CoreKit::ThreadAttributes;
 using CoreKit::RunLoop;
 using CoreKit::PreconditionNotMetException;
 using CoreKit::RuntimeErrorException;
 using CoreKit::InvalidInputException;
+using CoreKit::BinaryLog;
 using CoreKit::AppLog;
+using CoreKit::EndLog;
 using CoreKit::OsErrorException;
 using CoreKit::construct;
 using CoreKit::destroy;
 
 static const string EMPTY_STRING("");
 const string Application::SCHED_SYNC_FLAG("sched-sync");
+const string Application::SCHED_SYNC_TYPE_FLAG("sched-sync-type");
 const string Application::GDB_FLAG("gdb");
 const string Application::DAEMON_FLAG("daemon");
 const string Application::PID_BASE_NAME_FLAG("pid-base-name");
+const string Application::RUNLOOP_BACKEND_FLAG("runloop-backend");
+const string Application::LOOP_GROUP_CPUS_FLAG("loop-group-cpus");
+const string Application::RT_PROFILE_FLAG("rt-profile");
+const string Application::LOG_ASYNC_FLAG("log-async");
+const string Application::BINARY_LOG_FLAG("binary-log");
 
 namespace CoreKit
 {
@@ -122,6 +138,186 @@ static void requestRunLoopTerm(Thread *aThread)
     aThread->runLoop()->terminate();
 }
 
+/**
+ * \brief Parse a List of CPU Numbers Into One Affinity Mask per CPU
+ *
+ * The \c parseCpuList() local function accepts comma separated CPU numbers
+ * and inclusive ranges (e.g., "2,3,8-11"), as used by the
+ * \c --loop-group-cpus command line flag.
+ *
+ * \param cpuList Text to parse.
+ * \param affinities Receives one mask per listed CPU, in order.
+ *
+ * \return \c true if the whole list was understood; \c false otherwise.
+ */
+static bool parseCpuList(string const& cpuList, vector<cpu_set_t>& affinities)
+{
+    stringstream listStream(cpuList);
+    string anItem;
+
+    while (std::getline(listStream, anItem, ','))
+    {
+        unsigned firstCpu = 0u;
+        unsigned lastCpu = 0u;
+        char *itemEnd = nullptr;
+
+        firstCpu = static_cast<unsigned>(strtoul(anItem.c_str(), &itemEnd, 10));
+        lastCpu = firstCpu;
+        if ('-' == *itemEnd)
+        {
+            lastCpu = static_cast<unsigned>(strtoul(itemEnd + 1, &itemEnd, 10));
+        }
+        if ((itemEnd == anItem.c_str()) || (*itemEnd != '\0') ||
+            (lastCpu < firstCpu) || (lastCpu >= CPU_SETSIZE))
+        {
+            return false;
+        }
+
+        for (unsigned aCpu = firstCpu; aCpu <= lastCpu; ++aCpu)
+        {
+            cpu_set_t cpuMask;
+
+            CPU_ZERO(&cpuMask);
+            CPU_SET(aCpu, &cpuMask);
+            affinities.push_back(cpuMask);
+        }
+    }
+
+    return !affinities.empty();
+}
+
+/**
+ * \brief Turn a Size With an Optional Suffix Into a Byte Count
+ *
+ * The \c parseByteSize() local function accepts a decimal number optionally
+ * followed by \c K, \c M or \c G (powers of 1024), e.g. "64M".
+ *
+ * \param sizeText Text to parse.
+ * \param byteCount Receives the size in bytes.
+ *
+ * \return \c true if the whole text was understood; \c false otherwise.
+ */
+static bool parseByteSize(string const& sizeText, size_t& byteCount)
+{
+    char *sizeEnd = nullptr;
+
+    byteCount = static_cast<size_t>(strtoull(sizeText.c_str(), &sizeEnd, 10));
+    if (sizeEnd == sizeText.c_str())
+    {
+        return false;
+    }
+
+    switch (*sizeEnd)
+    {
+    case 'G':
+        byteCount *= 1024u;
+        // fall through
+    case 'M':
+        byteCount *= 1024u;
+        // fall through
+    case 'K':
+        byteCount *= 1024u;
+        sizeEnd++;
+        break;
+
+    default:
+        break;
+    }
+
+    return ('\0' == *sizeEnd);
+}
+
+/**
+ * \brief Parse the Argument of the \c --rt-profile Command Line Flag
+ *
+ * The \c parseRealTimeProfile() local function accepts colon separated
+ * items, each of which sets part of a real-time profile:
+ *   - \c mlock locks the process memory;
+ *   - \c heap=SIZE prefaults that much heap;
+ *   - \c fifo=PRIORITY or \c rr=PRIORITY selects a real-time policy, and
+ *     \c other the regular one, for every thread;
+ *   - \c cpus=LIST pins the main thread (same syntax as
+ *     \c --loop-group-cpus, e.g. "2,3");
+ *   - \c stack=SIZE prefaults that much of every thread's stack.
+ *
+ * \param profileSpec Text to parse, e.g. "mlock:heap=64M:fifo=80:cpus=2".
+ * \param profile Receives the settings.
+ *
+ * \return \c true if every item was understood; \c false otherwise.
+ */
+static bool parseRealTimeProfile(string const& profileSpec, Application::RealTimeProfile& profile)
+{
+    stringstream specStream(profileSpec);
+    string anItem;
+
+    while (std::getline(specStream, anItem, ':'))
+    {
+        string::size_type equalPos = anItem.find('=');
+        string itemName = anItem.substr(0u, equalPos);
+        string itemValue = (equalPos != string::npos) ? anItem.substr(equalPos + 1u) : EMPTY_STRING;
+
+        if ("mlock" == itemName)
+        {
+            profile.lockMemory = true;
+        }
+        else if ("heap" == itemName)
+        {
+            if (!parseByteSize(itemValue, profile.heapPrefault))
+            {
+                return false;
+            }
+        }
+        else if (("fifo" == itemName) || ("rr" == itemName))
+        {
+            char *priorityEnd = nullptr;
+            int priority = static_cast<int>(strtol(itemValue.c_str(), &priorityEnd, 10));
+
+            if ((priorityEnd == itemValue.c_str()) || (*priorityEnd != '\0'))
+            {
+                return false;
+            }
+            profile.mainThread.policy = ("fifo" == itemName) ? ThreadAttributes::SP_FIFO : ThreadAttributes::SP_RR;
+            profile.mainThread.priority = priority;
+            profile.threads.policy = profile.mainThread.policy;
+            profile.threads.priority = priority;
+        }
+        else if ("other" == itemName)
+        {
+            profile.mainThread.policy = ThreadAttributes::SP_OTHER;
+            profile.threads.policy = ThreadAttributes::SP_OTHER;
+        }
+        else if ("cpus" == itemName)
+        {
+            vector<cpu_set_t> cpuMasks;
+
+            if (!parseCpuList(itemValue, cpuMasks))
+            {
+                return false;
+            }
+            CPU_ZERO(&profile.mainThread.cpus);
+            for (cpu_set_t const& aMask : cpuMasks)
+            {
+                CPU_OR(&profile.mainThread.cpus, &profile.mainThread.cpus, &aMask);
+            }
+            profile.mainThread.pinned = true;
+        }
+        else if ("stack" == itemName)
+        {
+            if (!parseByteSize(itemValue, profile.mainThread.stackPrefault))
+            {
+                return false;
+            }
+            profile.threads.stackPrefault = profile.mainThread.stackPrefault;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * \brief Print the Help String Associated with a Command Line Flag
  *
@@ -159,11 +355,22 @@ string Application::CmdLineArg::formatHelpStr() const
 }
 
 
+Application::RealTimeProfile::RealTimeProfile():
+    lockMemory(false),
+    heapPrefault(0u)
+{
+
+}
+
+
+
 Application::Application(AppDelegate* theAppDelegate):
     m_appDelegate(theAppDelegate),
     m_log(nullptr),
     m_mainThread(nullptr),
-    m_schedSyncObj(nullptr),
+    m_loopGroup(nullptr),
+    m_frameSync(nullptr),
+    m_binaryLog(nullptr),
     m_inhibitStartup(false)
 {
     /*
@@ -185,6 +392,13 @@ Application::Application(AppDelegate* theAppDelegate):
             "Scheduler synchronization object to use."
         )
     );
+    this->addCmdLineArgDef(
+        CmdLineArg(
+            Application::SCHED_SYNC_TYPE_FLAG,
+            true,
+            "Kind of scheduler synchronization object=(sem|eventfd|futex)"
+        )
+    );
     this->addCmdLineArgDef(
         CmdLineArg(
             "log-level",
@@ -214,6 +428,42 @@ Application::Application(AppDelegate* theAppDelegate):
             "the application name."
         )
     );
+    this->addCmdLineArgDef(
+        CmdLineArg(
+            Application::RUNLOOP_BACKEND_FLAG,
+            true,
+            "Operating system service run loops wait on=(epoll|io_uring)"
+        )
+    );
+    this->addCmdLineArgDef(
+        CmdLineArg(
+            Application::LOOP_GROUP_CPUS_FLAG,
+            true,
+            "CPUs loop group threads are pinned to, one per thread=(e.g. 2,3,8-11)"
+        )
+    );
+    this->addCmdLineArgDef(
+        CmdLineArg(
+            Application::RT_PROFILE_FLAG,
+            true,
+            "Real-time settings, colon separated=(mlock, heap=SIZE, "
+            "fifo=PRIO, rr=PRIO, other, cpus=LIST, stack=SIZE)"
+        )
+    );
+    this->addCmdLineArgDef(
+        CmdLineArg(
+            Application::LOG_ASYNC_FLAG,
+            true,
+            "Write log messages from a background thread; when a thread's buffer is full=(drop|block)"
+        )
+    );
+    this->addCmdLineArgDef(
+        CmdLineArg(
+            Application::BINARY_LOG_FLAG,
+            true,
+            "Ring file RF_CK_APP_BLOG() records go to=(PATH[:SIZE])"
+        )
+    );
 
     /*
      * If a delegate was submitted for this Application instance to host (it is
@@ -239,6 +489,13 @@ Application::~Application()
     );
     m_argDefs.clear();
 
+    /*
+     * Stop and join the loop group threads before the rest, since input
+     * sources they service may belong to the other threads.
+     */
+    destroy(m_loopGroup);
+    m_loopGroup = nullptr;
+
     /*
      * Join (if applicable) and delete all subordinate threads.
      */
@@ -258,12 +515,18 @@ Application::~Application()
     /*
      * Close the scheduler synchronization object, if one was used.
      */
-    if (m_schedSyncObj != nullptr)
+    if (m_frameSync != nullptr)
     {
-        sem_close(m_schedSyncObj);
-        m_schedSyncObj = nullptr;
+        delete m_frameSync;
+        m_frameSync = nullptr;
     }
 
+    /*
+     * No thread is left to write to the binary log.
+     */
+    delete m_binaryLog;
+    m_binaryLog = nullptr;
+
     destroy(m_log);
     m_log = nullptr;
 }
@@ -290,6 +553,10 @@ Application::signalReceived(int signalNumber)
         m_appThreads.end(),
         ptr_fun(&requestRunLoopTerm)
     );
+    if (m_loopGroup != nullptr)
+    {
+        m_loopGroup->stop();
+    }
     m_mainThread->runLoop()->terminate();
 }
 
@@ -302,9 +569,14 @@ Application::initialize(std::string appName, int argCount, char const** argVals)
     stringstream pidFileName;
     FILE *pidFile = nullptr;
     std::string schedSyncObj;
+    std::string schedSyncTypeName;
     std::string pidBaseName = appName;
     bool daemonMode = false;
     string logLevel = "DEBUG";
+    string runLoopBackend;
+    string rtProfileSpec;
+    string logAsyncPolicy;
+    string binaryLogSpec;
 
     if (m_mainThread != nullptr)
     {
@@ -442,6 +714,102 @@ Application::initialize(std::string appName, int argCount, char const** argVals)
         }
     }
 
+    /*
+     * The log writer thread is started ahead of the real-time profile, so it
+     * keeps regular scheduling instead of inheriting the main thread's.
+     */
+    if (!(logAsyncPolicy = this->getCmdLineArgFor(Application::LOG_ASYNC_FLAG)).empty())
+    {
+        if ("drop" == logAsyncPolicy)
+        {
+            m_log->startAsync(AppLog::OP_DROP_OLDEST);
+        }
+        else if ("block" == logAsyncPolicy)
+        {
+            m_log->startAsync(AppLog::OP_BLOCK);
+        }
+        else
+        {
+            cerr << "WARNING: Unknown log overflow policy \"" << logAsyncPolicy << "\"." << endl;
+        }
+    }
+
+    /*
+     * The binary log is created before any thread that may write to it. A
+     * trailing ":SIZE" sets the size of its ring.
+     */
+    if (!(binaryLogSpec = this->getCmdLineArgFor(Application::BINARY_LOG_FLAG)).empty())
+    {
+        string::size_type sizeSep = binaryLogSpec.rfind(':');
+        string binaryLogPath = binaryLogSpec;
+        size_t ringBytes = RF_CK_BLOG_DEFAULT_RING_SIZE;
+
+        if ((sizeSep != string::npos) && parseByteSize(binaryLogSpec.substr(sizeSep + 1u), ringBytes))
+        {
+            binaryLogPath = binaryLogSpec.substr(0u, sizeSep);
+        }
+        else
+        {
+            ringBytes = RF_CK_BLOG_DEFAULT_RING_SIZE;
+        }
+
+        try
+        {
+            m_binaryLog = new BinaryLog(binaryLogPath, ringBytes);
+            (*m_log) << AppLog::LL_INFO << "Binary log " << binaryLogPath << " holds the last "
+                << m_binaryLog->slotCount() << " records." << EndLog;
+        }
+        catch (std::exception& binaryLogError)
+        {
+            (*m_log) << AppLog::LL_WARNING << "Can not create binary log " << binaryLogPath << ": "
+                << binaryLogError.what() << EndLog;
+        }
+    }
+
+
+    /*
+     * The run loop backend applies to every run loop created from here on,
+     * including the one hosted by the main thread.
+     */
+    if (!(runLoopBackend = this->getCmdLineArgFor(Application::RUNLOOP_BACKEND_FLAG)).empty())
+    {
+        RunLoop::Configuration runLoopConfig = RunLoop::defaultConfiguration();
+
+        if ("epoll" == runLoopBackend)
+        {
+            runLoopConfig.backend = RunLoop::BK_EPOLL;
+            RunLoop::setDefaultConfiguration(runLoopConfig);
+        }
+        else if ("io_uring" == runLoopBackend)
+        {
+            runLoopConfig.backend = RunLoop::BK_IO_URING;
+            RunLoop::setDefaultConfiguration(runLoopConfig);
+        }
+        else
+        {
+            cerr << "WARNING: Unknown run loop backend \"" << runLoopBackend << "\"." << endl;
+        }
+    }
+
+    /*
+     * Real-time settings go in before the main thread and its run loop are
+     * created, so their memory is locked and prefaulted along with the rest.
+     */
+    if (!(rtProfileSpec = this->getCmdLineArgFor(Application::RT_PROFILE_FLAG)).empty())
+    {
+        RealTimeProfile rtProfile;
+
+        if (parseRealTimeProfile(rtProfileSpec, rtProfile))
+        {
+            this->applyRealTimeProfile(rtProfile);
+        }
+        else
+        {
+            cerr << "WARNING: Malformed real-time profile \"" << rtProfileSpec << "\"." << endl;
+        }
+    }
+
+
     /*
      * Create the Thread object that represents the main thread. The use of
      * this constructor instructs the Thread class to not spawn off a new
@@ -452,17 +820,29 @@ Application::initialize(std::string appName, int argCount, char const** argVals)
     schedSyncObj = this->getCmdLineArgFor(Application::SCHED_SYNC_FLAG);
     if (!schedSyncObj.empty())
     {
+        FrameSync::Type schedSyncType = FrameSync::FS_SEMAPHORE;
+
         /*
          * If the --sched-sync argument was provided, we will create the main
          * run loop so that it synchronizes with an externally maintained
-         * synchronization object.
+         * synchronization object. The --sched-sync-type argument picks the
+         * kind of object, a named semaphore being the default.
          */
-        m_schedSyncObj = sem_open(schedSyncObj.c_str(), O_CREAT, S_IRUSR | S_IWUSR, 0);
-        if (SEM_FAILED == m_schedSyncObj)
+        schedSyncTypeName = this->getCmdLineArgFor(Application::SCHED_SYNC_TYPE_FLAG);
+        if ("eventfd" == schedSyncTypeName)
+        {
+            schedSyncType = FrameSync::FS_EVENTFD;
+        }
+        else if ("futex" == schedSyncTypeName)
         {
-            throw OsErrorException("sem_open", errno);
+            schedSyncType = FrameSync::FS_FUTEX;
         }
-        m_mainThread = construct(Thread::myType(), pthread_self(), m_schedSyncObj);
+        else if (!schedSyncTypeName.empty() && ("sem" != schedSyncTypeName))
+        {
+            cerr << "WARNING: Unknown scheduler synchronization object type \"" << schedSyncTypeName << "\"." << endl;
+        }
+        m_frameSync = FrameSync::open(schedSyncType, schedSyncObj);
+        m_mainThread = construct(Thread::myType(), pthread_self(), m_frameSync);
     }
     else
     {
@@ -513,11 +893,135 @@ Application::spawnThread(ThreadDelegate* thrDelegate, bool detached)
      * instance provided as input. Remember this new Thread object in our
      * Application instance for future clean-up.
      */
-    newThread = construct(Thread::myType(), thrDelegate, this, detached);
+    if (m_realTimeProfile.threads.isDefault())
+    {
+        newThread = construct(Thread::myType(), thrDelegate, this, detached);
+    }
+    else
+    {
+        newThread = construct(Thread::myType(), thrDelegate, this, m_realTimeProfile.threads, detached);
+    }
     m_appThreads.push_back(newThread);
 }
 
 
+void
+Application::spawnThread(ThreadDelegate* thrDelegate, ThreadAttributes const& attributes, bool detached)
+{
+    Thread *newThread = nullptr;
+
+    if (nullptr == m_mainThread)
+    {
+        throw PreconditionNotMetException("Application already initialized.");
+    }
+
+    newThread = construct(Thread::myType(), thrDelegate, this, attributes, detached);
+    m_appThreads.push_back(newThread);
+}
+
+
+void
+Application::applyRealTimeProfile(RealTimeProfile const& profile)
+{
+    m_realTimeProfile = profile;
+
+    /*
+     * MCL_FUTURE also covers the stacks of threads started later, and any
+     * heap grown from here on.
+     */
+    if (profile.lockMemory && (mlockall(MCL_CURRENT | MCL_FUTURE) != 0))
+    {
+        int lockError = errno;
+
+        (*m_log) << AppLog::LL_WARNING << "Can not lock the process memory: ";
+        if ((EPERM == lockError) || (ENOMEM == lockError))
+        {
+            (*m_log) << "the process lacks the privilege (it needs CAP_IPC_LOCK, or an RLIMIT_MEMLOCK "
+                << "as large as the process)";
+        }
+        else
+        {
+            (*m_log) << strerror(lockError);
+        }
+        (*m_log) << "; its pages may be swapped out." << EndLog;
+        m_realTimeProfile.lockMemory = false;
+    }
+
+    /*
+     * Keep freed memory in the heap, and keep large blocks out of mmap(),
+     * so the pages touched here are the ones later allocations get.
+     */
+    if (profile.heapPrefault > 0u)
+    {
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        volatile unsigned char *heapArea = nullptr;
+
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+        heapArea = static_cast<volatile unsigned char*>(malloc(profile.heapPrefault));
+        if (heapArea != nullptr)
+        {
+            for (size_t offset = 0u; offset < profile.heapPrefault; offset += pageSize)
+            {
+                heapArea[offset] = 0u;
+            }
+            free(const_cast<unsigned char*>(heapArea));
+        }
+        else
+        {
+            (*m_log) << AppLog::LL_WARNING << "Can not prefault " << profile.heapPrefault
+                << " bytes of heap: " << strerror(ENOMEM) << "." << EndLog;
+            m_realTimeProfile.heapPrefault = 0u;
+        }
+    }
+
+    m_realTimeProfile.mainThread.applyToCurrentThread("main thread");
+
+    (*m_log) << AppLog::LL_INFO << "Real-time profile: memory "
+        << (m_realTimeProfile.lockMemory ? "locked" : "not locked") << ", "
+        << (m_realTimeProfile.heapPrefault / 1024u) << " KiB of heap prefaulted; main thread "
+        << m_realTimeProfile.mainThread.describe() << "; subordinate threads "
+        << m_realTimeProfile.threads.describe() << "." << EndLog;
+}
+
+
+
+LoopGroup*
+Application::startLoopGroup(unsigned shardCount, vector<cpu_set_t> const& affinities)
+{
+    vector<cpu_set_t> flagAffinities;
+    string cpuList;
+
+    if (nullptr == m_mainThread)
+    {
+        throw PreconditionNotMetException("Application not initialized.");
+    }
+
+    if (m_loopGroup != nullptr)
+    {
+        throw PreconditionNotMetException("Can not start a second loop group.");
+    }
+
+    if (affinities.empty() && !(cpuList = this->getCmdLineArgFor(Application::LOOP_GROUP_CPUS_FLAG)).empty())
+    {
+        if (!parseCpuList(cpuList, flagAffinities))
+        {
+            cerr << "WARNING: Malformed loop group CPU list \"" << cpuList << "\"." << endl;
+            flagAffinities.clear();
+        }
+    }
+
+    m_loopGroup = construct(
+        LoopGroup::myType(),
+        this,
+        shardCount,
+        affinities.empty() ? flagAffinities : affinities
+    );
+
+    return m_loopGroup;
+}
+
+
 void
 Application::start()
 {
@@ -743,16 +1247,44 @@ Application::getCurrentRunLoop() const
         {
             result = (*currentThrObjIter)->runLoop();
         }
+        else if (m_loopGroup != nullptr)
+        {
+            result = m_loopGroup->currentRunLoop();
+        }
     }
 
     return result;
 }
 
 
+FrameScheduler*
+Application::frameScheduler() const
+{
+    SynchronizedRunLoop *mainRunLoop = nullptr;
+
+    if (nullptr == m_mainThread)
+    {
+        throw PreconditionNotMetException("Application not initialized.");
+    }
+
+    mainRunLoop = dynamic_cast<SynchronizedRunLoop*>(m_mainThread->runLoop());
+
+    return (mainRunLoop != nullptr) ? &mainRunLoop->frameScheduler() : nullptr;
+}
+
+
 AppLog&
 Application::log()
 {
     return *m_log;
 }
 
+
+BinaryLog*
+Application::binaryLog() const
+{
+    return m_binaryLog;
+}
+
+
 // vim: set ts=4 sw=4 expandtab:
@@ -19,6 +19,10 @@
 #include <CoreKit/ThreadDelegate.h>
 #include <CoreKit/InterruptListener.h>
 #include <CoreKit/AppLog.h>
+#include <CoreKit/BinaryLog.h>
+#include <CoreKit/FrameScheduler.h>
+#include <CoreKit/FrameSync.h>
+#include <CoreKit/LoopGroup.h>
 
 namespace CoreKit
 {
@@ -159,6 +163,52 @@ namespace CoreKit
             std::string formatHelpStr() const;
         };
 
+        /**
+         * \brief Process Wide Real-Time Settings
+         *
+         * The \c Application::RealTimeProfile structure gathers the settings
+         * that keep a control loop from taking page faults or being
+         * preempted: locking the process memory, faulting in the heap ahead
+         * of time, and the real-time attributes of the main and subordinate
+         * threads. See \c applyRealTimeProfile() and the \c --rt-profile
+         * command line flag.
+         */
+        struct RealTimeProfile
+        {
+            /**
+             * \brief Lock All Current and Future Process Memory (\c mlockall())
+             *
+             * The stacks of threads started later are locked too, so unless
+             * the process holds \c CAP_IPC_LOCK they have to fit within
+             * \c RLIMIT_MEMLOCK; \c ThreadAttributes::stackSize keeps them
+             * small.
+             */
+
+            bool lockMemory;
+            /**
+             * \brief Bytes of Heap Faulted In Ahead of Time
+             *
+             * The memory is allocated, touched and released, and the
+             * allocator told to keep it rather than give it back to the
+             * system. Only the heap of the main allocator arena is
+             * prefaulted.
+             */
+            size_t heapPrefault;
+            /**
+             * \brief Attributes Applied to the Main \c Thread
+             */
+            ThreadAttributes mainThread;
+            /**
+             * \brief Attributes Given to Threads Started by \c spawnThread()
+             *
+             * Used when \c spawnThread() is not handed attributes of its own.
+             */
+            ThreadAttributes threads;
+
+            RealTimeProfile();
+        };
+
+
         /**
          * \brief Initialize the \c Application Instance with an \c AppDelegate
          *
@@ -246,6 +296,83 @@ namespace CoreKit
             bool detached = true
         );
 
+        /**
+         * \brief Start a Subordinate \c Thread with Real-Time Settings
+         *
+         * Behaves like \c spawnThread(ThreadDelegate*,bool), but starts the
+         * thread with the scheduling policy, priority, CPU affinity and
+         * stack settings given instead of those of the real-time profile.
+         *
+         * \param thrDelegate Pointer to the \ref ThreadDelegate that contains
+         *                    the \ref Thread specific behavior.
+         * \param attributes Real-time settings for the new thread.
+         * \param detached \c true if the thread should be created as
+         *                 \e detached; \c false otherwise.
+         */
+        virtual void spawnThread(
+            ThreadDelegate* thrDelegate,
+            ThreadAttributes const& attributes,
+            bool detached = true
+        );
+
+        /**
+         * \brief Apply Process Wide Real-Time Settings
+         *
+         * The \c applyRealTimeProfile() method locks the process memory,
+         * prefaults the heap and applies the main \c Thread attributes, as
+         * the profile asks, and keeps the subordinate thread attributes for
+         * later \c spawnThread() calls. What took effect is written to the
+         * application log; settings the process lacks the privileges for
+         * are skipped with a warning that names the capability or resource
+         * limit needed. \par
+         *
+         * \c initialize() calls this method with the settings given by the
+         * \c --rt-profile command line flag, if any.
+         *
+         * \param profile Settings to apply.
+         */
+        void applyRealTimeProfile(RealTimeProfile const& profile);
+
+        /**
+         * \brief Access the Real-Time Settings in Effect
+         *
+         * \return Settings applied by \c applyRealTimeProfile(), minus those
+         *         the process was not allowed to use.
+         */
+        inline RealTimeProfile const& realTimeProfile() const { return m_realTimeProfile; }
+
+
+        /**
+         * \brief Start a Group of Worker Threads that Share Input Sources
+         *
+         * The \c startLoopGroup() method starts \c shardCount subordinate
+         * threads, each hosting its own \c RunLoop, and returns the
+         * \c LoopGroup used to spread input sources across them. The group
+         * is stopped along with the main \c Thread and destroyed with this
+         * \c Application instance.\par
+         *
+         * When no affinities are given, the threads are pinned to the CPUs
+         * listed with the \c --loop-group-cpus command line flag, one CPU
+         * per thread, if it was provided.
+         *
+         * \param shardCount Number of worker threads to start.
+         * \param affinities CPU affinity of each worker thread; see
+         *                   \c LoopGroup::LoopGroup().
+         *
+         * \return The new \c LoopGroup instance.
+         */
+        LoopGroup* startLoopGroup(
+            unsigned shardCount,
+            std::vector<cpu_set_t> const& affinities = std::vector<cpu_set_t>()
+        );
+
+        /**
+         * \brief Access the Worker Thread Group Started by \c startLoopGroup()
+         *
+         * \return The \c LoopGroup instance; \c NULL if none was started.
+         */
+        inline LoopGroup* loopGroup() const { return m_loopGroup; }
+
         /**
          * \brief Start Execution of the Main \c RunLoop
          *
@@ -316,7 +443,8 @@ namespace CoreKit
          * from a subordinate thread yields the \c RunLoop associated with the
          * \c Thread object representing the calling thread, if any (i.e.,
          * calling this method from a thread not created via the spawnThread()
-         * method yields \c NULL as a result).
+         * or startLoopGroup() methods yields \c NULL as a result).
+
          *
          * \return Pointer to the \c RunLoop instance associated with the
          *         calling thread; \c NULL if no \c RunLoop is associated with
@@ -324,6 +452,19 @@ namespace CoreKit
          */
         virtual RunLoop* getCurrentRunLoop() const;
 
+        /**
+         * \brief Access the Frame Scheduler of the Main \c RunLoop
+         *
+         * The \c frameScheduler() method gives access to the rate groups run
+         * every frame when the application is paced by an external scheduler
+         * (i.e., when started with the \c --sched-sync command line flag).
+         *
+         * \return Frame scheduler of the main \c Thread \c RunLoop; \c NULL
+         *         if the application is not paced by an external scheduler.
+         */
+        FrameScheduler* frameScheduler() const;
+
+
         /**
          * \brief Access the \c AppLog Object Associated with this \c Application
          *
@@ -343,6 +484,16 @@ namespace CoreKit
          */
         AppLog& log();
 
+        /**
+         * \brief Access the Binary Log Requested at the Command Line
+         *
+         * Created by \c initialize() when the \c --binary-log command line
+         * flag is given; see \c RF_CK_APP_BLOG().
+         *
+         * \return Binary log; \c nullptr if none was requested.
+         */
+        BinaryLog* binaryLog() const;
+
     private:
         /**
          * \brief Parse Through All Application Command Line Arguments
@@ -365,9 +516,17 @@ namespace CoreKit
         void processCmdLine(int argCount, char const** argVals);
 
         static const std::string SCHED_SYNC_FLAG;
+        static const std::string SCHED_SYNC_TYPE_FLAG;
         static const std::string GDB_FLAG;
         static const std::string DAEMON_FLAG;
         static const std::string PID_BASE_NAME_FLAG;
+        static const std::string RUNLOOP_BACKEND_FLAG;
+        static const std::string LOOP_GROUP_CPUS_FLAG;
+        static const std::string RT_PROFILE_FLAG;
+        static const std::string LOG_ASYNC_FLAG;
+        static const std::string BINARY_LOG_FLAG;
+
+
 
         typedef std::map< std::string, std::string > ArgValMap;
         /**
@@ -386,6 +545,11 @@ namespace CoreKit
          * \brief Main \c Thread for this \c Application Instance
          */
         Thread* m_mainThread;
+        /**
+         * \brief Worker Threads Started via \c startLoopGroup()
+         */
+        LoopGroup *m_loopGroup;
+
         /**
          * \brief Map of Command Line Flag Arguments as Parsed
          */
@@ -401,13 +565,22 @@ namespace CoreKit
         /**
          * \brief Synchronization Object Used to Tie Into an External Scheduler.
          */
-        sem_t *m_schedSyncObj;
+        FrameSync *m_frameSync;
+        /**
+         * \brief Binary Log Created per the \c --binary-log Command Line Flag
+         */
+        BinaryLog *m_binaryLog;
         /**
          * \brief Flag Used to Bypass Application Startup.
          * This flag is used exclusively by the command-line parser to indicate
          * the user invoked the application just to obtain help information.
          */
         bool m_inhibitStartup;
+        /**
+         * \brief Real-Time Settings Applied via \c applyRealTimeProfile()
+         */
+        RealTimeProfile m_realTimeProfile;
+
     };
 
     /**
@@ -416,6 +589,60 @@ namespace CoreKit
     extern Application *G_MyApp;
 } // end namespace CoreKit
 
+/**
+ * \brief Start a Message in the Application Log, if there is One, Only if its
+ *        Severity Level is Published
+ *
+ * Shorthand for \c RF_CK_LOG() on <tt>CoreKit::G_MyApp->log()</tt> that also
+ * checks \c G_MyApp is set, as in
+ * <tt>RF_CK_APP_LOG(LL_DEBUG) << "Client connected" << EndLog;</tt>.
+ *
+ * \param logLevel Severity level, without the \c AppLog:: prefix.
+ */
+#define RF_CK_APP_LOG(logLevel) \
+    if (!((CoreKit::AppLog::logLevel >= RF_CK_LOG_COMPILED_LEVEL) && (CoreKit::G_MyApp != nullptr) && \
+          CoreKit::G_MyApp->log().isEnabled(CoreKit::AppLog::logLevel))) \
+    {} \
+    else \
+        CoreKit::G_MyApp->log() << CoreKit::AppLog::logLevel
+
+/**
+ * \brief Start a Message in the Application Log, if there is One, from a
+ *        Rate-Limited, Deduplicated Call Site
+ *
+ * Shorthand for \c RF_CK_LOG_LIMITED() on <tt>CoreKit::G_MyApp->log()</tt>
+ * that also checks \c G_MyApp is set.
+ *
+ * \param logLevel Severity level, without the \c AppLog:: prefix.
+ * \param maxCount Messages published per interval.
+ * \param intervalSecs Length of the interval, in seconds.
+ */
+#define RF_CK_APP_LOG_LIMITED(logLevel, maxCount, intervalSecs) \
+    if (CoreKit::G_MyApp == nullptr) \
+    {} \
+    else \
+        RF_CK_LOG_LIMITED(CoreKit::G_MyApp->log(), logLevel, maxCount, intervalSecs)
+
+
+/**
+ * \brief Record an Event in the Application's Binary Log, if there is One
+ *
+ * Same as \c RF_CK_BLOG() on <tt>*CoreKit::G_MyApp->binaryLog()</tt>; does
+ * nothing unless the application was started with \c --binary-log.
+ *
+ * \param formatStr String literal with the \c printf() like format.
+ */
+#define RF_CK_APP_BLOG(formatStr, ...) \
+    do \
+    { \
+        if ((CoreKit::G_MyApp != nullptr) && (CoreKit::G_MyApp->binaryLog() != nullptr)) \
+        { \
+            RF_CK_BLOG(*CoreKit::G_MyApp->binaryLog(), formatStr, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+
+
 #endif // !defined(EA_9A8D031A_97B7_4f9d_A36D_E3106FDFEF9E__INCLUDED_)
 
 // vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,177 @@
+/**
+ * \file BinaryLog.cpp
+ * \brief Contains the implementation of the \c BinaryLog class.
+ * \date 2026-10-16 21:05:37
+ * \author Rolando J. Nieves
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+
+#include <CoreKit/Application.h>
+#include <CoreKit/BlockGuard.h>
+#include <CoreKit/OsErrorException.h>
+#include <CoreKit/PreconditionNotMetException.h>
+
+#include "BinaryLog.h"
+
+/**
+ * \brief Round a byte count up to a multiple of eight.
+ */
+#define RF_CK_BLOG_ALIGN8(byteCount) (((byteCount) + 7u) & ~static_cast<size_t>(7u))
+
+
+namespace CoreKit
+{
+
+static std::atomic< uint32_t > s_lastDescriptorId(0u);
+
+
+BinaryLog::Descriptor::Descriptor(char const *formatStr, char const *fileName, unsigned lineNumber):
+    m_id(++s_lastDescriptorId),
+    m_format(formatStr),
+    m_fileName(fileName),
+    m_lineNumber(lineNumber)
+{
+    if ((RF_CK_BLOG_MAX_DESCRIPTORS == m_id) && (G_MyApp != nullptr))
+    {
+        G_MyApp->log() << AppLog::LL_WARNING << "More than " << (RF_CK_BLOG_MAX_DESCRIPTORS - 1u)
+            << " binary log call sites; the format of those past " << fileName << ":" << lineNumber
+            << " is not recorded." << EndLog;
+    }
+}
+
+
+BinaryLog::BinaryLog(std::string const& filePath, size_t ringBytes, size_t slotSize):
+    m_filePath(filePath),
+    m_mapping(nullptr),
+    m_mappingSize(0u),
+    m_header(nullptr),
+    m_descriptorArea(nullptr),
+    m_slots(nullptr),
+    m_slotSize(RF_CK_BLOG_ALIGN8(slotSize)),
+    m_slotCount(0u),
+    m_registered(new std::atomic< bool >[RF_CK_BLOG_MAX_DESCRIPTORS]),
+    m_descriptorsLost(false)
+{
+    int fileFd = -1;
+    void *mapping = MAP_FAILED;
+
+    if (m_slotSize < (sizeof(BinaryLogRecord) + 9u))
+    {
+        throw PreconditionNotMetException("Binary log slots large enough for one argument.");
+    }
+    m_slotCount = ringBytes / m_slotSize;
+    if (m_slotCount < 2u)
+    {
+        throw PreconditionNotMetException("Binary log ring large enough for two records.");
+    }
+    m_mappingSize = RF_CK_BLOG_HEADER_SIZE + RF_CK_BLOG_DESCRIPTOR_AREA_SIZE + (m_slotCount * m_slotSize);
+
+    fileFd = open(m_filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (-1 == fileFd)
+    {
+        throw OsErrorException("open()", errno);
+    }
+    if (ftruncate(fileFd, static_cast< off_t >(m_mappingSize)) < 0)
+    {
+        int savedErrno = errno;
+
+        close(fileFd);
+        throw OsErrorException("ftruncate()", savedErrno);
+    }
+
+    /*
+     * Populated up front, so the first trip around the ring does not take
+     * a page fault per page.
+     */
+    mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fileFd, 0);
+    if (MAP_FAILED == mapping)
+    {
+        int savedErrno = errno;
+
+        close(fileFd);
+        throw OsErrorException("mmap()", savedErrno);
+    }
+    close(fileFd);
+
+    m_mapping = static_cast< unsigned char* >(mapping);
+    m_header = reinterpret_cast< BinaryLogFileHeader* >(m_mapping);
+    m_descriptorArea = m_mapping + RF_CK_BLOG_HEADER_SIZE;
+    m_slots = m_descriptorArea + RF_CK_BLOG_DESCRIPTOR_AREA_SIZE;
+
+    memcpy(m_header->magic, RF_CK_BLOG_MAGIC, sizeof(m_header->magic));
+    m_header->version = RF_CK_BLOG_VERSION;
+    m_header->headerSize = RF_CK_BLOG_HEADER_SIZE;
+    m_header->slotSize = static_cast< uint32_t >(m_slotSize);
+    m_header->reserved = 0u;
+    m_header->slotCount = m_slotCount;
+    m_header->descriptorAreaSize = RF_CK_BLOG_DESCRIPTOR_AREA_SIZE;
+    m_header->descriptorBytes.store(0u, std::memory_order_relaxed);
+    m_header->nextSequence.store(0u, std::memory_order_release);
+
+    for (unsigned descIdx = 0u; descIdx < RF_CK_BLOG_MAX_DESCRIPTORS; ++descIdx)
+    {
+        m_registered[descIdx].store(false, std::memory_order_relaxed);
+    }
+    pthread_mutex_init(&m_registerMutex, nullptr);
+}
+
+
+BinaryLog::~BinaryLog()
+{
+    pthread_mutex_destroy(&m_registerMutex);
+    if (m_mapping != nullptr)
+    {
+        munmap(m_mapping, m_mappingSize);
+        m_mapping = nullptr;
+    }
+}
+
+
+void
+BinaryLog::registerDescriptor(Descriptor const& descriptor)
+{
+    BlockGuard registerGuard(&m_registerMutex);
+    size_t fileLength = strlen(descriptor.fileName());
+    size_t formatLength = strlen(descriptor.format());
+    size_t usedBytes = m_header->descriptorBytes.load(std::memory_order_relaxed);
+    size_t entryBytes = RF_CK_BLOG_ALIGN8(sizeof(BinaryLogDescriptorEntry) + fileLength + formatLength);
+    BinaryLogDescriptorEntry *entry = nullptr;
+
+    if (m_registered[descriptor.id()].load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    if ((usedBytes + entryBytes) <= RF_CK_BLOG_DESCRIPTOR_AREA_SIZE)
+    {
+        entry = reinterpret_cast< BinaryLogDescriptorEntry* >(m_descriptorArea + usedBytes);
+        entry->id = descriptor.id();
+        entry->line = descriptor.lineNumber();
+        entry->fileLength = static_cast< uint32_t >(fileLength);
+        entry->formatLength = static_cast< uint32_t >(formatLength);
+        memcpy(entry + 1, descriptor.fileName(), fileLength);
+        memcpy(reinterpret_cast< char* >(entry + 1) + fileLength, descriptor.format(), formatLength);
+        m_header->descriptorBytes.store(usedBytes + entryBytes, std::memory_order_release);
+    }
+    else if (!m_descriptorsLost)
+    {
+        m_descriptorsLost = true;
+        if (G_MyApp != nullptr)
+        {
+            G_MyApp->log() << AppLog::LL_WARNING << "The descriptor area of binary log " << m_filePath
+                << " is full; the format of " << descriptor.fileName() << ":" << descriptor.lineNumber()
+                << " and of later call sites is not recorded." << EndLog;
+        }
+    }
+
+    // Either way, do not come back for this call site.
+    m_registered[descriptor.id()].store(true, std::memory_order_release);
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
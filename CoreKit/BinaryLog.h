@@ -0,0 +1,416 @@
+/**
+ * \file BinaryLog.h
+ * \brief Contains the definition of the \c BinaryLog class.
+ * \date 2026-10-16 21:05:37
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_BINARYLOG_H_
+#define _FOUNDATION_COREKIT_BINARYLOG_H_
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+/**
+ * \brief Identifies a binary log file; the terminating NUL is part of it.
+ */
+#define RF_CK_BLOG_MAGIC "RFBLOG1"
+/**
+ * \brief Binary log file layout version.
+ */
+#define RF_CK_BLOG_VERSION (1u)
+/**
+ * \brief Bytes set aside for the file header.
+ */
+#define RF_CK_BLOG_HEADER_SIZE (4096u)
+/**
+ * \brief Bytes set aside for the format descriptors of the call sites.
+ */
+#define RF_CK_BLOG_DESCRIPTOR_AREA_SIZE (256u * 1024u)
+/**
+ * \brief Most call sites a process may register.
+ */
+#define RF_CK_BLOG_MAX_DESCRIPTORS (4096u)
+/**
+ * \brief Default size of the record ring, in bytes.
+ */
+#define RF_CK_BLOG_DEFAULT_RING_SIZE (16u * 1024u * 1024u)
+/**
+ * \brief Default size of each record, header included, in bytes.
+ */
+#define RF_CK_BLOG_DEFAULT_SLOT_SIZE (64u)
+/**
+ * \brief Record flag set when some arguments did not fit.
+ */
+#define RF_CK_BLOG_TRUNCATED (0x0001u)
+
+/**
+ * \brief Argument type tags, one byte ahead of each argument in a record.
+ */
+#define RF_CK_BLOG_ARG_SIGNED ('i')
+#define RF_CK_BLOG_ARG_UNSIGNED ('u')
+#define RF_CK_BLOG_ARG_DOUBLE ('f')
+#define RF_CK_BLOG_ARG_STRING ('s')
+#define RF_CK_BLOG_ARG_POINTER ('p')
+
+/**
+ * \brief Record an event in a binary log.
+ *
+ * The format string and the call site are registered once, the first time
+ * the statement runs; after that the statement only stores a time stamp,
+ * the call site's identifier and the raw argument values, as in
+ * <tt>RF_CK_BLOG(myBinLog, "Packet %u from port %u", seqNum, port);</tt>.
+ * The format string follows \c printf() conventions and is applied by the
+ * \c BinaryLogDecoder tool when the file is read.
+ *
+ * \param theLog \c BinaryLog instance to write to.
+ * \param formatStr String literal with the \c printf() like format.
+ */
+#define RF_CK_BLOG(theLog, formatStr, ...) \
+    do \
+    { \
+        static const CoreKit::BinaryLog::Descriptor rfCkBlogDescriptor(formatStr, __FILE__, __LINE__); \
+        (theLog).write(rfCkBlogDescriptor, ##__VA_ARGS__); \
+    } while (0)
+
+namespace CoreKit
+{
+
+/**
+ * \brief Layout of the header at the start of a binary log file.
+ */
+struct BinaryLogFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t slotSize;
+    uint32_t reserved;
+    uint64_t slotCount;
+    uint64_t descriptorAreaSize;
+    /**
+     * \brief Bytes of the descriptor area in use.
+     */
+    std::atomic< uint64_t > descriptorBytes;
+    /**
+     * \brief Sequence number the next record gets; records are numbered
+     *        from zero.
+     */
+    std::atomic< uint64_t > nextSequence;
+};
+
+
+/**
+ * \brief Layout of a call site entry in the descriptor area.
+ *
+ * Followed by \c fileLength bytes of source file name, \c formatLength bytes
+ * of format string, and padding up to a multiple of eight bytes.
+ */
+struct BinaryLogDescriptorEntry
+{
+    uint32_t id;
+    uint32_t line;
+    uint32_t fileLength;
+    uint32_t formatLength;
+};
+
+
+/**
+ * \brief Layout of the header of each record in the ring.
+ *
+ * Followed by \c argBytes bytes of arguments, each one a type tag
+ * (\c RF_CK_BLOG_ARG_*) and the value: eight bytes for numbers and pointers,
+ * or a length byte and that many characters for strings.
+ */
+struct BinaryLogRecord
+{
+    /**
+     * \brief One past the record's sequence number once it is complete;
+     *        zero while it is being written, or if it never was.
+     */
+    std::atomic< uint64_t > sequence;
+    /**
+     * \brief \c CLOCK_REALTIME time stamp, in nanoseconds.
+     */
+    uint64_t timestamp;
+    uint32_t descriptorId;
+    uint16_t argBytes;
+    uint16_t flags;
+};
+
+
+/**
+ * \brief Log of binary, structured records kept in a memory-mapped file.
+ *
+ * Turning values into text is what costs most when logging at high rates.
+ * A binary log skips it: each record holds a time stamp, the identifier of
+ * the call site that wrote it and the raw values of its arguments, and the
+ * \c BinaryLogDecoder tool renders the text later, from the format string
+ * each call site registers once (see \c RF_CK_BLOG()).\par
+ *
+ * Records go into a ring of fixed-size slots in a file mapped into memory,
+ * so the file never grows past its initial size, writing a record costs no
+ * system call, and whatever was written survives the process crashing.
+ * Once the ring is full the oldest records are overwritten. Any thread may
+ * write without taking a lock. The decoder skips a record that is
+ * overwritten while it reads the file. It can not tell, however, when a
+ * writer stalls for a whole trip around the ring and finishes its record
+ * while a newer one is written to the same slot: the slot then ends up
+ * marked complete with a mix of both records in it.
+ */
+class BinaryLog
+{
+public:
+    /**
+     * \brief Format and location of a call site that writes to binary logs.
+     *
+     * Normally a function local \c static created by \c RF_CK_BLOG(). Each
+     * descriptor gets a process-wide identifier when constructed.
+     */
+    class Descriptor
+    {
+    public:
+        /**
+         * \brief Main constructor.
+         *
+         * \param[in] formatStr - \c printf() like format of the records.
+         * \param[in] fileName - Source file of the call site.
+         * \param[in] lineNumber - Source line of the call site.
+         */
+        Descriptor(char const *formatStr, char const *fileName, unsigned lineNumber);
+
+        inline uint32_t id() const { return m_id; }
+        inline char const* format() const { return m_format; }
+        inline char const* fileName() const { return m_fileName; }
+        inline unsigned lineNumber() const { return m_lineNumber; }
+
+    private:
+        uint32_t m_id;
+        char const *m_format;
+        char const *m_fileName;
+        unsigned m_lineNumber;
+
+        Descriptor(Descriptor const& other);
+        Descriptor& operator=(Descriptor const& other);
+    };
+
+    /**
+     * \brief Create a binary log file and map it into memory.
+     *
+     * An existing file at \c filePath is replaced.
+     *
+     * \param[in] filePath - Location of the file.
+     * \param[in] ringBytes - Size of the record ring; the file is this big,
+     *            plus the header and descriptor area.
+     * \param[in] slotSize - Size of each record, header included. Arguments
+     *            that do not fit are left out of the record.
+     *
+     * \throw PreconditionNotMetException if the sizes leave no room for at
+     *        least two records with one argument each.
+     * \throw OsErrorException if the file can not be created or mapped.
+     */
+    BinaryLog(std::string const& filePath, size_t ringBytes = RF_CK_BLOG_DEFAULT_RING_SIZE,
+        size_t slotSize = RF_CK_BLOG_DEFAULT_SLOT_SIZE);
+
+    /**
+     * \brief Unmap the file, which stays behind for decoding.
+     */
+    ~BinaryLog();
+
+    /**
+     * \brief Write a record.
+     *
+     * Safe to call from any thread. Integer, enumeration, floating point,
+     * pointer, C string and \c std::string arguments are supported.
+     *
+     * \param[in] descriptor - Call site writing the record.
+     * \param[in] args - Values for the format's conversions.
+     */
+    template< typename... ArgTypes >
+    void write(Descriptor const& descriptor, ArgTypes const&... args)
+    {
+        BinaryLogRecord *slot = nullptr;
+        uint64_t sequence = 0u;
+        struct timespec now;
+
+        if (!this->isRegistered(descriptor))
+        {
+            this->registerDescriptor(descriptor);
+        }
+
+        clock_gettime(CLOCK_REALTIME, &now);
+        sequence = m_header->nextSequence.fetch_add(1u, std::memory_order_relaxed);
+        slot = reinterpret_cast< BinaryLogRecord* >(m_slots + ((sequence % m_slotCount) * m_slotSize));
+
+        /*
+         * The slot reads as empty until it is complete, so a decoder (or a
+         * crash) caught in the middle sees no half-written record.
+         */
+        slot->sequence.store(0u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        ArgEncoder encoder(reinterpret_cast< unsigned char* >(slot + 1), m_slotSize - sizeof(BinaryLogRecord));
+
+        slot->timestamp = (static_cast< uint64_t >(now.tv_sec) * 1000000000uLL) + static_cast< uint64_t >(now.tv_nsec);
+        slot->descriptorId = descriptor.id();
+        (encoder.put(args), ...);
+        slot->argBytes = static_cast< uint16_t >(encoder.used);
+        slot->flags = encoder.flags;
+        slot->sequence.store(sequence + 1u, std::memory_order_release);
+    }
+
+    /**
+     * \brief Access the location of the file.
+     */
+    inline std::string const& filePath() const { return m_filePath; }
+
+    /**
+     * \brief Access the number of records the ring holds.
+     */
+    inline size_t slotCount() const { return m_slotCount; }
+
+    /**
+     * \brief Count the records written so far, overwritten ones included.
+     */
+    inline uint64_t recordCount() const { return m_header->nextSequence.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * \brief Packs arguments into a record, dropping those that do not fit.
+     */
+    struct ArgEncoder
+    {
+        unsigned char *cursor;
+        size_t room;
+        size_t used;
+        uint16_t flags;
+
+        ArgEncoder(unsigned char *payload, size_t capacity):
+            cursor(payload),
+            room(capacity),
+            used(0u),
+            flags(0u)
+        {}
+
+        void putScalar(unsigned char tag, void const *value)
+        {
+            if (room < 9u)
+            {
+                flags |= RF_CK_BLOG_TRUNCATED;
+                room = 0u;
+                return;
+            }
+            cursor[0] = tag;
+            memcpy(cursor + 1, value, 8u);
+            cursor += 9u;
+            room -= 9u;
+            used += 9u;
+        }
+
+        void putString(char const *text, size_t length)
+        {
+            if (room < 2u)
+            {
+                flags |= RF_CK_BLOG_TRUNCATED;
+                room = 0u;
+                return;
+            }
+            if ((length > 255u) || (length > (room - 2u)))
+            {
+                flags |= RF_CK_BLOG_TRUNCATED;
+                length = ((room - 2u) < 255u) ? (room - 2u) : 255u;
+            }
+            cursor[0] = RF_CK_BLOG_ARG_STRING;
+            cursor[1] = static_cast< unsigned char >(length);
+            memcpy(cursor + 2, text, length);
+            cursor += 2u + length;
+            room -= 2u + length;
+            used += 2u + length;
+        }
+
+        template< typename ArgType >
+        void put(ArgType const& value)
+        {
+            typedef typename std::decay< ArgType >::type ValueType;
+
+            if constexpr (std::is_same< ValueType, char const* >::value || std::is_same< ValueType, char* >::value)
+            {
+                char const *text = value;
+
+                this->putString((text != nullptr) ? text : "(null)", (text != nullptr) ? strlen(text) : 6u);
+            }
+            else if constexpr (std::is_same< ValueType, std::string >::value)
+            {
+                this->putString(value.data(), value.size());
+            }
+            else if constexpr (std::is_floating_point< ValueType >::value)
+            {
+                double numValue = static_cast< double >(value);
+
+                this->putScalar(RF_CK_BLOG_ARG_DOUBLE, &numValue);
+            }
+            else if constexpr (std::is_enum< ValueType >::value)
+            {
+                this->put(static_cast< typename std::underlying_type< ValueType >::type >(value));
+            }
+            else if constexpr (std::is_integral< ValueType >::value && std::is_signed< ValueType >::value)
+            {
+                int64_t numValue = static_cast< int64_t >(value);
+
+                this->putScalar(RF_CK_BLOG_ARG_SIGNED, &numValue);
+            }
+            else if constexpr (std::is_integral< ValueType >::value)
+            {
+                uint64_t numValue = static_cast< uint64_t >(value);
+
+                this->putScalar(RF_CK_BLOG_ARG_UNSIGNED, &numValue);
+            }
+            else if constexpr (std::is_pointer< ValueType >::value)
+            {
+                uint64_t ptrValue = static_cast< uint64_t >(reinterpret_cast< uintptr_t >(value));
+
+                this->putScalar(RF_CK_BLOG_ARG_POINTER, &ptrValue);
+            }
+            else
+            {
+                static_assert(!std::is_same< ValueType, ValueType >::value, "Type not supported by BinaryLog");
+            }
+        }
+    };
+
+    std::string m_filePath;
+    unsigned char *m_mapping;
+    size_t m_mappingSize;
+    BinaryLogFileHeader *m_header;
+    unsigned char *m_descriptorArea;
+    unsigned char *m_slots;
+    size_t m_slotSize;
+    size_t m_slotCount;
+    std::unique_ptr< std::atomic< bool >[] > m_registered;
+    pthread_mutex_t m_registerMutex;
+    bool m_descriptorsLost;
+
+    inline bool isRegistered(Descriptor const& descriptor) const
+    {
+        return ((descriptor.id() >= RF_CK_BLOG_MAX_DESCRIPTORS) ||
+            m_registered[descriptor.id()].load(std::memory_order_acquire));
+    }
+
+    void registerDescriptor(Descriptor const& descriptor);
+
+    BinaryLog(BinaryLog const& other);
+    BinaryLog& operator=(BinaryLog const& other);
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_BINARYLOG_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,205 @@
+/**
+ * \file BoundedMpmcQueue.h
+ * \brief Contains the definition of the \c BoundedMpmcQueue class template.
+ * \date 2026-10-16 11:02:17
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_BOUNDEDMPMCQUEUE_H_
+#define _FOUNDATION_COREKIT_BOUNDEDMPMCQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * \brief Size assumed for a CPU cache line when padding shared counters.
+ */
+#define RF_CK_CACHE_LINE_SIZE (64u)
+
+namespace CoreKit
+{
+
+/**
+ * \brief Fixed capacity, lock-free, multi-producer/multi-consumer queue.
+ *
+ * This is the array based queue design by Dmitry Vyukov: each cell carries
+ * a sequence number that tells producers and consumers whether the cell is
+ * ready for them, so both sides only contend on a single atomic counter
+ * each. Neither \c tryPush() nor \c tryPop() ever blocks or allocates
+ * memory.
+ *
+ * \tparam T Element type; must be default constructible and move
+ *           assignable.
+ */
+template< typename T >
+class BoundedMpmcQueue
+{
+private:
+    struct Cell
+    {
+        std::atomic< size_t > sequence;
+        T value;
+    };
+
+    alignas(RF_CK_CACHE_LINE_SIZE) Cell *m_cells;
+    size_t m_mask;
+    alignas(RF_CK_CACHE_LINE_SIZE) std::atomic< size_t > m_enqueuePos;
+    alignas(RF_CK_CACHE_LINE_SIZE) std::atomic< size_t > m_dequeuePos;
+
+public:
+    /**
+     * \brief Main constructor.
+     *
+     * \param[in] capacity - Maximum number of elements the queue holds.
+     *            Rounded up to the next power of two.
+     */
+    explicit BoundedMpmcQueue(size_t capacity):
+        m_cells(nullptr),
+        m_mask(0u),
+        m_enqueuePos(0u),
+        m_dequeuePos(0u)
+    {
+        size_t actualCapacity = 2u;
+
+        while (actualCapacity < capacity)
+        {
+            actualCapacity <<= 1u;
+        }
+
+        m_cells = new Cell[actualCapacity];
+        m_mask = actualCapacity - 1u;
+        for (size_t cellIdx = 0u; cellIdx < actualCapacity; ++cellIdx)
+        {
+            m_cells[cellIdx].sequence.store(cellIdx, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpmcQueue(BoundedMpmcQueue const& other) = delete;
+    BoundedMpmcQueue(BoundedMpmcQueue&& other) = delete;
+
+    /**
+     * \brief Destructor.
+     */
+    ~BoundedMpmcQueue()
+    {
+        delete [] m_cells;
+        m_cells = nullptr;
+    }
+
+    /**
+     * \brief Access the maximum number of elements the queue holds.
+     *
+     * \return Queue capacity.
+     */
+    inline size_t capacity() const { return m_mask + 1u; }
+
+    /**
+     * \brief Approximate the number of elements in the queue.
+     *
+     * The value is only a snapshot when other threads are active.
+     *
+     * \return Number of queued elements.
+     */
+    inline size_t sizeApprox() const
+    {
+        size_t enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        return (enqueuePos > dequeuePos) ? (enqueuePos - dequeuePos) : 0u;
+    }
+
+    /**
+     * \brief Add an element to the tail of the queue, if there is room.
+     *
+     * \param[in] value - Element to move into the queue. Left untouched if
+     *            the queue is full.
+     *
+     * \return \c true if the element was queued; \c false if the queue is full.
+     */
+    bool tryPush(T&& value)
+    {
+        Cell *theCell = nullptr;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            theCell = &m_cells[pos & m_mask];
+            size_t seq = theCell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast< intptr_t >(seq) - static_cast< intptr_t >(pos);
+
+            if (0 == diff)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        theCell->value = std::move(value);
+        theCell->sequence.store(pos + 1u, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * \brief Remove the element at the head of the queue, if there is one.
+     *
+     * \param[out] value - Receives the element removed from the queue.
+     *
+     * \return \c true if an element was removed; \c false if the queue is empty.
+     */
+    bool tryPop(T& value)
+    {
+        Cell *theCell = nullptr;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            theCell = &m_cells[pos & m_mask];
+            size_t seq = theCell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast< intptr_t >(seq) - static_cast< intptr_t >(pos + 1u);
+
+            if (0 == diff)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(theCell->value);
+        theCell->value = T();
+        theCell->sequence.store(pos + m_mask + 1u, std::memory_order_release);
+
+        return true;
+    }
+
+    BoundedMpmcQueue& operator=(BoundedMpmcQueue const& other) = delete;
+    BoundedMpmcQueue& operator=(BoundedMpmcQueue&& other) = delete;
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_BOUNDEDMPMCQUEUE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
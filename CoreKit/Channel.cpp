@@ -0,0 +1,168 @@
+/**
+ * \file Channel.cpp
+ * \brief Contains the implementation of the \c ChannelBase class.
+ * \date 2026-10-16 20:12:48
+ * \author Rolando J. Nieves
+ */
+
+#include <cerrno>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <CoreKit/OsErrorException.h>
+
+#include "Channel.h"
+
+
+namespace CoreKit
+{
+
+ChannelBase::ReadySource::ReadySource():
+    eventFd(-1)
+{
+    eventFd = eventfd(0uLL, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (-1 == eventFd)
+    {
+        throw OsErrorException("eventfd()", errno);
+    }
+}
+
+
+ChannelBase::ReadySource::~ReadySource()
+{
+    if (eventFd != -1)
+    {
+        close(eventFd);
+        eventFd = -1;
+    }
+}
+
+
+int
+ChannelBase::ReadySource::fileDescriptor() const
+{
+    return eventFd;
+}
+
+
+InterruptListener*
+ChannelBase::ReadySource::interruptListener() const
+{
+    return nullptr;
+}
+
+
+void
+ChannelBase::ReadySource::fireCallback()
+{
+    eventfd_t readValue = 0uLL;
+
+    eventfd_read(eventFd, &readValue);
+    if (readyCallback)
+    {
+        readyCallback();
+    }
+}
+
+
+ChannelBase::ChannelBase():
+    m_eventFd(-1),
+    m_wakePending(false),
+    m_sendersWaiting(0u),
+    m_fullCount(0u)
+{
+    m_eventFd = eventfd(0uLL, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (-1 == m_eventFd)
+    {
+        throw OsErrorException("eventfd()", errno);
+    }
+}
+
+
+ChannelBase::~ChannelBase()
+{
+    if (m_eventFd != -1)
+    {
+        close(m_eventFd);
+        m_eventFd = -1;
+    }
+}
+
+
+int
+ChannelBase::fileDescriptor() const
+{
+    return m_eventFd;
+}
+
+
+InterruptListener*
+ChannelBase::interruptListener() const
+{
+    return nullptr;
+}
+
+
+void
+ChannelBase::wake()
+{
+    if (!m_wakePending.exchange(true, std::memory_order_seq_cst))
+    {
+        eventfd_write(m_eventFd, 1uLL);
+    }
+}
+
+
+void
+ChannelBase::beginDrain()
+{
+    eventfd_t readValue = 0uLL;
+
+    /*
+     * Same order as TaskQueue::fireCallback(): empty the eventfd() before
+     * clearing the flag, so a send that raises the flag again always leaves
+     * the eventfd() readable.
+     */
+    eventfd_read(m_eventFd, &readValue);
+    m_wakePending.store(false, std::memory_order_seq_cst);
+}
+
+
+void
+ChannelBase::senderBlocked()
+{
+    m_fullCount.fetch_add(1u, std::memory_order_relaxed);
+    m_sendersWaiting.fetch_add(1u, std::memory_order_seq_cst);
+}
+
+
+void
+ChannelBase::senderUnblocked()
+{
+    uint32_t waiting = m_sendersWaiting.load(std::memory_order_seq_cst);
+
+    m_fullCount.fetch_sub(1u, std::memory_order_relaxed);
+
+    /*
+     * Count waiting senders rather than flag them, so taking back this
+     * request leaves those of other senders alone. If the receiver already
+     * answered it, there is nothing left to take back.
+     */
+    while ((waiting > 0u) &&
+           !m_sendersWaiting.compare_exchange_weak(waiting, waiting - 1u, std::memory_order_seq_cst));
+}
+
+
+void
+ChannelBase::notifyReady()
+{
+    if ((m_sendersWaiting.load(std::memory_order_seq_cst) > 0u) &&
+        (m_sendersWaiting.exchange(0u, std::memory_order_seq_cst) > 0u))
+    {
+        eventfd_write(m_readySource.eventFd, 1uLL);
+    }
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
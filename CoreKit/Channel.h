@@ -0,0 +1,359 @@
+/**
+ * \file Channel.h
+ * \brief Contains the definition of the \c Channel class template.
+ * \date 2026-10-16 20:12:48
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_CHANNEL_H_
+#define _FOUNDATION_COREKIT_CHANNEL_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <CoreKit/BoundedMpmcQueue.h>
+#include <CoreKit/InputSource.h>
+
+/**
+ * \brief Most elements handed to a channel's receive callback at once.
+ */
+#define RF_CK_CHANNEL_MAX_BATCH (256u)
+
+namespace CoreKit
+{
+
+/**
+ * \brief Part of \c CoreKit::Channel that does not depend on the element type.
+ *
+ * Owns the \c eventfd() that wakes up the receiving \c RunLoop, and the one
+ * that tells senders a full channel has room again.
+ */
+class ChannelBase : public InputSource
+{
+public:
+    /**
+     * \brief Callback told, on the sender's \c RunLoop, that a channel
+     *        found full has room again.
+     */
+    typedef std::function< void() > ReadyCallback;
+
+    /**
+     * \brief Create the \c eventfd() facilities used by the channel.
+     *
+     * \throw OsErrorException if an \c eventfd() can not be created.
+     */
+    ChannelBase();
+
+    /**
+     * \brief Destructor.
+     */
+    virtual ~ChannelBase();
+
+    /**
+     * \brief Access the \c eventfd() that wakes up the receiver.
+     *
+     * \return File descriptor associated with this input source.
+     */
+    virtual int fileDescriptor() const override;
+
+    /**
+     * \brief Channels carry their own callbacks, so they have no listener.
+     *
+     * \return Always \c nullptr.
+     */
+    virtual InterruptListener* interruptListener() const override;
+
+    /**
+     * \brief Access the input source that delivers the "ready" notification.
+     *
+     * Register it with the sending thread's \c RunLoop to have the callback
+     * given to \c setReadyCallback() run there whenever a send found the
+     * channel full and the receiver has since made room.
+     *
+     * \return Input source owned by the channel.
+     */
+    inline InputSource* readySource() { return &m_readySource; }
+
+    /**
+     * \brief Set the callback run by \c readySource().
+     *
+     * \param[in] readyCb - Callback to run; may be empty.
+     */
+    inline void setReadyCallback(ReadyCallback readyCb) { m_readySource.readyCallback = std::move(readyCb); }
+
+    /**
+     * \brief Count the sends that found the channel full.
+     *
+     * \return Number of failed sends.
+     */
+    inline uint64_t fullCount() const { return m_fullCount.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * \brief Wake up the receiving \c RunLoop; coalesced like \c TaskQueue::wake().
+     */
+    void wake();
+
+    /**
+     * \brief Clear the wake up state before the receiver drains the channel.
+     */
+    void beginDrain();
+
+    /**
+     * \brief Note that a send found the channel full, and ask for a "ready"
+     *        notification once the receiver drains it.
+     */
+    void senderBlocked();
+
+    /**
+     * \brief Take back a \c senderBlocked() whose send went through on the
+     *        retry after all.
+     */
+    void senderUnblocked();
+
+    /**
+     * \brief Deliver the "ready" notification if a sender asked for one.
+     */
+    void notifyReady();
+
+private:
+    struct ReadySource : public InputSource
+    {
+        int eventFd;
+        ReadyCallback readyCallback;
+
+        ReadySource();
+        virtual ~ReadySource();
+        virtual int fileDescriptor() const override;
+        virtual InterruptListener* interruptListener() const override;
+        virtual void fireCallback() override;
+    };
+
+    int m_eventFd;
+    std::atomic< bool > m_wakePending;
+    std::atomic< uint32_t > m_sendersWaiting;
+    std::atomic< uint64_t > m_fullCount;
+    ReadySource m_readySource;
+
+    ChannelBase(ChannelBase const& other);
+    ChannelBase& operator=(ChannelBase const& other);
+};
+
+
+/**
+ * \brief Bounded, lock-free queue that delivers elements to a \c RunLoop.
+ *
+ * Any number of threads send elements; the channel itself is an input
+ * source registered with the receiving thread's \c RunLoop, which hands the
+ * elements to a callback in batches of up to \c RF_CK_CHANNEL_MAX_BATCH.
+ * Elements are moved in and out, never copied, so move-only types such as
+ * \c std::unique_ptr pass a buffer from one thread to the next without
+ * touching its contents. Neither sending nor receiving takes a lock or
+ * allocates memory, and a burst of sends costs the receiver one wake up.\par
+ *
+ * A send that finds the channel full fails, leaving the element with the
+ * sender, and arranges for the channel's \c readySource() to fire on the
+ * sender's \c RunLoop once the receiver has drained the channel. A stage of
+ * a pipeline (say, ingest, decode and publish on separate cores) can thus
+ * hold on to its output and stop reading its own input until then.\par
+ *
+ * Register the channel with the receiving \c RunLoop, and its
+ * \c readySource() with the sending one, before the first send; deregister
+ * both before destroying the channel.
+ *
+ * \tparam T Element type; must be default constructible and move
+ *           assignable.
+ */
+template< typename T >
+class Channel : public ChannelBase
+{
+public:
+    /**
+     * \brief Callback handed each batch of received elements.
+     *
+     * The callback may move the elements out; whatever it leaves behind is
+     * destroyed once it returns.
+     */
+    typedef std::function< void(std::vector< T >& batch) > ReceiveCallback;
+
+private:
+    BoundedMpmcQueue< T > m_queue;
+    ReceiveCallback m_receiveCallback;
+    std::vector< T > m_batch;
+
+public:
+    /**
+     * \brief Main constructor.
+     *
+     * \param[in] capacity - Maximum number of elements in flight. Rounded up
+     *            to the next power of two.
+     * \param[in] receiveCb - Callback run on the receiving \c RunLoop.
+     *
+     * \throw OsErrorException if an \c eventfd() can not be created.
+     */
+    Channel(size_t capacity, ReceiveCallback receiveCb):
+        m_queue(capacity),
+        m_receiveCallback(std::move(receiveCb))
+    {
+        m_batch.reserve((m_queue.capacity() < RF_CK_CHANNEL_MAX_BATCH) ? m_queue.capacity() : RF_CK_CHANNEL_MAX_BATCH);
+    }
+
+    /**
+     * \brief Destructor.
+     *
+     * Elements still in the channel are destroyed without being received.
+     */
+    virtual ~Channel() {}
+
+    /**
+     * \brief Hand the waiting elements to the receive callback.
+     *
+     * At most one channel's worth of elements are received per call, so a
+     * sender that never lets up can not starve the other input sources.
+     */
+    virtual void fireCallback() override
+    {
+        size_t budget = m_queue.capacity();
+        T anElement;
+
+        this->beginDrain();
+        try
+        {
+            while (budget > 0u)
+            {
+                while ((m_batch.size() < m_batch.capacity()) && (budget > 0u) && m_queue.tryPop(anElement))
+                {
+                    m_batch.push_back(std::move(anElement));
+                    --budget;
+                }
+                if (m_batch.empty())
+                {
+                    break;
+                }
+
+                /*
+                 * Room was made as soon as the batch was popped, so senders
+                 * waiting on it need not wait for the callback.
+                 */
+                this->notifyReady();
+                if (m_receiveCallback)
+                {
+                    m_receiveCallback(m_batch);
+                }
+                m_batch.clear();
+            }
+        }
+        catch (...)
+        {
+            m_batch.clear();
+            this->wake();
+            throw;
+        }
+
+        if (0u == budget)
+        {
+            this->wake();
+        }
+    }
+
+    /**
+     * \brief Send an element, if there is room.
+     *
+     * Safe to call from any thread.
+     *
+     * \param[in] value - Element to move into the channel. Left untouched
+     *            if the channel is full.
+     *
+     * \return \c true if the element was sent; \c false if the channel is
+     *         full, in which case \c readySource() fires once it drains.
+     */
+    bool trySend(T&& value)
+    {
+        bool result = m_queue.tryPush(std::move(value));
+
+        if (!result)
+        {
+            /*
+             * Ask for the "ready" notification before trying again, so a
+             * receiver that drained the channel in the meantime is not
+             * missed.
+             */
+            this->senderBlocked();
+            result = m_queue.tryPush(std::move(value));
+            if (result)
+            {
+                this->senderUnblocked();
+            }
+        }
+
+        if (result)
+        {
+            this->wake();
+        }
+
+        return result;
+    }
+
+    /**
+     * \brief Send several elements, waking the receiver only once.
+     *
+     * Safe to call from any thread. Elements are sent in order until the
+     * channel fills up; those sent are moved out of \c values.
+     *
+     * \param[in,out] values - Elements to send.
+     *
+     * \return Number of elements sent, from the front of \c values.
+     */
+    size_t trySendBatch(std::vector< T >& values)
+    {
+        size_t result = 0u;
+
+        while ((result < values.size()) && m_queue.tryPush(std::move(values[result])))
+        {
+            ++result;
+        }
+
+        if (result < values.size())
+        {
+            this->senderBlocked();
+            while ((result < values.size()) && m_queue.tryPush(std::move(values[result])))
+            {
+                ++result;
+            }
+            if (result == values.size())
+            {
+                this->senderUnblocked();
+            }
+        }
+
+        if (result > 0u)
+        {
+            this->wake();
+        }
+
+        return result;
+    }
+
+    /**
+     * \brief Access the maximum number of elements in flight.
+     *
+     * \return Channel capacity.
+     */
+    inline size_t capacity() const { return m_queue.capacity(); }
+
+    /**
+     * \brief Approximate the number of elements in flight.
+     *
+     * \return Number of elements sent but not yet received.
+     */
+    inline size_t sizeApprox() const { return m_queue.sizeApprox(); }
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_CHANNEL_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
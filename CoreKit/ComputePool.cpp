@@ -0,0 +1,413 @@
+/**
+ * \file ComputePool.cpp
+ * \brief Contains the implementation of the \c ComputePool class.
+ * \date 2026-10-16 17:20:36
+ * \author Rolando J. Nieves
+ */
+
+#include <unistd.h>
+#include <cstring>
+#include <exception>
+
+#include <CoreKit/Application.h>
+#include <CoreKit/OsErrorException.h>
+#include <CoreKit/RunLoop.h>
+
+#include "ComputePool.h"
+
+#define RF_CK_CP_DEQUE_CAPACITY (1024u)
+#define RF_CK_CP_SUBMIT_QUEUE_CAPACITY (4096u)
+#define RF_CK_CP_IDLE_SPINS (64u)
+
+
+namespace CoreKit
+{
+
+thread_local ComputePool::Worker *ComputePool::s_currentWorker = nullptr;
+
+
+ComputePool::Configuration::Configuration():
+    workerCount(0u),
+    dequeCapacity(RF_CK_CP_DEQUE_CAPACITY),
+    submitQueueCapacity(RF_CK_CP_SUBMIT_QUEUE_CAPACITY)
+{
+
+}
+
+
+ComputePool::Worker::Worker(ComputePool *thePool, unsigned theIndex, size_t dequeCapacity):
+    pool(thePool),
+    index(theIndex),
+    threadId(),
+    deque(dequeCapacity),
+    stealSeed(theIndex + 1u)
+{
+
+}
+
+
+ComputePool::ComputePool(Configuration const& config):
+    m_submitQueue(config.submitQueueCapacity),
+    m_stopping(false),
+    m_sleepers(0u),
+    m_executed(0u),
+    m_stolen(0u),
+    m_rejected(0u),
+    m_failed(0u),
+    m_undelivered(0u)
+{
+    unsigned workerCount = config.workerCount;
+    int createResult = 0;
+
+    if (0u == workerCount)
+    {
+        long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        workerCount = (onlineCpus > 1) ? static_cast<unsigned>(onlineCpus - 1) : 1u;
+    }
+
+    pthread_mutex_init(&m_sleepMutex, nullptr);
+    pthread_cond_init(&m_sleepCond, nullptr);
+
+    /*
+     * All workers must exist before any of them starts looking for work in
+     * the others' deques.
+     */
+    for (unsigned workerIdx = 0u; workerIdx < workerCount; ++workerIdx)
+    {
+        m_workers.push_back(new Worker(this, workerIdx, config.dequeCapacity));
+    }
+
+    for (Worker *aWorker : m_workers)
+    {
+        pthread_attr_t threadAttr;
+        cpu_set_t const *affinity = config.affinities.empty() ? nullptr : &config.affinities[aWorker->index % config.affinities.size()];
+
+        pthread_attr_init(&threadAttr);
+        if (affinity != nullptr)
+        {
+            pthread_attr_setaffinity_np(&threadAttr, sizeof(cpu_set_t), affinity);
+        }
+        createResult = pthread_create(&aWorker->threadId, &threadAttr, &ComputePool::workerKickoffRoutine, aWorker);
+        pthread_attr_destroy(&threadAttr);
+
+        if (createResult != 0)
+        {
+            /*
+             * Stop the workers already running; there is no destructor call
+             * for a partially constructed pool.
+             */
+            m_stopping.store(true);
+            pthread_mutex_lock(&m_sleepMutex);
+            pthread_cond_broadcast(&m_sleepCond);
+            pthread_mutex_unlock(&m_sleepMutex);
+            for (unsigned joinIdx = 0u; joinIdx < aWorker->index; ++joinIdx)
+            {
+                pthread_join(m_workers[joinIdx]->threadId, nullptr);
+            }
+            for (Worker *deadWorker : m_workers)
+            {
+                delete deadWorker;
+            }
+            pthread_cond_destroy(&m_sleepCond);
+            pthread_mutex_destroy(&m_sleepMutex);
+            throw OsErrorException("pthread_create", createResult);
+        }
+    }
+}
+
+
+ComputePool::~ComputePool()
+{
+    Job *aJob = nullptr;
+
+    m_stopping.store(true);
+    pthread_mutex_lock(&m_sleepMutex);
+    pthread_cond_broadcast(&m_sleepCond);
+    pthread_mutex_unlock(&m_sleepMutex);
+
+    for (Worker *aWorker : m_workers)
+    {
+        pthread_join(aWorker->threadId, nullptr);
+    }
+
+    /*
+     * With every worker gone, this thread may act as the owner of their
+     * deques to discard what is left.
+     */
+    for (Worker *aWorker : m_workers)
+    {
+        while (aWorker->deque.pop(aJob))
+        {
+            delete aJob;
+        }
+        delete aWorker;
+    }
+    m_workers.clear();
+
+    while (m_submitQueue.tryPop(aJob))
+    {
+        delete aJob;
+    }
+
+    pthread_cond_destroy(&m_sleepCond);
+    pthread_mutex_destroy(&m_sleepMutex);
+}
+
+
+void*
+ComputePool::workerKickoffRoutine(void *userData)
+{
+    Worker *theWorker = static_cast<Worker*>(userData);
+
+    s_currentWorker = theWorker;
+    theWorker->pool->workerLoop(theWorker);
+    s_currentWorker = nullptr;
+
+    return nullptr;
+}
+
+
+void
+ComputePool::workerLoop(Worker *theWorker)
+{
+    Job *aJob = nullptr;
+    unsigned idleSpins = 0u;
+
+    while (!m_stopping.load(std::memory_order_relaxed))
+    {
+        if ((aJob = this->findJob(theWorker)) != nullptr)
+        {
+            idleSpins = 0u;
+            this->runJob(aJob);
+            continue;
+        }
+
+        if (++idleSpins < RF_CK_CP_IDLE_SPINS)
+        {
+            sched_yield();
+            continue;
+        }
+        idleSpins = 0u;
+
+        /*
+         * Announce the intent to sleep before the last look for work, so a
+         * submitter either sees this worker as a sleeper or this worker sees
+         * the submitted task.
+         */
+        pthread_mutex_lock(&m_sleepMutex);
+        m_sleepers.fetch_add(1u);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!this->hasQueuedJobs() && !m_stopping.load())
+        {
+            pthread_cond_wait(&m_sleepCond, &m_sleepMutex);
+        }
+        m_sleepers.fetch_sub(1u);
+        pthread_mutex_unlock(&m_sleepMutex);
+    }
+}
+
+
+bool
+ComputePool::enqueue(Job *theJob)
+{
+    bool result = false;
+
+    if ((s_currentWorker != nullptr) && (this == s_currentWorker->pool))
+    {
+        result = s_currentWorker->deque.push(theJob);
+    }
+    if (!result)
+    {
+        result = m_submitQueue.tryPush(std::move(theJob));
+    }
+
+    if (!result)
+    {
+        m_rejected.fetch_add(1u, std::memory_order_relaxed);
+        delete theJob;
+        return false;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load() > 0u)
+    {
+        this->wakeWorker();
+    }
+
+    return true;
+}
+
+
+ComputePool::Job*
+ComputePool::findJob(Worker *theWorker)
+{
+    Job *result = nullptr;
+    unsigned victimCount = static_cast<unsigned>(m_workers.size()) - 1u;
+    unsigned firstVictim = 0u;
+
+    if (theWorker->deque.pop(result) || m_submitQueue.tryPop(result))
+    {
+        return result;
+    }
+
+    if (0u == victimCount)
+    {
+        return nullptr;
+    }
+
+    /*
+     * Start from a pseudo-random victim so idle workers do not all hammer
+     * the same deque.
+     */
+    theWorker->stealSeed ^= theWorker->stealSeed << 13;
+    theWorker->stealSeed ^= theWorker->stealSeed >> 17;
+    theWorker->stealSeed ^= theWorker->stealSeed << 5;
+    firstVictim = theWorker->stealSeed % victimCount;
+
+    for (unsigned victimIdx = 0u; victimIdx < victimCount; ++victimIdx)
+    {
+        unsigned victim = (theWorker->index + 1u + ((firstVictim + victimIdx) % victimCount)) % m_workers.size();
+
+        if (m_workers[victim]->deque.steal(result))
+        {
+            m_stolen.fetch_add(1u, std::memory_order_relaxed);
+            return result;
+        }
+    }
+
+    return nullptr;
+}
+
+
+bool
+ComputePool::hasQueuedJobs() const
+{
+    if (m_submitQueue.sizeApprox() > 0u)
+    {
+        return true;
+    }
+
+    for (Worker const *aWorker : m_workers)
+    {
+        if (aWorker->deque.sizeApprox() > 0u)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void
+ComputePool::runJob(Job *theJob)
+{
+    std::exception_ptr error;
+
+    try
+    {
+        theJob->work();
+    }
+    catch (std::exception& ex)
+    {
+        error = std::current_exception();
+        if ((G_MyApp != nullptr) && !theJob->failure)
+        {
+            G_MyApp->log() << AppLog::LL_ERROR << "Compute pool task failed: " << ex.what() << EndLog;
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+        if ((G_MyApp != nullptr) && !theJob->failure)
+        {
+            G_MyApp->log() << AppLog::LL_ERROR << "Compute pool task failed with an unknown exception." << EndLog;
+        }
+    }
+
+    if (!error)
+    {
+        m_executed.fetch_add(1u, std::memory_order_relaxed);
+        if ((theJob->origin != nullptr) && theJob->completion)
+        {
+            this->deliver(theJob->origin, std::move(theJob->completion));
+        }
+    }
+    else
+    {
+        m_failed.fetch_add(1u, std::memory_order_relaxed);
+        if ((theJob->origin != nullptr) && theJob->failure)
+        {
+            Failure failure = std::move(theJob->failure);
+
+            this->deliver(theJob->origin, [failure, error]() { failure(error); });
+        }
+    }
+
+    delete theJob;
+}
+
+
+void
+ComputePool::deliver(RunLoop *origin, Task&& notice)
+{
+    /*
+     * Wait for room rather than drop the notice, since the submitter may be
+     * waiting on it. The wait ends when the origin is terminated, as its
+     * queue then stops accepting blocking posts it has no room for.
+     */
+    if (!origin->post(std::move(notice), TaskQueue::OP_BLOCK))
+    {
+        m_undelivered.fetch_add(1u, std::memory_order_relaxed);
+    }
+}
+
+
+void
+ComputePool::wakeWorker()
+{
+    pthread_mutex_lock(&m_sleepMutex);
+    pthread_cond_signal(&m_sleepCond);
+    pthread_mutex_unlock(&m_sleepMutex);
+}
+
+
+bool
+ComputePool::submit(Task work)
+{
+    return this->enqueue(new Job{ std::move(work), nullptr, Task(), Failure() });
+}
+
+
+bool
+ComputePool::submit(RunLoop *origin, Task work, Task completion)
+{
+    return this->enqueue(new Job{ std::move(work), origin, std::move(completion), Failure() });
+}
+
+
+bool
+ComputePool::submit(RunLoop *origin, Task work, Task completion, Failure failure)
+{
+    return this->enqueue(new Job{ std::move(work), origin, std::move(completion), std::move(failure) });
+}
+
+
+ComputePool::Statistics
+ComputePool::statistics() const
+{
+    Statistics result;
+
+    result.executed = m_executed.load(std::memory_order_relaxed);
+    result.stolen = m_stolen.load(std::memory_order_relaxed);
+    result.rejected = m_rejected.load(std::memory_order_relaxed);
+    result.failed = m_failed.load(std::memory_order_relaxed);
+    result.undelivered = m_undelivered.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,270 @@
+/**
+ * \file ComputePool.h
+ * \brief Contains the definition of the \c ComputePool class.
+ * \date 2026-10-16 17:20:36
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_COMPUTEPOOL_H_
+#define _FOUNDATION_COREKIT_COMPUTEPOOL_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <CoreKit/BoundedMpmcQueue.h>
+#include <CoreKit/WorkStealingDeque.h>
+
+namespace CoreKit
+{
+
+class RunLoop;
+
+/**
+ * \brief Work-stealing thread pool for CPU-bound work.
+ *
+ * Moves work that would otherwise stall a \c CoreKit::RunLoop (decoding,
+ * compression, checksum validation and the like) onto a set of worker
+ * threads. Each worker owns a \c WorkStealingDeque; tasks submitted by a
+ * worker go to its own deque, tasks submitted by any other thread go to a
+ * shared queue, and idle workers steal from the others before going to
+ * sleep.
+ *
+ * A task may name the \c RunLoop it was submitted from, along with a
+ * completion closure and, optionally, a failure closure. Once the task is
+ * done, the completion (or, if the task threw, the failure) is handed to
+ * that loop with \c RunLoop::post(), so it runs on the submitting thread
+ * and may touch that thread's state without locking.\par
+ *
+ * That loop must outlive every task that names it, and keep running until
+ * their completions are delivered. A worker waits for room in the loop's
+ * queue only until the loop is terminated; completions meant for a
+ * terminated loop never run, and those that did not fit in its queue are
+ * counted as undelivered.
+ *
+ * Tasks still queued when the pool is destroyed are discarded without
+ * running.
+ */
+class ComputePool
+{
+public:
+    /**
+     * \brief Closure run by the pool.
+     */
+    typedef std::function< void() > Task;
+
+    /**
+     * \brief Closure told about a task that threw.
+     */
+    typedef std::function< void(std::exception_ptr) > Failure;
+
+    /**
+     * \brief Construction time settings.
+     */
+    struct Configuration
+    {
+        /**
+         * \brief Number of worker threads; zero picks one less than the
+         *        number of online CPUs, but at least one.
+         */
+        unsigned workerCount;
+        /**
+         * \brief CPU affinity of each worker; worker \c n is pinned to
+         *        <tt>affinities[n % affinities.size()]</tt>. Workers are
+         *        left unpinned if empty.
+         */
+        std::vector< cpu_set_t > affinities;
+        /**
+         * \brief Capacity of each worker's deque.
+         */
+        size_t dequeCapacity;
+        /**
+         * \brief Capacity of the queue for tasks submitted by other threads.
+         */
+        size_t submitQueueCapacity;
+
+        Configuration();
+    };
+
+    /**
+     * \brief Counters kept by the pool.
+     */
+    struct Statistics
+    {
+        /**
+         * \brief Tasks run to completion.
+         */
+        uint64_t executed;
+        /**
+         * \brief Tasks a worker took from another worker's deque.
+         */
+        uint64_t stolen;
+        /**
+         * \brief Tasks refused because a queue was full.
+         */
+        uint64_t rejected;
+        /**
+         * \brief Tasks that ended by throwing an exception.
+         */
+        uint64_t failed;
+        /**
+         * \brief Completions and failures dropped because the \c RunLoop
+         *        they were meant for was terminated with a full queue.
+         */
+        uint64_t undelivered;
+    };
+
+private:
+    struct Job
+    {
+        Task work;
+        RunLoop *origin;
+        Task completion;
+        Failure failure;
+    };
+
+    struct Worker
+    {
+        ComputePool *pool;
+        unsigned index;
+        pthread_t threadId;
+        WorkStealingDeque< Job* > deque;
+        uint32_t stealSeed;
+
+        Worker(ComputePool *thePool, unsigned theIndex, size_t dequeCapacity);
+    };
+
+    std::vector< Worker* > m_workers;
+    BoundedMpmcQueue< Job* > m_submitQueue;
+    std::atomic< bool > m_stopping;
+    std::atomic< unsigned > m_sleepers;
+    pthread_mutex_t m_sleepMutex;
+    pthread_cond_t m_sleepCond;
+    std::atomic< uint64_t > m_executed;
+    std::atomic< uint64_t > m_stolen;
+    std::atomic< uint64_t > m_rejected;
+    std::atomic< uint64_t > m_failed;
+    std::atomic< uint64_t > m_undelivered;
+
+    static thread_local Worker *s_currentWorker;
+
+    ComputePool(ComputePool const& other);
+    ComputePool& operator=(ComputePool const& other);
+
+    static void* workerKickoffRoutine(void *userData);
+
+    void workerLoop(Worker *theWorker);
+    bool enqueue(Job *theJob);
+    Job* findJob(Worker *theWorker);
+    bool hasQueuedJobs() const;
+    void runJob(Job *theJob);
+    void deliver(RunLoop *origin, Task&& notice);
+    void wakeWorker();
+
+public:
+    /**
+     * \brief Start the worker threads.
+     *
+     * \param[in] config - Pool settings.
+     *
+     * \throw OsErrorException if a worker thread can not be created.
+     */
+    explicit ComputePool(Configuration const& config = Configuration());
+
+    /**
+     * \brief Destructor; stops the worker threads and waits for them.
+     *
+     * Tasks that are already running finish; queued tasks are discarded.
+     */
+    ~ComputePool();
+
+    /**
+     * \brief Access the number of worker threads.
+     *
+     * \return Number of workers.
+     */
+    inline unsigned workerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+    /**
+     * \brief Run a closure on a worker thread.
+     *
+     * \param[in] work - Closure to run.
+     *
+     * \return \c true if the task was queued; \c false if the queue was full.
+     */
+    bool submit(Task work);
+
+    /**
+     * \brief Run a closure on a worker thread, then a completion on a \c RunLoop.
+     *
+     * \param[in] origin - Run loop the completion is posted to, normally the
+     *            one hosted by the calling thread.
+     * \param[in] work - Closure to run on a worker thread.
+     * \param[in] completion - Closure to run on \c origin's thread after
+     *            \c work returns. Not run if \c work throws; the failure
+     *            is only logged.
+     *
+     * \return \c true if the task was queued; \c false if the queue was full.
+     */
+    bool submit(RunLoop *origin, Task work, Task completion);
+
+    /**
+     * \brief Run a closure on a worker thread, then report how it went on a \c RunLoop.
+     *
+     * \param[in] origin - Run loop the completion or failure is posted to.
+     * \param[in] work - Closure to run on a worker thread.
+     * \param[in] completion - Closure to run on \c origin's thread after
+     *            \c work returns.
+     * \param[in] failure - Closure to run on \c origin's thread, with the
+     *            exception thrown, if \c work throws.
+     *
+     * \return \c true if the task was queued; \c false if the queue was full.
+     */
+    bool submit(RunLoop *origin, Task work, Task completion, Failure failure);
+
+    /**
+     * \brief Compute a value on a worker thread and hand it to a \c RunLoop.
+     *
+     * \param[in] origin - Run loop the completion is posted to.
+     * \param[in] work - Callable taking no arguments that returns the value.
+     * \param[in] completion - Callable run on \c origin's thread with a
+     *            reference to the value returned by \c work and a
+     *            \c std::exception_ptr. If \c work threw, the pointer holds
+     *            the exception and the value is default constructed;
+     *            otherwise the pointer is null. The value type must be
+     *            default constructible.
+     *
+     * \return \c true if the task was queued; \c false if the queue was full.
+     */
+    template< typename Work, typename Completion >
+    bool submitWithResult(RunLoop *origin, Work work, Completion completion)
+    {
+        typedef decltype(work()) ResultType;
+        std::shared_ptr< ResultType > theResult = std::make_shared< ResultType >();
+
+        return this->submit(
+            origin,
+            [work, theResult]() mutable { *theResult = work(); },
+            [completion, theResult]() mutable { completion(*theResult, std::exception_ptr()); },
+            [completion, theResult](std::exception_ptr error) mutable { completion(*theResult, error); }
+        );
+    }
+
+    /**
+     * \brief Gather the counters kept by the pool.
+     *
+     * \return Snapshot of the counters.
+     */
+    Statistics statistics() const;
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_COMPUTEPOOL_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
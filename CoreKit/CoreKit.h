@@ -14,17 +14,34 @@
 #include <CoreKit/AppDelegate.h>
 #include <CoreKit/Application.h>
 #include <CoreKit/AppLog.h>
+#include <CoreKit/BinaryLog.h>
+#include <CoreKit/ComputePool.h>
+#include <CoreKit/Coroutine.h>
+#include <CoreKit/FramePool.h>
+#include <CoreKit/FrameScheduler.h>
+#include <CoreKit/FrameSync.h>
+
 #include <CoreKit/InputSource.h>
 #include <CoreKit/InterruptListener.h>
 #include <CoreKit/InvalidInputException.h>
+#include <CoreKit/IoUring.h>
+#include <CoreKit/LatencyHistogram.h>
+#include <CoreKit/LogThrottle.h>
+
+#include <CoreKit/LoopCallback.h>
+#include <CoreKit/LoopGroup.h>
+
 #include <CoreKit/OsErrorException.h>
 #include <CoreKit/PreconditionNotMetException.h>
 #include <CoreKit/RunLoop.h>
 #include <CoreKit/RuntimeErrorException.h>
 #include <CoreKit/SignalInputSource.h>
 #include <CoreKit/Thread.h>
+#include <CoreKit/ThreadAttributes.h>
 #include <CoreKit/ThreadDelegate.h>
 #include <CoreKit/TimerInputSource.h>
+#include <CoreKit/TimerWheel.h>
+
 #include <CoreKit/StaticAllocator.h>
 #include <CoreKit/FixedAllocator.h>
 #include <CoreKit/ByteVector.h>
@@ -32,12 +49,18 @@
 #include <CoreKit/prodinfo.h>
 #include <CoreKit/BoundMember.h>
 #include <CoreKit/SystemTime.h>
+#include <CoreKit/WatchdogService.h>
 #include <CoreKit/WatchdogTimer.h>
 #include <CoreKit/WatchdogExpiredCallback.h>
 #include <CoreKit/WatchdogExpiredCallbackT.h>
 #include <CoreKit/CmdLineMultiArg.h>
 #include <CoreKit/EventInputSource.h>
 #include <CoreKit/BlockGuard.h>
+#include <CoreKit/BoundedMpmcQueue.h>
+#include <CoreKit/Channel.h>
+#include <CoreKit/TaskQueue.h>
+#include <CoreKit/WorkStealingDeque.h>
+
 
 /**
  * \namespace CoreKit
@@ -0,0 +1,333 @@
+/**
+ * \file Coroutine.h
+ * \brief Contains the definition of the \c Coroutine type and its awaitables.
+ * \date 2026-10-16 15:02:47
+ * \author Rolando J. Nieves
+ *
+ * Coroutines let a sequential protocol be written as straight-line code
+ * that suspends wherever it would otherwise return to the \c RunLoop and
+ * wait for a callback:
+ *
+ * \code
+ * CoreKit::Coroutine pingPong(CoreKit::RunLoop& theRunLoop, int fd)
+ * {
+ *     for (;;)
+ *     {
+ *         co_await CoreKit::readable(theRunLoop, fd);
+ *         // ... read the request and write the reply ...
+ *         co_await CoreKit::sleepFor(theRunLoop, 0.5);
+ *     }
+ * }
+ * \endcode
+ *
+ * Everything in this file requires a compiler with C++20 coroutine support
+ * and is left out otherwise, so the header may be included regardless of
+ * the language level the rest of an application is built with.
+ */
+
+#ifndef _FOUNDATION_COREKIT_COROUTINE_H_
+#define _FOUNDATION_COREKIT_COROUTINE_H_
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+
+#define RF_CK_HAS_COROUTINES (1)
+
+#include <coroutine>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include <CoreKit/FramePool.h>
+#include <CoreKit/InputSource.h>
+#include <CoreKit/InterruptListener.h>
+#include <CoreKit/RunLoop.h>
+
+/**
+ * \brief Relative priority given to input sources created by \c readable().
+ */
+#define RF_CK_CORO_DEFAULT_PRIORITY (128u)
+
+namespace CoreKit
+{
+
+/**
+ * \brief Locate the \c RunLoop among the parameters of a coroutine.
+ *
+ * Used to pick the frame pool a coroutine's frame comes from. The first
+ * \c RunLoop reference or pointer among the parameters wins.
+ */
+inline RunLoop* coroutineRunLoop()
+{
+    return nullptr;
+}
+
+template< typename First, typename... Rest >
+inline RunLoop* coroutineRunLoop(First& first, Rest&... rest)
+{
+    typedef typename std::remove_cv< First >::type ParamType;
+
+    if constexpr (std::is_base_of< RunLoop, ParamType >::value)
+    {
+        return &first;
+    }
+    else if constexpr (std::is_pointer< ParamType >::value &&
+        std::is_base_of< RunLoop, typename std::remove_cv< typename std::remove_pointer< ParamType >::type >::type >::value)
+    {
+        return (first != nullptr) ? first : coroutineRunLoop(rest...);
+    }
+    else
+    {
+        return coroutineRunLoop(rest...);
+    }
+}
+
+
+/**
+ * \brief Fire-and-forget coroutine driven by a \c RunLoop.
+ *
+ * A function returning \c Coroutine starts running as soon as it is called
+ * and carries on from one \c co_await to the next as the \c RunLoop
+ * services the events it waits for. Its frame is released when it
+ * returns.
+ *
+ * If one of the parameters of the coroutine is a \c RunLoop (by reference
+ * or pointer), the frame is allocated from that loop's \c FramePool
+ * instead of the heap. The coroutine must then be started and finish on
+ * the thread running that \c RunLoop, and before it is destroyed.
+ *
+ * An exception that escapes the coroutine body propagates to whoever
+ * resumed it last, which is normally the \c RunLoop, just as it would from
+ * a callback. The frame of such a coroutine is not released.
+ */
+class Coroutine
+{
+public:
+    struct promise_type
+    {
+        /**
+         * \brief Bookkeeping stored in front of every frame.
+         */
+        struct FrameHeader
+        {
+            FramePool *pool;
+            alignas(std::max_align_t) unsigned char payload[1];
+        };
+
+        static inline void* allocateFrame(size_t size, RunLoop *theRunLoop)
+        {
+            size_t total = offsetof(FrameHeader, payload) + size;
+            FramePool *thePool = (theRunLoop != nullptr) ? theRunLoop->framePool() : nullptr;
+            FrameHeader *header = static_cast<FrameHeader*>(
+                (thePool != nullptr) ? thePool->allocate(total) : ::operator new(total)
+            );
+
+            header->pool = thePool;
+
+            return &header->payload[0];
+        }
+
+        template< typename... Args >
+        static void* operator new(size_t size, Args&... args)
+        {
+            return allocateFrame(size, coroutineRunLoop(args...));
+        }
+
+        static void* operator new(size_t size)
+        {
+            return allocateFrame(size, nullptr);
+        }
+
+        static void operator delete(void *frame, size_t size)
+        {
+            size_t total = offsetof(FrameHeader, payload) + size;
+            FrameHeader *header = reinterpret_cast<FrameHeader*>(
+                static_cast<unsigned char*>(frame) - offsetof(FrameHeader, payload)
+            );
+
+            if (header->pool != nullptr)
+            {
+                header->pool->release(header, total);
+            }
+            else
+            {
+                ::operator delete(header);
+            }
+        }
+
+        inline Coroutine get_return_object() { return Coroutine(); }
+        inline std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+        inline std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+        inline void return_void() {}
+        inline void unhandled_exception() { throw; }
+    };
+};
+
+
+/**
+ * \brief Awaitable that suspends until a file descriptor is readable.
+ *
+ * While suspended, the awaitable is registered with the \c RunLoop as an
+ * input source; it lives in the coroutine frame, so waiting allocates
+ * nothing.
+ */
+class ReadableAwaiter : public InputSource
+{
+public:
+    ReadableAwaiter(RunLoop& theRunLoop, int fd, uint8_t relativePriority)
+    : InputSource(relativePriority), m_runLoop(theRunLoop), m_fd(fd)
+    {
+
+    }
+
+    inline bool await_ready() const noexcept { return false; }
+
+    inline void await_suspend(std::coroutine_handle<> waiter)
+    {
+        m_waiter = waiter;
+        m_runLoop.registerInputSource(this);
+    }
+
+    inline void await_resume() const noexcept {}
+
+    virtual int fileDescriptor() const { return m_fd; }
+
+    virtual void fireCallback()
+    {
+        m_runLoop.deregisterInputSource(this);
+        m_waiter.resume();
+    }
+
+private:
+    RunLoop& m_runLoop;
+    int m_fd;
+    std::coroutine_handle<> m_waiter;
+};
+
+
+/**
+ * \brief Wait until a file descriptor has input available.
+ *
+ * \param[in] theRunLoop - Run loop that services the wait.
+ * \param[in] fd - File descriptor to watch.
+ * \param[in] relativePriority - Priority of the wait relative to the other
+ *            input sources of the run loop.
+ *
+ * \return Awaitable; \c co_await it to suspend.
+ */
+inline ReadableAwaiter readable(RunLoop& theRunLoop, int fd, uint8_t relativePriority = RF_CK_CORO_DEFAULT_PRIORITY)
+{
+    return ReadableAwaiter(theRunLoop, fd, relativePriority);
+}
+
+
+/**
+ * \brief Awaitable that suspends for a fixed amount of time.
+ *
+ * The wait is a one-shot \c RunLoop timer, so it is as cheap as the timers
+ * the loop is configured with; with \c Configuration::timerWheelTick set,
+ * waiting allocates nothing.
+ */
+class SleepAwaiter : public InterruptListener
+{
+public:
+    SleepAwaiter(RunLoop& theRunLoop, double duration)
+    : m_runLoop(theRunLoop), m_duration(duration), m_timerId(-1)
+    {
+
+    }
+
+    inline bool await_ready() const noexcept { return (m_duration <= 0.0); }
+
+    inline void await_suspend(std::coroutine_handle<> waiter)
+    {
+        m_waiter = waiter;
+        m_timerId = m_runLoop.registerTimerWithInterval(m_duration, this, false);
+    }
+
+    inline void await_resume() const noexcept {}
+
+    virtual void timerExpired(int timerId)
+    {
+        m_runLoop.deregisterTimer(timerId);
+        m_timerId = -1;
+        m_waiter.resume();
+    }
+
+private:
+    RunLoop& m_runLoop;
+    double m_duration;
+    int m_timerId;
+    std::coroutine_handle<> m_waiter;
+};
+
+
+/**
+ * \brief Wait for an amount of time.
+ *
+ * \param[in] theRunLoop - Run loop that services the wait.
+ * \param[in] duration - Time to wait, in seconds.
+ *
+ * \return Awaitable; \c co_await it to suspend.
+ */
+inline SleepAwaiter sleepFor(RunLoop& theRunLoop, double duration)
+{
+    return SleepAwaiter(theRunLoop, duration);
+}
+
+
+/**
+ * \brief Awaitable that moves a coroutine onto a \c RunLoop.
+ *
+ * The coroutine is resumed by a closure posted to the run loop, so this
+ * also works when the coroutine is currently running on another thread.
+ * Awaiting it from the run loop's own thread yields to the other work
+ * pending in the loop.
+ */
+class ResumeOnAwaiter
+{
+public:
+    explicit ResumeOnAwaiter(RunLoop& theRunLoop)
+    : m_runLoop(theRunLoop)
+    {
+
+    }
+
+    inline bool await_ready() const noexcept { return false; }
+
+    inline bool await_suspend(std::coroutine_handle<> waiter)
+    {
+        /*
+         * Should the closure be dropped, carry on right away rather than
+         * leave the coroutine suspended forever.
+         */
+        return m_runLoop.post([waiter]() { waiter.resume(); });
+    }
+
+    inline void await_resume() const noexcept {}
+
+private:
+    RunLoop& m_runLoop;
+};
+
+
+/**
+ * \brief Continue running on a \c RunLoop's thread.
+ *
+ * \param[in] theRunLoop - Run loop to continue on.
+ *
+ * \return Awaitable; \c co_await it to suspend.
+ */
+inline ResumeOnAwaiter resumeOn(RunLoop& theRunLoop)
+{
+    return ResumeOnAwaiter(theRunLoop);
+}
+
+} // end namespace CoreKit
+
+#endif /* __has_include(<coroutine>) */
+#endif /* __cpp_impl_coroutine */
+
+#endif /* !_FOUNDATION_COREKIT_COROUTINE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
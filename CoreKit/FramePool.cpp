@@ -0,0 +1,102 @@
+/**
+ * \file FramePool.cpp
+ * \brief Contains the implementation of the \c FramePool class.
+ * \date 2026-10-16 15:02:47
+ * \author Rolando J. Nieves
+ */
+
+#include <new>
+
+#include "FramePool.h"
+
+#define RF_CK_FP_BLOCKS_PER_CHUNK (8u)
+
+
+namespace CoreKit
+{
+
+const size_t FramePool::Granularity;
+const unsigned FramePool::NumClasses;
+
+
+FramePool::FramePool():
+    m_outstanding(0u),
+    m_heapFallbacks(0u)
+{
+    for (unsigned classIdx = 0u; classIdx < NumClasses; ++classIdx)
+    {
+        m_freeLists[classIdx] = nullptr;
+    }
+}
+
+
+FramePool::~FramePool()
+{
+    for (void *aChunk : m_chunks)
+    {
+        ::operator delete(aChunk);
+    }
+    m_chunks.clear();
+}
+
+
+void*
+FramePool::allocate(size_t size)
+{
+    size_t classIdx = (size > 0u) ? ((size - 1u) / Granularity) : 0u;
+    FreeBlock *theBlock = nullptr;
+
+    if (classIdx >= NumClasses)
+    {
+        m_heapFallbacks++;
+        return ::operator new(size);
+    }
+
+    if (nullptr == m_freeLists[classIdx])
+    {
+        size_t blockSize = (classIdx + 1u) * Granularity;
+        char *theChunk = static_cast<char*>(::operator new(blockSize * RF_CK_FP_BLOCKS_PER_CHUNK));
+
+        m_chunks.push_back(theChunk);
+        for (unsigned blockIdx = 0u; blockIdx < RF_CK_FP_BLOCKS_PER_CHUNK; ++blockIdx)
+        {
+            FreeBlock *newBlock = reinterpret_cast<FreeBlock*>(theChunk + (blockIdx * blockSize));
+
+            newBlock->next = m_freeLists[classIdx];
+            m_freeLists[classIdx] = newBlock;
+        }
+    }
+
+    theBlock = m_freeLists[classIdx];
+    m_freeLists[classIdx] = theBlock->next;
+    m_outstanding++;
+
+    return theBlock;
+}
+
+
+void
+FramePool::release(void *block, size_t size)
+{
+    size_t classIdx = (size > 0u) ? ((size - 1u) / Granularity) : 0u;
+    FreeBlock *theBlock = static_cast<FreeBlock*>(block);
+
+    if (nullptr == block)
+    {
+        return;
+    }
+
+    if (classIdx >= NumClasses)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    theBlock->next = m_freeLists[classIdx];
+    m_freeLists[classIdx] = theBlock;
+    m_outstanding--;
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,108 @@
+/**
+ * \file FramePool.h
+ * \brief Contains the definition of the \c FramePool class.
+ * \date 2026-10-16 15:02:47
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_FRAMEPOOL_H_
+#define _FOUNDATION_COREKIT_FRAMEPOOL_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Recycling allocator for short-lived blocks of similar size.
+ *
+ * Requests are rounded up to a multiple of \c Granularity and served from
+ * one free list per size class. Memory is obtained from the heap a chunk
+ * of blocks at a time and is only returned when the pool is destroyed, so
+ * once a workload reaches its steady state, allocating and releasing
+ * blocks costs a couple of pointer updates. Requests larger than the
+ * largest size class go straight to the heap.
+ *
+ * Its main use is holding the frames of coroutines bound to a
+ * \c CoreKit::RunLoop (see \c CoreKit/Coroutine.h), so instances are not
+ * thread safe and are meant to be used from the thread running the loop.
+ */
+class FramePool
+{
+public:
+    /**
+     * \brief Size, in bytes, by which size classes differ.
+     */
+    static const size_t Granularity = 64u;
+
+    /**
+     * \brief Number of size classes.
+     */
+    static const unsigned NumClasses = 16u;
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    FreeBlock *m_freeLists[NumClasses];
+    std::vector< void* > m_chunks;
+    size_t m_outstanding;
+    size_t m_heapFallbacks;
+
+    FramePool(FramePool const& other);
+    FramePool& operator=(FramePool const& other);
+
+public:
+    /**
+     * \brief Default constructor.
+     */
+    FramePool();
+
+    /**
+     * \brief Destructor.
+     *
+     * Releases all chunks back to the heap. Blocks still handed out become
+     * invalid.
+     */
+    ~FramePool();
+
+    /**
+     * \brief Obtain a block of memory.
+     *
+     * \param[in] size - Number of bytes needed.
+     *
+     * \return Block suitably aligned for any fundamental type.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * \brief Give back a block obtained from \c allocate().
+     *
+     * \param[in] block - Block to give back.
+     * \param[in] size - Size originally requested for the block.
+     */
+    void release(void *block, size_t size);
+
+    /**
+     * \brief Count the blocks handed out and not yet given back.
+     *
+     * \return Number of outstanding blocks.
+     */
+    inline size_t outstanding() const { return m_outstanding; }
+
+    /**
+     * \brief Count the requests too large for the pool.
+     *
+     * \return Number of requests served directly by the heap.
+     */
+    inline size_t heapFallbacks() const { return m_heapFallbacks; }
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_FRAMEPOOL_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,297 @@
+/**
+ * \file FrameScheduler.cpp
+ * \brief Contains the implementation of the \c FrameScheduler class.
+ * \date 2026-10-16 17:58:40
+ * \author Rolando J. Nieves
+ */
+
+#include <time.h>
+#include <cmath>
+
+#include <CoreKit/PreconditionNotMetException.h>
+
+#include "FrameScheduler.h"
+
+#define RF_CK_FSCH_NS_PER_SEC (1000000000.0)
+#define RF_CK_FSCH_RATE_TOLERANCE (1.0e-6)
+
+
+namespace CoreKit
+{
+
+FrameScheduler::Configuration::Configuration():
+    minorFrameRate(0.0),
+    minorFramesPerMajor(1u),
+    frameBudget(0.0)
+{
+
+}
+
+
+FrameScheduler::FrameScheduler():
+    m_frameBudget(0u),
+    m_nextRateGroupId(0),
+    m_minorFrame(0u),
+    m_frameDue(false),
+    m_inFrame(false),
+    m_runningGroups(false),
+    m_frameStartCpu(0u),
+    m_statistics()
+{
+
+}
+
+
+uint64_t
+FrameScheduler::threadCpuNow()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000uLL) + static_cast<uint64_t>(now.tv_nsec);
+}
+
+
+void
+FrameScheduler::setConfiguration(Configuration const& config)
+{
+    if (!m_rateGroups.empty())
+    {
+        throw PreconditionNotMetException("Can not change the frame layout once rate groups were added.");
+    }
+    if (0u == config.minorFramesPerMajor)
+    {
+        throw PreconditionNotMetException("Can not have major frames without minor frames.");
+    }
+
+    m_configuration = config;
+    if (config.frameBudget > 0.0)
+    {
+        m_frameBudget = static_cast<uint64_t>(config.frameBudget * RF_CK_FSCH_NS_PER_SEC);
+    }
+    else if (config.minorFrameRate > 0.0)
+    {
+        m_frameBudget = static_cast<uint64_t>(RF_CK_FSCH_NS_PER_SEC / config.minorFrameRate);
+    }
+    else
+    {
+        m_frameBudget = 0u;
+    }
+}
+
+
+int
+FrameScheduler::addRateGroup(double rateHz, Task task, double budget, unsigned offset)
+{
+    RateGroup newGroup;
+    double periodFrames = 0.0;
+    std::vector< RateGroup >::iterator insertPos;
+
+    if (m_runningGroups)
+    {
+        throw PreconditionNotMetException("Can not change rate groups while they run.");
+    }
+    if ((m_configuration.minorFrameRate <= 0.0) || (rateHz <= 0.0))
+    {
+        throw PreconditionNotMetException("Can not add a rate group without a known minor frame rate.");
+    }
+
+    periodFrames = m_configuration.minorFrameRate / rateHz;
+    newGroup.divisor = static_cast<unsigned>(std::lround(periodFrames));
+    if ((0u == newGroup.divisor) ||
+        (std::fabs(periodFrames - newGroup.divisor) > (RF_CK_FSCH_RATE_TOLERANCE * periodFrames)))
+    {
+        throw PreconditionNotMetException("Can not run a rate group at a rate that does not divide the minor frame rate.");
+    }
+    if (offset >= newGroup.divisor)
+    {
+        throw PreconditionNotMetException("Can not offset a rate group past its own period.");
+    }
+
+    newGroup.id = m_nextRateGroupId++;
+    newGroup.offset = offset;
+    newGroup.budget = static_cast<uint64_t>(budget * RF_CK_FSCH_NS_PER_SEC);
+    newGroup.task = std::move(task);
+    newGroup.lastCpu = 0u;
+    newGroup.maxCpu = 0u;
+
+    /*
+     * Keep the groups sorted fastest first; among equals, the newest goes
+     * last, so the order within a frame never changes.
+     */
+    insertPos = m_rateGroups.begin();
+    while ((insertPos != m_rateGroups.end()) && (insertPos->divisor <= newGroup.divisor))
+    {
+        ++insertPos;
+    }
+    m_rateGroups.insert(insertPos, std::move(newGroup));
+
+    return m_nextRateGroupId - 1;
+}
+
+
+void
+FrameScheduler::removeRateGroup(int rateGroupId)
+{
+    if (m_runningGroups)
+    {
+        throw PreconditionNotMetException("Can not change rate groups while they run.");
+    }
+
+    for (std::vector< RateGroup >::iterator aGroup = m_rateGroups.begin(); aGroup != m_rateGroups.end(); ++aGroup)
+    {
+        if (aGroup->id == rateGroupId)
+        {
+            m_rateGroups.erase(aGroup);
+            break;
+        }
+    }
+}
+
+
+void
+FrameScheduler::addOverrunCallback(OverrunCallback overrunCb)
+{
+    m_overrunCallbacks.push_back(std::move(overrunCb));
+}
+
+
+void
+FrameScheduler::beginFrame(uint64_t framesReleased)
+{
+    m_frameDue = (framesReleased > 0u);
+    m_inFrame = true;
+    m_frameStartCpu = FrameScheduler::threadCpuNow();
+
+    if (!m_frameDue)
+    {
+        return;
+    }
+
+    m_statistics.minorFrames += framesReleased;
+    m_minorFrame = m_statistics.minorFrames - 1u;
+
+    if (framesReleased > 1u)
+    {
+        Overrun missed;
+
+        missed.kind = Overrun::OV_MISSED_FRAMES;
+        missed.minorFrame = m_minorFrame;
+        missed.rateGroup = -1;
+        missed.used = framesReleased - 1u;
+        missed.budget = 0u;
+        m_statistics.missedFrames += framesReleased - 1u;
+        m_pendingOverruns.push_back(missed);
+    }
+}
+
+
+void
+FrameScheduler::runRateGroups()
+{
+    if (!m_frameDue)
+    {
+        return;
+    }
+
+    m_runningGroups = true;
+    try
+    {
+        for (RateGroup& aGroup : m_rateGroups)
+        {
+            uint64_t groupStartCpu = 0u;
+
+            if ((m_minorFrame % aGroup.divisor) != aGroup.offset)
+            {
+                continue;
+            }
+
+            groupStartCpu = FrameScheduler::threadCpuNow();
+            aGroup.task();
+            aGroup.lastCpu = FrameScheduler::threadCpuNow() - groupStartCpu;
+            if (aGroup.lastCpu > aGroup.maxCpu)
+            {
+                aGroup.maxCpu = aGroup.lastCpu;
+            }
+
+            if ((aGroup.budget > 0u) && (aGroup.lastCpu > aGroup.budget))
+            {
+                Overrun groupOverrun;
+
+                groupOverrun.kind = Overrun::OV_RATE_GROUP;
+                groupOverrun.minorFrame = m_minorFrame;
+                groupOverrun.rateGroup = aGroup.id;
+                groupOverrun.used = aGroup.lastCpu;
+                groupOverrun.budget = aGroup.budget;
+                m_statistics.rateGroupOverruns++;
+                m_pendingOverruns.push_back(groupOverrun);
+            }
+        }
+    }
+    catch (...)
+    {
+        m_runningGroups = false;
+        throw;
+    }
+    m_runningGroups = false;
+}
+
+
+void
+FrameScheduler::endFrame()
+{
+    uint64_t frameCpu = 0u;
+    std::vector< Overrun > reported;
+
+    if (!m_inFrame)
+    {
+        return;
+    }
+    m_inFrame = false;
+
+    frameCpu = FrameScheduler::threadCpuNow() - m_frameStartCpu;
+    if (m_frameDue)
+    {
+        m_statistics.lastFrameCpu = frameCpu;
+        if (frameCpu > m_statistics.maxFrameCpu)
+        {
+            m_statistics.maxFrameCpu = frameCpu;
+        }
+
+        if ((m_frameBudget > 0u) && (frameCpu > m_frameBudget))
+        {
+            Overrun frameOverrun;
+
+            frameOverrun.kind = Overrun::OV_FRAME;
+            frameOverrun.minorFrame = m_minorFrame;
+            frameOverrun.rateGroup = -1;
+            frameOverrun.used = frameCpu;
+            frameOverrun.budget = m_frameBudget;
+            m_statistics.frameOverruns++;
+            m_pendingOverruns.push_back(frameOverrun);
+        }
+    }
+
+    if (m_pendingOverruns.empty())
+    {
+        return;
+    }
+
+    /*
+     * Callbacks run after the frame time was taken, so the time they take
+     * is not charged to the frame they report on.
+     */
+    reported.swap(m_pendingOverruns);
+    for (Overrun const& anOverrun : reported)
+    {
+        for (OverrunCallback& aCallback : m_overrunCallbacks)
+        {
+            aCallback(anOverrun);
+        }
+    }
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,280 @@
+/**
+ * \file FrameScheduler.h
+ * \brief Contains the definition of the \c FrameScheduler class.
+ * \date 2026-10-16 17:58:40
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_FRAMESCHEDULER_H_
+#define _FOUNDATION_COREKIT_FRAMESCHEDULER_H_
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Cyclic executive driven by the frames of a \c SynchronizedRunLoop.
+ *
+ * Every frame released by the external scheduler is one \e minor frame;
+ * a fixed number of minor frames make up a \e major frame. Work is
+ * registered as rate groups, each running at an integer divisor of the
+ * minor frame rate (e.g. 100, 50 and 10 Hz groups in a 100 Hz frame).
+ * Within a frame, groups run after the input sources have been serviced,
+ * fastest first and, among groups of the same rate, in the order they were
+ * added, so every major frame executes the same sequence.\par
+ *
+ * The thread CPU time consumed by each frame, and by each rate group, is
+ * measured against a budget. Going over budget, and missing frames
+ * altogether, is reported to the registered overrun callbacks once the
+ * frame is over.
+ */
+class FrameScheduler
+{
+public:
+    /**
+     * \brief Work run by a rate group.
+     */
+    typedef std::function< void() > Task;
+
+    /**
+     * \brief Frame layout settings.
+     */
+    struct Configuration
+    {
+        /**
+         * \brief Rate, in Hz, at which the external scheduler releases
+         *        frames; zero if unknown, which disables rate groups and the
+         *        default frame budget.
+         */
+        double minorFrameRate;
+        /**
+         * \brief Minor frames per major frame.
+         */
+        unsigned minorFramesPerMajor;
+        /**
+         * \brief CPU time, in seconds, a minor frame may use; zero uses the
+         *        whole minor frame period.
+         */
+        double frameBudget;
+
+        Configuration();
+    };
+
+    /**
+     * \brief Description of a budget overrun or of missed frames.
+     */
+    struct Overrun
+    {
+        enum Kind
+        {
+            /**
+             * \brief A minor frame used more CPU time than its budget.
+             */
+            OV_FRAME = 0,
+            /**
+             * \brief A rate group used more CPU time than its budget.
+             */
+            OV_RATE_GROUP,
+            /**
+             * \brief Frames were released while the previous one was still
+             *        running, so they were skipped.
+             */
+            OV_MISSED_FRAMES
+        };
+
+        /**
+         * \brief What went over.
+         */
+        Kind kind;
+        /**
+         * \brief Minor frame number, counted from the first frame.
+         */
+        uint64_t minorFrame;
+        /**
+         * \brief Rate group identifier, for \c OV_RATE_GROUP; -1 otherwise.
+         */
+        int rateGroup;
+        /**
+         * \brief CPU time used, in nanoseconds; for \c OV_MISSED_FRAMES, the
+         *        number of frames skipped.
+         */
+        uint64_t used;
+        /**
+         * \brief Budget, in nanoseconds; zero for \c OV_MISSED_FRAMES.
+         */
+        uint64_t budget;
+    };
+
+    /**
+     * \brief Callback told about overruns.
+     */
+    typedef std::function< void(Overrun const&) > OverrunCallback;
+
+    /**
+     * \brief Counters kept by the scheduler.
+     */
+    struct Statistics
+    {
+        /**
+         * \brief Minor frames started, including the missed ones.
+         */
+        uint64_t minorFrames;
+        /**
+         * \brief Minor frames skipped because they were missed.
+         */
+        uint64_t missedFrames;
+        /**
+         * \brief Minor frames that went over budget.
+         */
+        uint64_t frameOverruns;
+        /**
+         * \brief Rate group runs that went over budget.
+         */
+        uint64_t rateGroupOverruns;
+        /**
+         * \brief CPU time used by the last minor frame, in nanoseconds.
+         */
+        uint64_t lastFrameCpu;
+        /**
+         * \brief Largest CPU time used by a minor frame, in nanoseconds.
+         */
+        uint64_t maxFrameCpu;
+    };
+
+private:
+    struct RateGroup
+    {
+        int id;
+        unsigned divisor;
+        unsigned offset;
+        uint64_t budget;
+        Task task;
+        uint64_t lastCpu;
+        uint64_t maxCpu;
+    };
+
+    Configuration m_configuration;
+    uint64_t m_frameBudget;
+    std::vector< RateGroup > m_rateGroups;
+    std::vector< OverrunCallback > m_overrunCallbacks;
+    std::vector< Overrun > m_pendingOverruns;
+    int m_nextRateGroupId;
+    uint64_t m_minorFrame;
+    bool m_frameDue;
+    bool m_inFrame;
+    bool m_runningGroups;
+    uint64_t m_frameStartCpu;
+    Statistics m_statistics;
+
+    static uint64_t threadCpuNow();
+
+public:
+    FrameScheduler();
+
+    /**
+     * \brief Access the frame layout.
+     *
+     * \return Current settings.
+     */
+    inline Configuration const& configuration() const { return m_configuration; }
+
+    /**
+     * \brief Change the frame layout.
+     *
+     * \param[in] config - New settings.
+     *
+     * \throw PreconditionNotMetException if rate groups were already added,
+     *        or if \c minorFramesPerMajor is zero.
+     */
+    void setConfiguration(Configuration const& config);
+
+    /**
+     * \brief Add a rate group.
+     *
+     * \param[in] rateHz - Rate, in Hz; must divide the minor frame rate.
+     * \param[in] task - Work to run.
+     * \param[in] budget - CPU time, in seconds, each run may use; zero for
+     *            no limit.
+     * \param[in] offset - Minor frame, within the group's period, the group
+     *            runs in; used to spread slow groups across frames.
+     *
+     * \return Identifier of the rate group.
+     *
+     * \throw PreconditionNotMetException if called from a rate group, if
+     *        the minor frame rate is unknown, if \c rateHz does not divide
+     *        it, or if \c offset is not less than the group's period in
+     *        minor frames.
+     */
+    int addRateGroup(double rateHz, Task task, double budget = 0.0, unsigned offset = 0u);
+
+    /**
+     * \brief Remove a rate group.
+     *
+     * \param[in] rateGroupId - Identifier returned by \c addRateGroup().
+     *
+     * \throw PreconditionNotMetException if called from a rate group.
+     */
+    void removeRateGroup(int rateGroupId);
+
+    /**
+     * \brief Register a callback told about overruns.
+     *
+     * \param[in] overrunCb - Callback to add.
+     */
+    void addOverrunCallback(OverrunCallback overrunCb);
+
+    /**
+     * \brief Access the minor frame number within the current major frame.
+     *
+     * \return Minor frame index, less than \c minorFramesPerMajor.
+     */
+    inline unsigned minorFrameIndex() const { return static_cast<unsigned>(m_minorFrame % m_configuration.minorFramesPerMajor); }
+
+    /**
+     * \brief Access the number of the current minor frame.
+     *
+     * \return Minor frames elapsed since the first one.
+     */
+    inline uint64_t minorFrame() const { return m_minorFrame; }
+
+    /**
+     * \brief Access the number of the current major frame.
+     *
+     * \return Major frames elapsed since the first one.
+     */
+    inline uint64_t majorFrame() const { return m_minorFrame / m_configuration.minorFramesPerMajor; }
+
+    /**
+     * \brief Access the counters kept by the scheduler.
+     *
+     * \return Counters.
+     */
+    inline Statistics const& statistics() const { return m_statistics; }
+
+    /**
+     * \brief Start accounting a frame; called by the run loop.
+     *
+     * \param[in] framesReleased - Value returned by \c FrameSync::wait();
+     *            zero if no frame was released.
+     */
+    void beginFrame(uint64_t framesReleased);
+
+    /**
+     * \brief Run the rate groups due in the current frame; called by the run loop.
+     */
+    void runRateGroups();
+
+    /**
+     * \brief Finish accounting a frame and report overruns; called by the run loop.
+     */
+    void endFrame();
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_FRAMESCHEDULER_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
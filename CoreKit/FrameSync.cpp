@@ -0,0 +1,348 @@
+/**
+ * \file FrameSync.cpp
+ * \brief Contains the implementation of the \c FrameSync class and its variants.
+ * \date 2026-10-16 17:58:40
+ * \author Rolando J. Nieves
+ */
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+
+#include <CoreKit/InvalidInputException.h>
+#include <CoreKit/OsErrorException.h>
+
+#include "FrameSync.h"
+
+#define RF_CK_FS_SHM_SIZE (sizeof(uint32_t))
+
+
+namespace CoreKit
+{
+
+FrameSync::FrameSync():
+    m_interrupted(false)
+{
+
+}
+
+
+FrameSync::~FrameSync()
+{
+
+}
+
+
+FrameSync*
+FrameSync::open(Type syncType, std::string const& name)
+{
+    FrameSync *result = nullptr;
+
+    switch (syncType)
+    {
+    case FS_EVENTFD:
+        {
+            char *nameEnd = nullptr;
+            long fdNumber = strtol(name.c_str(), &nameEnd, 10);
+
+            if (name.empty() || (*nameEnd != '\0') || (fdNumber < 0) || (fdNumber > INT_MAX))
+            {
+                throw InvalidInputException("eventfd file descriptor", name);
+            }
+            result = new EventFdFrameSync(static_cast<int>(fdNumber), true);
+        }
+        break;
+
+    case FS_FUTEX:
+        result = new FutexFrameSync(name);
+        break;
+
+    case FS_SEMAPHORE:
+    default:
+        {
+            sem_t *theSemaphore = sem_open(name.c_str(), O_CREAT, S_IRUSR | S_IWUSR, 0);
+
+            if (SEM_FAILED == theSemaphore)
+            {
+                throw OsErrorException("sem_open", errno);
+            }
+            result = new SemaphoreFrameSync(theSemaphore, true);
+        }
+        break;
+    }
+
+    return result;
+}
+
+
+SemaphoreFrameSync::SemaphoreFrameSync(sem_t *semaphore, bool owned):
+    m_semaphore(semaphore),
+    m_owned(owned)
+{
+
+}
+
+
+SemaphoreFrameSync::~SemaphoreFrameSync()
+{
+    if (m_owned)
+    {
+        sem_close(m_semaphore);
+    }
+    m_semaphore = nullptr;
+}
+
+
+uint64_t
+SemaphoreFrameSync::wait()
+{
+    if (m_interrupted.load(std::memory_order_acquire))
+    {
+        return 0u;
+    }
+    if (sem_wait(m_semaphore) != 0)
+    {
+        if (errno != EINTR)
+        {
+            throw OsErrorException("sem_wait", errno);
+        }
+        return 0u;
+    }
+
+    return m_interrupted.load(std::memory_order_acquire) ? 0u : 1u;
+}
+
+
+void
+SemaphoreFrameSync::release()
+{
+    if (sem_post(m_semaphore) != 0)
+    {
+        throw OsErrorException("sem_post", errno);
+    }
+}
+
+
+void
+SemaphoreFrameSync::interrupt()
+{
+    m_interrupted.store(true, std::memory_order_release);
+    sem_post(m_semaphore);
+}
+
+
+EventFdFrameSync::EventFdFrameSync():
+    m_fd(-1),
+    m_owned(true)
+{
+    m_fd = eventfd(0u, EFD_CLOEXEC);
+    if (-1 == m_fd)
+    {
+        throw OsErrorException("eventfd", errno);
+    }
+}
+
+
+EventFdFrameSync::EventFdFrameSync(int fd, bool owned):
+    m_fd(fd),
+    m_owned(owned)
+{
+
+}
+
+
+EventFdFrameSync::~EventFdFrameSync()
+{
+    if (m_owned && (m_fd != -1))
+    {
+        close(m_fd);
+    }
+    m_fd = -1;
+}
+
+
+uint64_t
+EventFdFrameSync::wait()
+{
+    uint64_t result = 0u;
+
+    if (m_interrupted.load(std::memory_order_acquire))
+    {
+        return 0u;
+    }
+    if (::read(m_fd, &result, sizeof(result)) != static_cast<ssize_t>(sizeof(result)))
+    {
+        if (errno != EINTR)
+        {
+            throw OsErrorException("read", errno);
+        }
+        return 0u;
+    }
+
+    return m_interrupted.load(std::memory_order_acquire) ? 0u : result;
+}
+
+
+void
+EventFdFrameSync::release()
+{
+    uint64_t oneFrame = 1u;
+
+    if (::write(m_fd, &oneFrame, sizeof(oneFrame)) != static_cast<ssize_t>(sizeof(oneFrame)))
+    {
+        throw OsErrorException("write", errno);
+    }
+}
+
+
+void
+EventFdFrameSync::interrupt()
+{
+    uint64_t oneFrame = 1u;
+
+    m_interrupted.store(true, std::memory_order_release);
+    if (::write(m_fd, &oneFrame, sizeof(oneFrame)) != static_cast<ssize_t>(sizeof(oneFrame)))
+    {
+        /*
+         * The write only fails with the counter about to overflow, which
+         * wakes the reader all the same.
+         */
+    }
+}
+
+
+FutexFrameSync::FutexFrameSync(std::string const& shmName):
+    m_frameCount(nullptr),
+    m_lastSeen(0u),
+    m_waiting(false)
+{
+    int shmFd = shm_open(shmName.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    struct stat shmStat;
+    void *theMapping = MAP_FAILED;
+
+    if (-1 == shmFd)
+    {
+        throw OsErrorException("shm_open", errno);
+    }
+
+    /*
+     * Only grow the object; if the scheduler created it first, its count
+     * must survive.
+     */
+    if (fstat(shmFd, &shmStat) != 0)
+    {
+        int savedErrno = errno;
+
+        close(shmFd);
+        throw OsErrorException("fstat", savedErrno);
+    }
+    if ((static_cast<size_t>(shmStat.st_size) < RF_CK_FS_SHM_SIZE) && (ftruncate(shmFd, RF_CK_FS_SHM_SIZE) != 0))
+    {
+        int savedErrno = errno;
+
+        close(shmFd);
+        throw OsErrorException("ftruncate", savedErrno);
+    }
+
+    theMapping = mmap(nullptr, RF_CK_FS_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    close(shmFd);
+    if (MAP_FAILED == theMapping)
+    {
+        throw OsErrorException("mmap", errno);
+    }
+
+    m_frameCount = static_cast<std::atomic< uint32_t >*>(theMapping);
+    m_lastSeen = m_frameCount->load(std::memory_order_acquire);
+}
+
+
+FutexFrameSync::~FutexFrameSync()
+{
+    if (m_frameCount != nullptr)
+    {
+        munmap(m_frameCount, RF_CK_FS_SHM_SIZE);
+    }
+    m_frameCount = nullptr;
+}
+
+
+uint64_t
+FutexFrameSync::wait()
+{
+    uint32_t frameCount = m_frameCount->load(std::memory_order_acquire);
+    uint64_t result = 0u;
+
+    /*
+     * The kernel only puts this thread to sleep if the count still matches,
+     * so a frame released in between is never missed. A wake up that leaves
+     * the count alone came from interrupt(), here or in another process;
+     * unless it was meant for this one, go back to sleep.
+     */
+    m_waiting.store(true, std::memory_order_seq_cst);
+    while ((frameCount == m_lastSeen) && !m_interrupted.load(std::memory_order_seq_cst))
+    {
+        if (syscall(SYS_futex, m_frameCount, FUTEX_WAIT, m_lastSeen, nullptr, nullptr, 0) != 0)
+        {
+            if (EINTR == errno)
+            {
+                break;
+            }
+            if (errno != EAGAIN)
+            {
+                m_waiting.store(false, std::memory_order_seq_cst);
+                throw OsErrorException("futex", errno);
+            }
+        }
+        frameCount = m_frameCount->load(std::memory_order_acquire);
+    }
+    m_waiting.store(false, std::memory_order_seq_cst);
+    if ((frameCount == m_lastSeen) || m_interrupted.load(std::memory_order_acquire))
+    {
+        return 0u;
+    }
+
+    result = static_cast<uint32_t>(frameCount - m_lastSeen);
+    m_lastSeen = frameCount;
+
+    return result;
+}
+
+
+void
+FutexFrameSync::release()
+{
+    m_frameCount->fetch_add(1u, std::memory_order_release);
+    if (syscall(SYS_futex, m_frameCount, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0) == -1)
+    {
+        throw OsErrorException("futex", errno);
+    }
+}
+
+
+void
+FutexFrameSync::interrupt()
+{
+    m_interrupted.store(true, std::memory_order_seq_cst);
+
+    /*
+     * The count can not be touched without releasing a frame to everyone,
+     * so a waiter that checked the flag just before it was raised would
+     * still go to sleep. Keep waking the futex until the waiter is out.
+     */
+    do
+    {
+        syscall(SYS_futex, m_frameCount, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    } while (m_waiting.load(std::memory_order_seq_cst) && (sched_yield() == 0));
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
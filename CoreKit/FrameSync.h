@@ -0,0 +1,218 @@
+/**
+ * \file FrameSync.h
+ * \brief Contains the definition of the \c FrameSync class and its variants.
+ * \date 2026-10-16 17:58:40
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_FRAMESYNC_H_
+#define _FOUNDATION_COREKIT_FRAMESYNC_H_
+
+#include <semaphore.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Object an external scheduler uses to release frames to a process.
+ *
+ * A \c CoreKit::SynchronizedRunLoop waits on one of these at the top of
+ * every iteration, so the external scheduler decides when each frame
+ * starts. The variants trade compatibility for wake-up latency:
+ *
+ * - \c SemaphoreFrameSync: a named POSIX semaphore; the historical choice.
+ * - \c EventFdFrameSync: an \c eventfd inherited from the scheduler.
+ * - \c FutexFrameSync: a frame counter in POSIX shared memory, waited on
+ *   with a futex; a process that is late for a frame picks it up without
+ *   entering the kernel.
+ */
+class FrameSync
+{
+public:
+    /**
+     * \brief Available variants; see \c FrameSync::open().
+     */
+    enum Type
+    {
+        FS_SEMAPHORE = 0,
+        FS_EVENTFD,
+        FS_FUTEX
+    };
+
+    FrameSync();
+    virtual ~FrameSync();
+
+    /**
+     * \brief Block until the scheduler releases a frame.
+     *
+     * \return Number of frames released since the previous call; more than
+     *         one means frames were missed. Zero if the wait was interrupted
+     *         by a signal or by \c interrupt(), or if the variant can not
+     *         tell.
+     *
+     * \throw OsErrorException if the underlying object fails.
+     */
+    virtual uint64_t wait() = 0;
+
+    /**
+     * \brief Release one frame; called by the scheduler side.
+     *
+     * \throw OsErrorException if the underlying object fails.
+     */
+    virtual void release() = 0;
+
+    /**
+     * \brief Make the current \c wait(), and every later one, return right away.
+     *
+     * Called from any thread when the waiting run loop is asked to
+     * terminate. No frame is released to other processes sharing the
+     * object. Errors are ignored.
+     */
+    virtual void interrupt() = 0;
+
+    /**
+     * \brief Open, or create, a synchronization object by name.
+     *
+     * \param[in] syncType - Variant to use.
+     * \param[in] name - For \c FS_SEMAPHORE, the semaphore name; for
+     *            \c FS_FUTEX, the shared memory object name; for
+     *            \c FS_EVENTFD, the number of an inherited \c eventfd file
+     *            descriptor.
+     *
+     * \return New object; the caller owns it.
+     *
+     * \throw OsErrorException if the object can not be opened.
+     * \throw InvalidInputException if an \c eventfd number is malformed.
+     */
+    static FrameSync* open(Type syncType, std::string const& name);
+
+protected:
+    std::atomic< bool > m_interrupted;
+};
+
+
+/**
+ * \brief Frame release through a POSIX semaphore.
+ *
+ * Every post of the semaphore releases one frame, so \c wait() reports one
+ * frame per call.
+ */
+class SemaphoreFrameSync : public FrameSync
+{
+public:
+    /**
+     * \brief Wrap a semaphore.
+     *
+     * \param[in] semaphore - Semaphore to wait on.
+     * \param[in] owned - \c true if the semaphore was obtained with
+     *            \c sem_open() and should be closed by the destructor.
+     */
+    SemaphoreFrameSync(sem_t *semaphore, bool owned);
+
+    virtual ~SemaphoreFrameSync();
+
+    virtual uint64_t wait();
+    virtual void release();
+    virtual void interrupt();
+
+private:
+    sem_t *m_semaphore;
+    bool m_owned;
+
+    SemaphoreFrameSync(SemaphoreFrameSync const& other);
+    SemaphoreFrameSync& operator=(SemaphoreFrameSync const& other);
+};
+
+
+/**
+ * \brief Frame release through an \c eventfd.
+ *
+ * The scheduler adds one to the counter per frame; \c wait() reads and
+ * clears it, so it reports frames missed while the process was busy.
+ */
+class EventFdFrameSync : public FrameSync
+{
+public:
+    /**
+     * \brief Create a new \c eventfd; mostly useful in-process and for tests.
+     *
+     * \throw OsErrorException if the \c eventfd can not be created.
+     */
+    EventFdFrameSync();
+
+    /**
+     * \brief Wrap an existing \c eventfd, normally inherited from the scheduler.
+     *
+     * \param[in] fd - Blocking \c eventfd file descriptor.
+     * \param[in] owned - \c true if the destructor should close \c fd.
+     */
+    EventFdFrameSync(int fd, bool owned);
+
+    virtual ~EventFdFrameSync();
+
+    virtual uint64_t wait();
+    virtual void release();
+    virtual void interrupt();
+
+    /**
+     * \brief Access the file descriptor, e.g. to hand it to the scheduler.
+     *
+     * \return \c eventfd file descriptor.
+     */
+    inline int fileDescriptor() const { return m_fd; }
+
+private:
+    int m_fd;
+    bool m_owned;
+
+    EventFdFrameSync(EventFdFrameSync const& other);
+    EventFdFrameSync& operator=(EventFdFrameSync const& other);
+};
+
+
+/**
+ * \brief Frame release through a futex in POSIX shared memory.
+ *
+ * The shared memory object holds a 32-bit count of released frames. The
+ * scheduler increments it and wakes the futex; \c wait() returns as soon
+ * as the count moves past the last one seen, without a system call if the
+ * frame was already released. Frames released before the object was
+ * opened are not reported. \c interrupt() wakes the futex, which wakes
+ * every process waiting on it; those that find the count unchanged go back
+ * to sleep.
+ */
+class FutexFrameSync : public FrameSync
+{
+public:
+    /**
+     * \brief Open, or create, the shared memory object.
+     *
+     * \param[in] shmName - Name given to \c shm_open().
+     *
+     * \throw OsErrorException if the object can not be opened or mapped.
+     */
+    explicit FutexFrameSync(std::string const& shmName);
+
+    virtual ~FutexFrameSync();
+
+    virtual uint64_t wait();
+    virtual void release();
+    virtual void interrupt();
+
+private:
+    std::atomic< uint32_t > *m_frameCount;
+    uint32_t m_lastSeen;
+    std::atomic< bool > m_waiting;
+
+    FutexFrameSync(FutexFrameSync const& other);
+    FutexFrameSync& operator=(FutexFrameSync const& other);
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_FRAMESYNC_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
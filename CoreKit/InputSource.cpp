@@ -16,7 +16,8 @@ using CoreKit::InterruptListener;
 uint8_t InputSource::NextDefaultPriority = 128u;
 
 InputSource::InputSource()
-: m_relativePriority(InputSource::NextDefaultPriority)
+: m_relativePriority(InputSource::NextDefaultPriority), m_edgeTriggered(false),
+  m_preReadMode(PRM_NONE)
 {
 	if (InputSource::NextDefaultPriority < 255u)
 	{
@@ -26,7 +27,8 @@ InputSource::InputSource()
 
 
 InputSource::InputSource(uint8_t relativePriority)
-: m_relativePriority(relativePriority)
+: m_relativePriority(relativePriority), m_edgeTriggered(false),
+  m_preReadMode(PRM_NONE)
 {
 
 }
@@ -55,3 +57,10 @@ void InputSource::fireCallback()
 {
 
 }
+
+
+void InputSource::dataAvailable(PreReadData const& /* readData */)
+{
+
+}
+
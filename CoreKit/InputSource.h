@@ -8,11 +8,42 @@
 #define EA_76480D69_0A8C_42b9_BE14_C8681CB7F96D__INCLUDED_
 
 #include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
 
 #include "InterruptListener.h"
 
 namespace CoreKit
 {
+	/**
+	 * \brief Data Read on Behalf of an \c InputSource by its \c RunLoop
+	 *
+	 * \see InputSource::setPreReadMode()
+	 */
+	struct PreReadData
+	{
+		/**
+		 * \brief Bytes Read; \c NULL Unless \c result is Positive
+		 */
+		uint8_t const *data;
+		/**
+		 * \brief Number of Bytes Read; Zero at End of File, or a Negated \c errno Value
+		 */
+		ssize_t result;
+		/**
+		 * \brief Address of the Sender; Only Set in \c PRM_MESSAGE Mode
+		 */
+		struct sockaddr const *peerAddress;
+		/**
+		 * \brief Size of \c peerAddress, in Bytes
+		 */
+		socklen_t peerAddressLength;
+		/**
+		 * \brief \c MSG_* Flags Reported by the Read, Such as \c MSG_TRUNC
+		 */
+		int messageFlags;
+	};
+
 	/**
 	 * \brief Interface that Defines a \c RunLoop Input Source
 	 *
@@ -56,6 +87,82 @@ namespace CoreKit
 		 * \brief Provide the Relative Priority of this Input Source
 		 */
 		inline uint8_t relativePriority() const { return m_relativePriority; }
+		/**
+		 * \brief Determine Whether this Input Source Uses Edge-Triggered Notification
+		 *
+		 * \return \c true if the \c RunLoop should register this input source's
+		 *         file descriptor with \c EPOLLET; \c false (the default) for
+		 *         level-triggered notification.
+		 */
+		inline bool edgeTriggered() const { return m_edgeTriggered; }
+		/**
+		 * \brief Request Edge-Triggered Notification for this Input Source
+		 *
+		 * With edge-triggered notification the \c RunLoop is only told about
+		 * \e new activity on the file descriptor, which spares it from being
+		 * woken up repeatedly for input that a busy handler has not gotten
+		 * around to yet. The price is a stricter contract for
+		 * \c fireCallback(): every invocation must drain the file descriptor
+		 * (i.e., keep reading until the read call fails with \c EAGAIN or
+		 * \c EWOULDBLOCK). Any input left behind is not reported again until
+		 * more input arrives, which may be never. The file descriptor must
+		 * therefore be in non-blocking mode.
+		 *
+		 * \note
+		 * The setting is consulted when the input source is registered with a
+		 * \c RunLoop; changing it afterwards has no effect until the input
+		 * source is registered again.
+		 *
+		 * \param edgeTriggered \c true to request \c EPOLLET registration;
+		 *                      \c false for level-triggered registration.
+		 */
+		inline void setEdgeTriggered(bool edgeTriggered) { m_edgeTriggered = edgeTriggered; }
+
+		/**
+		 * \brief Ways a \c RunLoop May Read Input on Behalf of an Input Source
+		 */
+		enum PreReadMode
+		{
+			/**
+			 * \brief The Input Source Reads its Own Input in \c fireCallback()
+			 */
+			PRM_NONE,
+			/**
+			 * \brief The \c RunLoop Reads Plain Data, Like \c recv() or \c read()
+			 */
+			PRM_DATA,
+			/**
+			 * \brief The \c RunLoop Reads Whole Datagrams Along with the Sender Address
+			 */
+			PRM_MESSAGE
+		};
+		/**
+		 * \brief Determine How the \c RunLoop Should Read Input for this Input Source
+		 *
+		 * \return Pre-read mode requested via \c setPreReadMode().
+		 */
+		inline PreReadMode preReadMode() const { return m_preReadMode; }
+		/**
+		 * \brief Let the \c RunLoop Read Input on Behalf of this Input Source
+		 *
+		 * \c RunLoop instances running on the \c io_uring backend can read
+		 * input as soon as it arrives and hand it to \c dataAvailable(),
+		 * saving the system call \c fireCallback() would otherwise make.
+		 * Input sources that opt in must still implement \c fireCallback(),
+		 * which remains in use with the \c epoll() backend. The \c RunLoop
+		 * reads into buffers of \c RunLoop::Configuration::uringBufferSize
+		 * bytes; longer datagrams are truncated.
+		 *
+		 * \note
+		 * The setting is consulted when the input source is registered with a
+		 * \c RunLoop; changing it afterwards has no effect until the input
+		 * source is registered again.
+		 *
+		 * \param preReadMode How input should be read; \c PRM_NONE (the
+		 *                    default) to keep reading in \c fireCallback().
+		 */
+		inline void setPreReadMode(PreReadMode preReadMode) { m_preReadMode = preReadMode; }
+
 		/**
 		 * \brief Obtain the File Descriptor Associated with this \c InputSource
 		 *
@@ -73,10 +180,24 @@ namespace CoreKit
 		 * \brief Execute the Appropriate \c InterruptListener Callback in Response to Activity
 		 */
 		virtual void fireCallback();
+		/**
+		 * \brief Process Input Read on Behalf of this Input Source
+		 *
+		 * Invoked instead of \c fireCallback() when the \c RunLoop read the
+		 * input itself; see \c setPreReadMode().
+		 *
+		 * \param readData Outcome of the read; the data is only valid for the
+		 *                 duration of the call.
+		 */
+		virtual void dataAvailable(PreReadData const& readData);
 
 	private:
 		static uint8_t NextDefaultPriority;
 		uint8_t m_relativePriority;
+		bool m_edgeTriggered;
+		PreReadMode m_preReadMode;
+
+
 	};
 
 }
@@ -5,11 +5,14 @@
  * \author Rolando J. Nieves
  */
 
+#include <sys/signalfd.h>
+
 #include "InterruptListener.h"
 #include "InputSource.h"
 
 using CoreKit::InterruptListener;
 using CoreKit::InputSource;
+using CoreKit::TimerExpiration;
 
 
 
@@ -37,7 +40,20 @@ void InterruptListener::signalReceived(int signalNumber)
 }
 
 
+void InterruptListener::signalsReceived(struct signalfd_siginfo const* signalInfos, size_t /* count */)
+{
+    this->signalReceived(static_cast<int>(signalInfos[0].ssi_signo));
+}
+
+
+
 void InterruptListener::timerExpired(int timerId)
 {
 
 }
+
+
+void InterruptListener::timerExpired(int timerId, TimerExpiration const& /* expiration */)
+{
+    this->timerExpired(timerId);
+}
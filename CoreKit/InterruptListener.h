@@ -7,10 +7,51 @@
 #if !defined(EA_C0ED3862_AF69_4d0b_8DE4_3E456E13387B__INCLUDED_)
 #define EA_C0ED3862_AF69_4d0b_8DE4_3E456E13387B__INCLUDED_
 
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+struct signalfd_siginfo;
+
 namespace CoreKit
 {
 	class InputSource;
 
+	/**
+	 * \brief Details About a Single Timer Expiration Callback
+	 *
+	 * The \c TimerExpiration structure tells an \c InterruptListener how
+	 * many timer periods elapsed since its previous callback, and how late
+	 * the callback is being delivered relative to the time the timer was
+	 * scheduled to expire. Both times are expressed on the clock the timer
+	 * was created with.
+	 */
+	struct TimerExpiration
+	{
+		/**
+		 * \brief Number of Periods that Elapsed Since the Previous Callback
+		 *
+		 * This value is one whenever the listener keeps up with the timer.
+		 */
+		uint64_t expirations;
+		/**
+		 * \brief Number of Periods that Were Missed (\c expirations minus one)
+		 */
+		uint64_t overruns;
+		/**
+		 * \brief Time at Which the Most Recent Elapsed Period Was Scheduled to End
+		 */
+		struct timespec scheduled;
+		/**
+		 * \brief Time at Which the Expiration Was Processed
+		 */
+		struct timespec actual;
+		/**
+		 * \brief Difference, in Seconds, Between \c actual and \c scheduled
+		 */
+		double lateness;
+	};
+
 	/**
 	 * \brief Interface for Classes that Service \c RunLoop Interrupts.
 	 *
@@ -73,6 +114,21 @@ namespace CoreKit
 		 *                     application process.
 		 */
 		virtual void signalReceived(int signalNumber);
+		/**
+		 * \brief Interrupt Handling Method for a Batch of Process Signals
+		 *
+		 * A \c SignalInputSource drains every pending instance of its
+		 * signal with a single read, and reports them all, in the order
+		 * they were received, through this method. The default
+		 * implementation calls \c signalReceived() once for the whole
+		 * batch, so existing listeners need not change.
+		 *
+		 * \param signalInfos Details of each signal instance, as reported
+		 *                    by \c signalfd().
+		 * \param count Number of entries in \c signalInfos; at least one.
+		 */
+		virtual void signalsReceived(struct signalfd_siginfo const* signalInfos, size_t count);
+
 		/**
 		 * \brief Interrupt Handling Method for Timers
 		 *
@@ -83,6 +139,19 @@ namespace CoreKit
 		 * \param timerId Integer identifying the timer that expired.
 		 */
 		virtual void timerExpired(int timerId);
+		/**
+		 * \brief Interrupt Handling Method for Timers that Reports Timing Details
+		 *
+		 * Timers created by \c RunLoop call this overload, which lets
+		 * listeners that run control loops detect missed periods and late
+		 * callbacks. The default implementation simply calls
+		 * \c timerExpired(int), so existing listeners need not change.
+		 *
+		 * \param timerId Integer identifying the timer that expired.
+		 * \param expiration Overrun count and lateness of this expiration.
+		 */
+		virtual void timerExpired(int timerId, TimerExpiration const& expiration);
+
 
 	};
 
@@ -0,0 +1,456 @@
+/**
+ * \file IoUring.cpp
+ * \brief Contains the implementation of the \c IoUring class.
+ * \date 2026-10-16 15:48:12
+ * \author Rolando J. Nieves
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/time_types.h>
+#include <cstring>
+
+#include "OsErrorException.h"
+#include "IoUring.h"
+
+
+namespace CoreKit
+{
+
+const uint16_t IoUring::BufferGroup;
+
+
+static int ioUringSetup(unsigned entries, struct io_uring_params *params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+
+static int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+
+static int ioUringRegister(int ringFd, unsigned opcode, void *arg, unsigned numArgs)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, ringFd, opcode, arg, numArgs));
+}
+
+
+IoUring::IoUring(unsigned entries):
+    m_ringFd(-1),
+    m_sqRing(MAP_FAILED),
+    m_sqRingSize(0u),
+    m_cqRing(MAP_FAILED),
+    m_cqRingSize(0u),
+    m_sqes(nullptr),
+    m_sqesSize(0u),
+    m_sqHead(nullptr),
+    m_sqTail(nullptr),
+    m_sqMask(0u),
+    m_sqEntries(0u),
+    m_sqArray(nullptr),
+    m_sqFlags(nullptr),
+    m_sqLocalTail(0u),
+    m_sqSubmitted(0u),
+    m_cqHead(nullptr),
+    m_cqTail(nullptr),
+    m_cqMask(0u),
+    m_cqes(nullptr),
+    m_features(0u),
+    m_bufRing(nullptr),
+    m_bufRingSize(0u),
+    m_bufCount(0u),
+    m_bufSize(0u),
+    m_bufArea(nullptr),
+    m_bufLocalTail(0u)
+{
+    struct io_uring_params params;
+    void *sqesArea = MAP_FAILED;
+
+    memset(&params, 0x00, sizeof(params));
+    m_ringFd = ioUringSetup(entries, &params);
+    if (-1 == m_ringFd)
+    {
+        throw OsErrorException("io_uring_setup", errno);
+    }
+    m_features = params.features;
+
+    /*
+     * Waiting with a timeout relies on IORING_ENTER_EXT_ARG (Linux 5.11).
+     * Older kernels are left to the epoll() based implementation.
+     */
+    if (!(m_features & IORING_FEAT_EXT_ARG))
+    {
+        close(m_ringFd);
+        m_ringFd = -1;
+        throw OsErrorException("io_uring_setup", ENOSYS);
+    }
+
+    /*
+     * Map the submission and completion rings; kernels that support it
+     * share a single mapping for both.
+     */
+    m_sqRingSize = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    m_cqRingSize = params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+    if (m_features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (m_cqRingSize > m_sqRingSize)
+        {
+            m_sqRingSize = m_cqRingSize;
+        }
+        m_cqRingSize = m_sqRingSize;
+    }
+
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == m_sqRing)
+    {
+        int mmapErrno = errno;
+        this->unmapRings();
+        throw OsErrorException("mmap", mmapErrno);
+    }
+
+    if (m_features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_cqRing = m_sqRing;
+    }
+    else
+    {
+        m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == m_cqRing)
+        {
+            int mmapErrno = errno;
+            this->unmapRings();
+            throw OsErrorException("mmap", mmapErrno);
+        }
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqesArea = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+    if (MAP_FAILED == sqesArea)
+    {
+        int mmapErrno = errno;
+        this->unmapRings();
+        throw OsErrorException("mmap", mmapErrno);
+    }
+    m_sqes = static_cast<struct io_uring_sqe*>(sqesArea);
+
+    m_sqHead = reinterpret_cast<unsigned*>(static_cast<char*>(m_sqRing) + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned*>(static_cast<char*>(m_sqRing) + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned*>(static_cast<char*>(m_sqRing) + params.sq_off.ring_mask);
+    m_sqEntries = *reinterpret_cast<unsigned*>(static_cast<char*>(m_sqRing) + params.sq_off.ring_entries);
+    m_sqArray = reinterpret_cast<unsigned*>(static_cast<char*>(m_sqRing) + params.sq_off.array);
+    m_sqFlags = reinterpret_cast<unsigned*>(static_cast<char*>(m_sqRing) + params.sq_off.flags);
+    m_sqLocalTail = *m_sqTail;
+    m_sqSubmitted = m_sqLocalTail;
+
+    m_cqHead = reinterpret_cast<unsigned*>(static_cast<char*>(m_cqRing) + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(static_cast<char*>(m_cqRing) + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned*>(static_cast<char*>(m_cqRing) + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<struct io_uring_cqe*>(static_cast<char*>(m_cqRing) + params.cq_off.cqes);
+}
+
+
+IoUring::~IoUring()
+{
+    struct io_uring_buf_reg bufReg;
+
+    if ((m_bufRing != nullptr) && (m_ringFd != -1))
+    {
+        memset(&bufReg, 0x00, sizeof(bufReg));
+        bufReg.bgid = BufferGroup;
+        ioUringRegister(m_ringFd, IORING_UNREGISTER_PBUF_RING, &bufReg, 1u);
+    }
+
+    /*
+     * Closing the ring cancels whatever requests are still outstanding, so
+     * the buffers are only released afterwards.
+     */
+    this->unmapRings();
+
+    if (m_bufRing != nullptr)
+    {
+        munmap(m_bufRing, m_bufRingSize);
+        m_bufRing = nullptr;
+    }
+    delete [] m_bufArea;
+    m_bufArea = nullptr;
+}
+
+
+void
+IoUring::unmapRings()
+{
+    if (m_sqes != nullptr)
+    {
+        munmap(m_sqes, m_sqesSize);
+        m_sqes = nullptr;
+    }
+    if ((m_cqRing != MAP_FAILED) && (m_cqRing != m_sqRing))
+    {
+        munmap(m_cqRing, m_cqRingSize);
+    }
+    m_cqRing = MAP_FAILED;
+    if (m_sqRing != MAP_FAILED)
+    {
+        munmap(m_sqRing, m_sqRingSize);
+        m_sqRing = MAP_FAILED;
+    }
+    if (m_ringFd != -1)
+    {
+        close(m_ringFd);
+        m_ringFd = -1;
+    }
+}
+
+
+struct io_uring_sqe*
+IoUring::nextSqe()
+{
+    struct io_uring_sqe *theSqe = nullptr;
+    unsigned sqIdx = 0u;
+
+    /*
+     * The kernel consumes entries up to the tail on every submission, so a
+     * full queue is drained by submitting it. Should the kernel not keep up,
+     * keep trying; it always makes progress.
+     */
+    while ((m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE)) >= m_sqEntries)
+    {
+        int submitResult = this->submit();
+
+        if ((submitResult < 0) && (submitResult != -EINTR) && (submitResult != -EAGAIN) && (submitResult != -EBUSY))
+        {
+            throw OsErrorException("io_uring_enter", -submitResult);
+        }
+    }
+
+    sqIdx = m_sqLocalTail & m_sqMask;
+    theSqe = &m_sqes[sqIdx];
+    memset(theSqe, 0x00, sizeof(*theSqe));
+    m_sqArray[sqIdx] = sqIdx;
+    m_sqLocalTail++;
+
+    return theSqe;
+}
+
+
+int
+IoUring::submit()
+{
+    unsigned toSubmit = m_sqLocalTail - m_sqSubmitted;
+    int enterResult = 0;
+
+    if (0u == toSubmit)
+    {
+        return 0;
+    }
+
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+    enterResult = ioUringEnter(m_ringFd, toSubmit, 0u, 0u, nullptr, 0u);
+    if (enterResult > 0)
+    {
+        m_sqSubmitted += static_cast<unsigned>(enterResult);
+    }
+
+    return (enterResult < 0) ? -errno : enterResult;
+}
+
+
+int
+IoUring::submitAndWait(int timeoutMs)
+{
+    unsigned toSubmit = m_sqLocalTail - m_sqSubmitted;
+    struct io_uring_getevents_arg waitArg;
+    struct __kernel_timespec waitTimeout;
+    int enterResult = 0;
+
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+
+    if (0 == timeoutMs)
+    {
+        /*
+         * Polling only needs the kernel when there is something to submit,
+         * or when completions overflowed the completion queue and must be
+         * flushed into it.
+         */
+        if ((toSubmit > 0u) || (__atomic_load_n(m_sqFlags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW))
+        {
+            enterResult = ioUringEnter(m_ringFd, toSubmit, 0u, IORING_ENTER_GETEVENTS, nullptr, 0u);
+        }
+    }
+    else if (timeoutMs < 0)
+    {
+        enterResult = ioUringEnter(m_ringFd, toSubmit, 1u, IORING_ENTER_GETEVENTS, nullptr, 0u);
+    }
+    else
+    {
+        memset(&waitArg, 0x00, sizeof(waitArg));
+        waitTimeout.tv_sec = timeoutMs / 1000;
+        waitTimeout.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000LL;
+        waitArg.ts = reinterpret_cast<uint64_t>(&waitTimeout);
+        enterResult = ioUringEnter(m_ringFd, toSubmit, 1u, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &waitArg, sizeof(waitArg));
+    }
+
+    if (enterResult < 0)
+    {
+        return (ETIME == errno) ? 0 : -errno;
+    }
+    m_sqSubmitted += static_cast<unsigned>(enterResult);
+
+    return 0;
+}
+
+
+bool
+IoUring::popCompletion(IoUring::Completion& completion)
+{
+    unsigned cqHead = *m_cqHead;
+    struct io_uring_cqe *theCqe = nullptr;
+
+    if (cqHead == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    theCqe = &m_cqes[cqHead & m_cqMask];
+    completion.userData = theCqe->user_data;
+    completion.result = theCqe->res;
+    completion.flags = theCqe->flags;
+    __atomic_store_n(m_cqHead, cqHead + 1u, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+
+bool
+IoUring::setupBufferRing(unsigned count, size_t size)
+{
+    struct io_uring_buf_reg bufReg;
+    unsigned ringEntries = 1u;
+    void *ringArea = MAP_FAILED;
+
+    if ((m_bufRing != nullptr) || (0u == count) || (0u == size))
+    {
+        return (m_bufRing != nullptr);
+    }
+
+    while ((ringEntries < count) && (ringEntries < 32768u))
+    {
+        ringEntries <<= 1u;
+    }
+
+    m_bufRingSize = ringEntries * sizeof(struct io_uring_buf);
+    ringArea = mmap(nullptr, m_bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == ringArea)
+    {
+        return false;
+    }
+
+    memset(&bufReg, 0x00, sizeof(bufReg));
+    bufReg.ring_addr = reinterpret_cast<uint64_t>(ringArea);
+    bufReg.ring_entries = ringEntries;
+    bufReg.bgid = BufferGroup;
+    if (ioUringRegister(m_ringFd, IORING_REGISTER_PBUF_RING, &bufReg, 1u) != 0)
+    {
+        munmap(ringArea, m_bufRingSize);
+        return false;
+    }
+
+    m_bufRing = static_cast<struct io_uring_buf_ring*>(ringArea);
+    m_bufCount = ringEntries;
+    m_bufSize = size;
+    m_bufArea = new uint8_t[static_cast<size_t>(m_bufCount) * m_bufSize];
+    m_bufLocalTail = 0u;
+
+    for (unsigned bufferId = 0u; bufferId < m_bufCount; ++bufferId)
+    {
+        this->recycleBuffer(static_cast<uint16_t>(bufferId));
+    }
+
+    /*
+     * Some kernels, and sandboxes that emulate io_uring, accept the
+     * registration yet never hand out buffers from the ring. Read through it
+     * once to find out.
+     */
+    if (!this->probeBufferRing())
+    {
+        ioUringRegister(m_ringFd, IORING_UNREGISTER_PBUF_RING, &bufReg, 1u);
+        munmap(m_bufRing, m_bufRingSize);
+        m_bufRing = nullptr;
+        m_bufRingSize = 0u;
+        m_bufCount = 0u;
+        m_bufSize = 0u;
+        delete [] m_bufArea;
+        m_bufArea = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+
+bool
+IoUring::probeBufferRing()
+{
+    int probePipe[2] = { -1, -1 };
+    uint8_t probeByte = 0x00u;
+    struct io_uring_sqe *theSqe = nullptr;
+    Completion aCompletion;
+    bool bufferUsed = false;
+
+    if (pipe2(probePipe, O_CLOEXEC) == -1)
+    {
+        return false;
+    }
+
+    if (write(probePipe[1], &probeByte, sizeof(probeByte)) == sizeof(probeByte))
+    {
+        theSqe = this->nextSqe();
+        theSqe->opcode = IORING_OP_READ;
+        theSqe->fd = probePipe[0];
+        theSqe->off = static_cast<uint64_t>(-1);
+        theSqe->len = static_cast<uint32_t>(m_bufSize);
+        theSqe->flags = IOSQE_BUFFER_SELECT;
+        theSqe->buf_group = BufferGroup;
+
+        if (0 == this->submitAndWait(-1))
+        {
+            while (this->popCompletion(aCompletion))
+            {
+                if ((aCompletion.result > 0) && (aCompletion.flags & IORING_CQE_F_BUFFER))
+                {
+                    this->recycleBuffer(static_cast<uint16_t>(aCompletion.flags >> IORING_CQE_BUFFER_SHIFT));
+                    bufferUsed = true;
+                }
+            }
+        }
+    }
+
+    close(probePipe[0]);
+    close(probePipe[1]);
+
+    return bufferUsed;
+}
+
+
+void
+IoUring::recycleBuffer(uint16_t bufferId)
+{
+    struct io_uring_buf *theBuf = &m_bufRing->bufs[m_bufLocalTail & (m_bufCount - 1u)];
+
+    theBuf->addr = reinterpret_cast<uint64_t>(this->buffer(bufferId));
+    theBuf->len = static_cast<uint32_t>(m_bufSize);
+    theBuf->bid = bufferId;
+    m_bufLocalTail++;
+    __atomic_store_n(&m_bufRing->tail, m_bufLocalTail, __ATOMIC_RELEASE);
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,209 @@
+/**
+ * \file IoUring.h
+ * \brief Contains the definition of the \c IoUring class.
+ * \date 2026-10-16 15:48:12
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_IOURING_H_
+#define _FOUNDATION_COREKIT_IOURING_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <linux/io_uring.h>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Minimal wrapper around a Linux \c io_uring instance.
+ *
+ * Talks to the kernel through the raw system calls, so it has no
+ * dependencies beyond the kernel headers. Besides the submission and
+ * completion rings, an instance may own one ring of provided buffers that
+ * reads with \c IOSQE_BUFFER_SELECT pick from.
+ *
+ * Instances are not thread safe; they are meant to be driven by the thread
+ * running the \c CoreKit::RunLoop that owns them.
+ */
+class IoUring
+{
+public:
+    /**
+     * \brief Outcome of one completed request.
+     */
+    struct Completion
+    {
+        /**
+         * \brief Value given to the request's \c user_data field.
+         */
+        uint64_t userData;
+        /**
+         * \brief Result of the request; a negated \c errno value on failure.
+         */
+        int32_t result;
+        /**
+         * \brief \c IORING_CQE_F_* flags.
+         */
+        uint32_t flags;
+    };
+
+    /**
+     * \brief Buffer group identifier used for the provided buffer ring.
+     */
+    static const uint16_t BufferGroup = 0u;
+
+private:
+    int m_ringFd;
+    void *m_sqRing;
+    size_t m_sqRingSize;
+    void *m_cqRing;
+    size_t m_cqRingSize;
+    struct io_uring_sqe *m_sqes;
+    size_t m_sqesSize;
+    unsigned *m_sqHead;
+    unsigned *m_sqTail;
+    unsigned m_sqMask;
+    unsigned m_sqEntries;
+    unsigned *m_sqArray;
+    unsigned *m_sqFlags;
+
+    unsigned m_sqLocalTail;
+    unsigned m_sqSubmitted;
+    unsigned *m_cqHead;
+    unsigned *m_cqTail;
+    unsigned m_cqMask;
+    struct io_uring_cqe *m_cqes;
+    unsigned m_features;
+
+    struct io_uring_buf_ring *m_bufRing;
+    size_t m_bufRingSize;
+    unsigned m_bufCount;
+    size_t m_bufSize;
+    uint8_t *m_bufArea;
+    uint16_t m_bufLocalTail;
+
+    IoUring(IoUring const& other);
+    IoUring& operator=(IoUring const& other);
+
+    void unmapRings();
+
+    /**
+     * \brief Check that reads actually pick buffers from the ring.
+     *
+     * Must run before any other request is submitted, since it consumes
+     * every completion.
+     *
+     * \return \c true if a read through the ring succeeded.
+     */
+    bool probeBufferRing();
+
+public:
+    /**
+     * \brief Create the ring.
+     *
+     * \param[in] entries - Size of the submission queue.
+     *
+     * \throw OsErrorException if the kernel does not support \c io_uring, or
+     *        refuses to create the ring.
+     */
+    explicit IoUring(unsigned entries);
+
+    /**
+     * \brief Destructor; cancels all outstanding requests.
+     */
+    ~IoUring();
+
+    /**
+     * \brief Access the file descriptor of the ring.
+     *
+     * \return Ring file descriptor.
+     */
+    inline int fileDescriptor() const { return m_ringFd; }
+
+    /**
+     * \brief Obtain a cleared submission queue entry.
+     *
+     * If the submission queue is full, the queued entries are handed to the
+     * kernel first.
+     *
+     * \return Entry to fill in; it is submitted by the next call to
+     *         \c submit() or \c submitAndWait().
+     */
+    struct io_uring_sqe* nextSqe();
+
+    /**
+     * \brief Hand all queued entries to the kernel without waiting.
+     *
+     * \return Number of entries submitted, or a negated \c errno value.
+     */
+    int submit();
+
+    /**
+     * \brief Hand all queued entries to the kernel, then wait for a completion.
+     *
+     * \param[in] timeoutMs - Longest time to wait, in milliseconds; zero
+     *            does not wait and a negative value waits indefinitely.
+     *
+     * \return Zero on success or timeout, or a negated \c errno value.
+     */
+    int submitAndWait(int timeoutMs);
+
+    /**
+     * \brief Remove the oldest completion from the completion queue.
+     *
+     * \param[out] completion - Receives the completion.
+     *
+     * \return \c true if a completion was available.
+     */
+    bool popCompletion(Completion& completion);
+
+    /**
+     * \brief Create the ring of provided buffers.
+     *
+     * \param[in] count - Number of buffers; rounded up to a power of two.
+     * \param[in] size - Size of each buffer, in bytes.
+     *
+     * Must be called before any other request is submitted.
+     *
+     * \return \c true on success; \c false if the kernel does not support
+     *         provided buffer rings.
+     */
+    bool setupBufferRing(unsigned count, size_t size);
+
+    /**
+     * \brief Check whether the ring of provided buffers exists.
+     *
+     * \return \c true after a successful \c setupBufferRing().
+     */
+    inline bool hasBufferRing() const { return (m_bufRing != nullptr); }
+
+    /**
+     * \brief Access the size of the provided buffers.
+     *
+     * \return Size of each buffer, in bytes.
+     */
+    inline size_t bufferSize() const { return m_bufSize; }
+
+    /**
+     * \brief Access a provided buffer.
+     *
+     * \param[in] bufferId - Identifier reported by a completion.
+     *
+     * \return Start of the buffer.
+     */
+    inline uint8_t* buffer(uint16_t bufferId) const { return m_bufArea + (static_cast<size_t>(bufferId) * m_bufSize); }
+
+    /**
+     * \brief Give a provided buffer back to the kernel.
+     *
+     * \param[in] bufferId - Identifier reported by a completion.
+     */
+    void recycleBuffer(uint16_t bufferId);
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_IOURING_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,92 @@
+/**
+ * \file LatencyHistogram.cpp
+ * \brief Contains the implementation of the \c LatencyHistogram class.
+ * \date 2026-10-16 14:21:09
+ * \author Rolando J. Nieves
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "LatencyHistogram.h"
+
+
+namespace CoreKit
+{
+
+const unsigned LatencyHistogram::NumBuckets;
+
+
+LatencyHistogram::LatencyHistogram()
+{
+    this->reset();
+}
+
+
+void
+LatencyHistogram::reset()
+{
+    memset(&m_buckets[0], 0x00, sizeof(m_buckets));
+    m_count = 0u;
+    m_totalNs = 0u;
+    m_maxNs = 0u;
+}
+
+
+double
+LatencyHistogram::meanNs() const
+{
+    return (m_count > 0u) ? (static_cast<double>(m_totalNs) / static_cast<double>(m_count)) : 0.0;
+}
+
+
+uint64_t
+LatencyHistogram::percentileNs(double fraction) const
+{
+    uint64_t target = 0u;
+    uint64_t seen = 0u;
+
+    if (0u == m_count)
+    {
+        return 0u;
+    }
+
+    target = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_count)));
+    if (0u == target)
+    {
+        target = 1u;
+    }
+
+    for (unsigned bucketIdx = 0u; bucketIdx < NumBuckets; ++bucketIdx)
+    {
+        seen += m_buckets[bucketIdx];
+        if (seen >= target)
+        {
+            uint64_t upperBound = (bucketIdx < 63u) ? ((2uLL << bucketIdx) - 1u) : UINT64_MAX;
+
+            return (upperBound < m_maxNs) ? upperBound : m_maxNs;
+        }
+    }
+
+    return m_maxNs;
+}
+
+
+void
+LatencyHistogram::merge(LatencyHistogram const& other)
+{
+    for (unsigned bucketIdx = 0u; bucketIdx < NumBuckets; ++bucketIdx)
+    {
+        m_buckets[bucketIdx] += other.m_buckets[bucketIdx];
+    }
+    m_count += other.m_count;
+    m_totalNs += other.m_totalNs;
+    if (other.m_maxNs > m_maxNs)
+    {
+        m_maxNs = other.m_maxNs;
+    }
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,120 @@
+/**
+ * \file LatencyHistogram.h
+ * \brief Contains the definition of the \c LatencyHistogram class.
+ * \date 2026-10-16 14:21:09
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_LATENCYHISTOGRAM_H_
+#define _FOUNDATION_COREKIT_LATENCYHISTOGRAM_H_
+
+#include <stdint.h>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Histogram of durations with power-of-two nanosecond buckets.
+ *
+ * Bucket \c n counts durations in the range [2^n, 2^(n+1)) nanoseconds
+ * (bucket zero also counts zero). Recording a sample is a handful of
+ * instructions with no allocation or locking, so instances are meant to be
+ * owned and updated by a single thread, usually the one running a
+ * \c CoreKit::RunLoop.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * \brief Number of buckets in the histogram.
+     */
+    static const unsigned NumBuckets = 64u;
+
+private:
+    uint64_t m_buckets[NumBuckets];
+    uint64_t m_count;
+    uint64_t m_totalNs;
+    uint64_t m_maxNs;
+
+public:
+    /**
+     * \brief Default constructor.
+     */
+    LatencyHistogram();
+
+    /**
+     * \brief Account for one duration.
+     *
+     * \param[in] durationNs - Duration to record, in nanoseconds.
+     */
+    inline void record(uint64_t durationNs)
+    {
+        m_buckets[63 - __builtin_clzll(durationNs | 1u)]++;
+        m_count++;
+        m_totalNs += durationNs;
+        if (durationNs > m_maxNs)
+        {
+            m_maxNs = durationNs;
+        }
+    }
+
+    /**
+     * \brief Discard all recorded durations.
+     */
+    void reset();
+
+    /**
+     * \brief Count the recorded durations.
+     *
+     * \return Number of samples.
+     */
+    inline uint64_t count() const { return m_count; }
+
+    /**
+     * \brief Access the number of samples in one bucket.
+     *
+     * \param[in] bucketIdx - Bucket to look at, below \c NumBuckets.
+     *
+     * \return Number of samples in the bucket.
+     */
+    inline uint64_t bucket(unsigned bucketIdx) const { return m_buckets[bucketIdx]; }
+
+    /**
+     * \brief Access the longest recorded duration.
+     *
+     * \return Longest duration, in nanoseconds.
+     */
+    inline uint64_t maxNs() const { return m_maxNs; }
+
+    /**
+     * \brief Compute the average of the recorded durations.
+     *
+     * \return Mean duration, in nanoseconds; zero if there are no samples.
+     */
+    double meanNs() const;
+
+    /**
+     * \brief Estimate a percentile of the recorded durations.
+     *
+     * The estimate is the upper bound of the bucket the percentile falls
+     * in, capped at the longest recorded duration.
+     *
+     * \param[in] fraction - Percentile to estimate, between zero and one.
+     *
+     * \return Estimated duration, in nanoseconds.
+     */
+    uint64_t percentileNs(double fraction) const;
+
+    /**
+     * \brief Add the samples recorded by another histogram to this one.
+     *
+     * \param[in] other - Histogram to merge into this one.
+     */
+    void merge(LatencyHistogram const& other);
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_LATENCYHISTOGRAM_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,145 @@
+/**
+ * \file LogThrottle.cpp
+ * \brief Contains the implementation of the \c LogThrottle class.
+ * \date 2026-10-16 21:48:10
+ * \author Rolando J. Nieves
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "LogThrottle.h"
+
+/**
+ * \brief FNV-1a 64-bit offset basis.
+ */
+#define RF_CK_LT_FNV_OFFSET (0xcbf29ce484222325uLL)
+/**
+ * \brief FNV-1a 64-bit prime.
+ */
+#define RF_CK_LT_FNV_PRIME (0x00000100000001b3uLL)
+
+
+namespace CoreKit
+{
+
+LogThrottle::LogThrottle(char const *fileName, unsigned lineNumber, unsigned maxCount, double intervalSecs):
+    m_fileName(fileName),
+    m_lineNumber(lineNumber),
+    m_maxCount(maxCount),
+    m_intervalNsecs(static_cast< uint64_t >((intervalSecs > 0.0 ? intervalSecs : 0.0) * 1e9)),
+    m_windowStart(0u),
+    m_windowCount(0u),
+    m_suppressed(0u),
+    m_lastHash(0u),
+    m_runStart(0u),
+    m_repeats(0u)
+{
+    /*
+     * Report the file name alone; __FILE__ may carry the whole build path.
+     */
+    char const *lastSlash = strrchr(m_fileName, '/');
+
+    if (lastSlash != nullptr)
+    {
+        m_fileName = lastSlash + 1;
+    }
+}
+
+
+bool
+LogThrottle::admit(uint64_t& suppressedCount, uint64_t& repeatCount)
+{
+    uint64_t now = LogThrottle::nowNsecs();
+    uint64_t windowStart = m_windowStart.load(std::memory_order_relaxed);
+
+    /*
+     * A run of repeats is otherwise only reported by collapse(), which
+     * never sees the messages the rate limit holds back. Ending the run
+     * here keeps it from being reported twice.
+     */
+    repeatCount = 0u;
+    if ((m_repeats.load(std::memory_order_relaxed) > 0u) &&
+        ((now - m_runStart.load(std::memory_order_relaxed)) >= m_intervalNsecs))
+    {
+        m_lastHash.store(0u, std::memory_order_relaxed);
+        repeatCount = m_repeats.exchange(0u, std::memory_order_relaxed);
+    }
+
+    suppressedCount = 0u;
+    if (((now - windowStart) >= m_intervalNsecs) &&
+        m_windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+    {
+        m_windowCount.store(0u, std::memory_order_relaxed);
+        suppressedCount = m_suppressed.exchange(0u, std::memory_order_relaxed);
+    }
+
+    if (m_windowCount.fetch_add(1u, std::memory_order_relaxed) < m_maxCount)
+    {
+        return true;
+    }
+
+    /*
+     * Lost the new window to other threads; the summary waits for the next
+     * message that gets through.
+     */
+    m_suppressed.fetch_add(suppressedCount + 1u, std::memory_order_relaxed);
+    suppressedCount = 0u;
+
+    return false;
+}
+
+
+bool
+LogThrottle::collapse(uint64_t messageHash, uint64_t& repeatCount)
+{
+    uint64_t now = LogThrottle::nowNsecs();
+
+    repeatCount = 0u;
+    if ((m_lastHash.load(std::memory_order_relaxed) == messageHash) &&
+        ((now - m_runStart.load(std::memory_order_relaxed)) < m_intervalNsecs))
+    {
+        m_repeats.fetch_add(1u, std::memory_order_relaxed);
+        return true;
+    }
+
+    m_lastHash.store(messageHash, std::memory_order_relaxed);
+    m_runStart.store(now, std::memory_order_relaxed);
+    repeatCount = m_repeats.exchange(0u, std::memory_order_relaxed);
+
+    return false;
+}
+
+
+uint64_t
+LogThrottle::hashText(char const *text, size_t length)
+{
+    uint64_t result = RF_CK_LT_FNV_OFFSET;
+
+    for (size_t charIdx = 0u; charIdx < length; ++charIdx)
+    {
+        result ^= static_cast< unsigned char >(text[charIdx]);
+        result *= RF_CK_LT_FNV_PRIME;
+    }
+
+    return result;
+}
+
+
+uint64_t
+LogThrottle::nowNsecs()
+{
+    struct timespec now;
+
+    /*
+     * Intervals are seconds long, so the coarse clock (a few milliseconds
+     * of resolution, no system call) is plenty.
+     */
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+    return (static_cast< uint64_t >(now.tv_sec) * 1000000000uLL) + static_cast< uint64_t >(now.tv_nsec);
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,104 @@
+/**
+ * \file LogThrottle.h
+ * \brief Contains the definition of the \c LogThrottle class.
+ * \date 2026-10-16 21:48:10
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_LOGTHROTTLE_H_
+#define _FOUNDATION_COREKIT_LOGTHROTTLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Rate limit and duplicate filter of one log statement.
+ *
+ * Normally a function local \c static created by \c RF_CK_LOG_LIMITED().
+ * Within each interval the call site may publish up to a set number of
+ * messages; the rest are counted and reported in one summary message once
+ * the next interval lets a message through. A message identical to the
+ * previous one from the same call site is held back until the interval
+ * since the first of its kind is over, or a different message comes along,
+ * and then reported as a repeat count. Once the interval is over, the count
+ * is reported the next time the call site logs, even if that message is
+ * held back by the rate limit.\par
+ *
+ * Checking a message that gets through costs a coarse clock read and a few
+ * uncontended atomic operations. Counts are kept without locks, so under
+ * heavy contention a message or two more or less may get through.
+ */
+class LogThrottle
+{
+public:
+    /**
+     * \brief Main constructor.
+     *
+     * \param[in] fileName - Source file of the call site, as reported in
+     *            summaries.
+     * \param[in] lineNumber - Source line of the call site.
+     * \param[in] maxCount - Messages published per interval.
+     * \param[in] intervalSecs - Length of the interval, in seconds.
+     */
+    LogThrottle(char const *fileName, unsigned lineNumber, unsigned maxCount, double intervalSecs);
+
+    /**
+     * \brief Decide whether a new message from the call site goes out.
+     *
+     * \param[out] suppressedCount - Messages held back during the previous
+     *             interval, to be reported now; zero if none.
+     * \param[out] repeatCount - Repeats of the previous message held back
+     *             for a whole interval, to be reported now; zero if none.
+     *
+     * \return \c true if the message may be published.
+     */
+    bool admit(uint64_t& suppressedCount, uint64_t& repeatCount);
+
+    /**
+     * \brief Decide whether a finished message repeats the previous one.
+     *
+     * \param[in] messageHash - Hash of the message text (see \c hashText()).
+     * \param[out] repeatCount - Repeats of the previous message held back,
+     *             to be reported ahead of this one; zero if none.
+     *
+     * \return \c true if the message is a repeat and must be dropped.
+     */
+    bool collapse(uint64_t messageHash, uint64_t& repeatCount);
+
+    inline char const* fileName() const { return m_fileName; }
+    inline unsigned lineNumber() const { return m_lineNumber; }
+
+    /**
+     * \brief Hash message text for \c collapse().
+     *
+     * \return 64-bit FNV-1a hash of the text.
+     */
+    static uint64_t hashText(char const *text, size_t length);
+
+private:
+    char const *m_fileName;
+    unsigned m_lineNumber;
+    unsigned m_maxCount;
+    uint64_t m_intervalNsecs;
+    std::atomic< uint64_t > m_windowStart;
+    std::atomic< uint32_t > m_windowCount;
+    std::atomic< uint64_t > m_suppressed;
+    std::atomic< uint64_t > m_lastHash;
+    std::atomic< uint64_t > m_runStart;
+    std::atomic< uint64_t > m_repeats;
+
+    static uint64_t nowNsecs();
+
+    LogThrottle(LogThrottle const& other);
+    LogThrottle& operator=(LogThrottle const& other);
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_LOGTHROTTLE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,211 @@
+/**
+ * \file LoopCallback.h
+ * \brief Contains the definition of the \c LoopCallback class.
+ * \date 2026-10-16 18:31:07
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_LOOPCALLBACK_H_
+#define _FOUNDATION_COREKIT_LOOPCALLBACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * \brief Bytes a \c LoopCallback can hold without allocating.
+ */
+#define RF_CK_LOOP_CALLBACK_INLINE_SIZE (48u)
+
+namespace CoreKit
+{
+class RunLoop;
+
+/**
+ * \brief Move-only callable invoked by a \c CoreKit::RunLoop between iterations.
+ *
+ * Targets (lambdas, \c std::bind() results, function objects) that fit in
+ * \c RF_CK_LOOP_CALLBACK_INLINE_SIZE bytes and can be moved without
+ * throwing are stored inside the object itself, so registering them does
+ * not touch the heap. Larger targets fall back to a single allocation.
+ */
+class LoopCallback
+{
+public:
+    /**
+     * \brief Build an empty callback.
+     */
+    inline LoopCallback() noexcept: m_operations(nullptr) {}
+
+    /**
+     * \brief Build a callback around a target.
+     *
+     * \param[in] cbTarget - Callable taking a \c RunLoop pointer.
+     */
+    template< typename TargetType,
+              typename = typename std::enable_if< !std::is_same< typename std::decay< TargetType >::type, LoopCallback >::value >::type >
+    LoopCallback(TargetType&& cbTarget):
+        m_operations(&Operations::template forTarget< typename std::decay< TargetType >::type >())
+    {
+        typedef typename std::decay< TargetType >::type Target;
+
+        if (Operations::template fitsInline< Target >())
+        {
+            new (m_storage) Target(std::forward< TargetType >(cbTarget));
+        }
+        else
+        {
+            *reinterpret_cast<Target**>(m_storage) = new Target(std::forward< TargetType >(cbTarget));
+        }
+    }
+
+    inline LoopCallback(LoopCallback&& other) noexcept:
+        m_operations(other.m_operations)
+    {
+        if (m_operations != nullptr)
+        {
+            m_operations->relocate(m_storage, other.m_storage);
+            other.m_operations = nullptr;
+        }
+    }
+
+    inline LoopCallback& operator=(LoopCallback&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->reset();
+            if (other.m_operations != nullptr)
+            {
+                m_operations = other.m_operations;
+                m_operations->relocate(m_storage, other.m_storage);
+                other.m_operations = nullptr;
+            }
+        }
+
+        return *this;
+    }
+
+    inline ~LoopCallback() { this->reset(); }
+
+    /**
+     * \brief Destroy the target, leaving the callback empty.
+     */
+    inline void reset() noexcept
+    {
+        if (m_operations != nullptr)
+        {
+            m_operations->destroy(m_storage);
+            m_operations = nullptr;
+        }
+    }
+
+    /**
+     * \brief Tell whether the callback has a target.
+     */
+    inline explicit operator bool() const { return (m_operations != nullptr); }
+
+    /**
+     * \brief Tell whether the target is stored without a heap allocation.
+     */
+    inline bool isInline() const { return ((m_operations != nullptr) && m_operations->isInline); }
+
+    /**
+     * \brief Invoke the target.
+     *
+     * \param[in] theRunLoop - Run loop invoking the callback.
+     */
+    inline void operator()(RunLoop *theRunLoop) { m_operations->invoke(m_storage, theRunLoop); }
+
+private:
+    struct Operations
+    {
+        void (*invoke)(void *storage, RunLoop *theRunLoop);
+        void (*relocate)(void *destination, void *source);
+        void (*destroy)(void *storage);
+        bool isInline;
+
+        template< typename Target >
+        static constexpr bool fitsInline()
+        {
+            return ((sizeof(Target) <= RF_CK_LOOP_CALLBACK_INLINE_SIZE) &&
+                    (alignof(Target) <= alignof(max_align_t)) &&
+                    std::is_nothrow_move_constructible< Target >::value);
+        }
+
+        template< typename Target >
+        static void invokeInline(void *storage, RunLoop *theRunLoop)
+        { (*static_cast<Target*>(storage))(theRunLoop); }
+
+        template< typename Target >
+        static void relocateInline(void *destination, void *source)
+        {
+            new (destination) Target(std::move(*static_cast<Target*>(source)));
+            static_cast<Target*>(source)->~Target();
+        }
+
+        template< typename Target >
+        static void destroyInline(void *storage)
+        { static_cast<Target*>(storage)->~Target(); }
+
+        template< typename Target >
+        static void invokeHeap(void *storage, RunLoop *theRunLoop)
+        { (**static_cast<Target**>(storage))(theRunLoop); }
+
+        static void relocateHeap(void *destination, void *source)
+        { *static_cast<void**>(destination) = *static_cast<void**>(source); }
+
+        template< typename Target >
+        static void destroyHeap(void *storage)
+        { delete *static_cast<Target**>(storage); }
+
+        template< typename Target >
+        static Operations const& forTarget()
+        {
+            static Operations const inlineOps = { &invokeInline< Target >, &relocateInline< Target >, &destroyInline< Target >, true };
+            static Operations const heapOps = { &invokeHeap< Target >, &relocateHeap, &destroyHeap< Target >, false };
+
+            return (fitsInline< Target >() ? inlineOps : heapOps);
+        }
+    };
+
+    alignas(max_align_t) unsigned char m_storage[RF_CK_LOOP_CALLBACK_INLINE_SIZE];
+    Operations const *m_operations;
+
+    LoopCallback(LoopCallback const& other);
+    LoopCallback& operator=(LoopCallback const& other);
+};
+
+
+/**
+ * \brief Identifies a callback registered with \c RunLoop::addLoopCallback().
+ *
+ * A handle whose callback was removed stops matching, even if its slot is
+ * later reused for another callback.
+ */
+struct LoopCallbackHandle
+{
+    /**
+     * \brief Slot holding the callback.
+     */
+    uint32_t index;
+    /**
+     * \brief Generation of the slot when the callback was registered; zero
+     *        for a handle that refers to nothing.
+     */
+    uint32_t generation;
+
+    inline LoopCallbackHandle(): index(0u), generation(0u) {}
+
+    /**
+     * \brief Tell whether the handle was ever assigned a callback.
+     */
+    inline bool isValid() const { return (generation != 0u); }
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_LOOPCALLBACK_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,477 @@
+/**
+ * \file LoopGroup.cpp
+ * \brief Contains the implementation of the \c LoopGroup class.
+ * \date 2026-10-16 16:41:09
+ * \author Rolando J. Nieves
+ */
+
+#include <semaphore.h>
+#include <time.h>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <memory>
+
+#include <CoreKit/Application.h>
+#include <CoreKit/BlockGuard.h>
+#include <CoreKit/OsErrorException.h>
+#include <CoreKit/PreconditionNotMetException.h>
+#include <CoreKit/RunLoop.h>
+#include <CoreKit/Thread.h>
+
+#include "LoopGroup.h"
+
+/**
+ * \brief How often a thread waiting on a shard checks that it still runs.
+ */
+#define RF_CK_LG_WAIT_SLICE_NS (10000000L)
+
+
+namespace CoreKit
+{
+
+namespace
+{
+
+/**
+ * \brief Change handed to a shard's thread, and its outcome.
+ *
+ * Shared between the closure and the waiting thread, so whichever lets go
+ * last releases it.
+ */
+struct ShardChange
+{
+    enum State
+    {
+        CS_PENDING = 0,
+        CS_RUNNING,
+        CS_ABANDONED
+    };
+
+    std::atomic< int > state;
+    sem_t done;
+    std::exception_ptr error;
+
+    ShardChange():
+        state(CS_PENDING)
+    {
+        sem_init(&done, 0, 0u);
+    }
+
+    ~ShardChange()
+    {
+        sem_destroy(&done);
+    }
+};
+
+} // end anonymous namespace
+
+
+LoopGroup::Shard::Shard(unsigned index, cpu_set_t const* affinity):
+    index(index),
+    pinned(affinity != nullptr),
+    thread(nullptr),
+    load(0u)
+{
+    if (affinity != nullptr)
+    {
+        memcpy(&this->affinity, affinity, sizeof(cpu_set_t));
+    }
+    else
+    {
+        CPU_ZERO(&this->affinity);
+    }
+}
+
+
+LoopGroup::Shard::~Shard()
+{
+
+}
+
+
+void
+LoopGroup::Shard::doThreadLogic(Thread *theThread)
+{
+    int pinResult = 0;
+
+    if (pinned)
+    {
+        pinResult = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &affinity);
+        if ((pinResult != 0) && (G_MyApp != nullptr))
+        {
+            G_MyApp->log() << AppLog::LL_WARNING << "Loop group shard " << index
+                << " could not be pinned to its CPUs: " << strerror(pinResult)
+                << EndLog;
+        }
+    }
+
+    theThread->runLoop()->run();
+}
+
+
+LoopGroup::LoopGroup(Application *hostApp, unsigned shardCount, std::vector< cpu_set_t > const& affinities):
+    m_stopRequested(false)
+{
+    if (0u == shardCount)
+    {
+        throw PreconditionNotMetException("Can not create a loop group without shards.");
+    }
+
+    pthread_mutex_init(&m_ownersMutex, nullptr);
+
+    /*
+     * Every shard must be fully set up before its thread starts, since the
+     * thread begins running the shard's logic right away.
+     */
+    m_shards.reserve(shardCount);
+    for (unsigned shardIdx = 0u; shardIdx < shardCount; ++shardIdx)
+    {
+        Shard *newShard = new Shard(
+            shardIdx,
+            affinities.empty() ? nullptr : &affinities[shardIdx % affinities.size()]
+        );
+
+        m_shards.push_back(newShard);
+        newShard->thread = construct(Thread::myType(), newShard, hostApp, false);
+    }
+}
+
+
+LoopGroup::~LoopGroup()
+{
+    this->stop();
+
+    for (Shard *aShard : m_shards)
+    {
+        aShard->thread->join();
+        destroy(aShard->thread);
+        delete aShard;
+    }
+    m_shards.clear();
+
+    pthread_mutex_destroy(&m_ownersMutex);
+}
+
+
+bool
+LoopGroup::isShardThread(unsigned shard) const
+{
+    return (pthread_equal(pthread_self(), m_shards[shard]->thread->threadId()) != 0);
+}
+
+
+bool
+LoopGroup::applyOnShard(unsigned shard, TaskQueue::Task const& change)
+{
+    RunLoop *shardRunLoop = m_shards[shard]->thread->runLoop();
+    std::shared_ptr< ShardChange > pending;
+    struct timespec deadline;
+
+    if (this->isShardThread(shard))
+    {
+        change();
+        return true;
+    }
+    if (shardRunLoop->isTerminationRequested())
+    {
+        return false;
+    }
+
+    pending = std::make_shared< ShardChange >();
+    if (!shardRunLoop->post([pending, change]() {
+            int expected = ShardChange::CS_PENDING;
+
+            if (!pending->state.compare_exchange_strong(expected, ShardChange::CS_RUNNING))
+            {
+                return;
+            }
+            try
+            {
+                change();
+            }
+            catch (...)
+            {
+                pending->error = std::current_exception();
+            }
+            sem_post(&pending->done);
+        }, TaskQueue::OP_BLOCK))
+    {
+        return false;
+    }
+
+    /*
+     * A shard that stops never runs what is left in its queue, so check on
+     * it now and then. Once the change is running it is always seen
+     * through.
+     */
+    for (;;)
+    {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += RF_CK_LG_WAIT_SLICE_NS;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        if (0 == sem_timedwait(&pending->done, &deadline))
+        {
+            break;
+        }
+        if (EINTR == errno)
+        {
+            continue;
+        }
+        if (errno != ETIMEDOUT)
+        {
+            throw OsErrorException("sem_timedwait()", errno);
+        }
+        if (shardRunLoop->isTerminationRequested())
+        {
+            int expected = ShardChange::CS_PENDING;
+
+            if (pending->state.compare_exchange_strong(expected, ShardChange::CS_ABANDONED))
+            {
+                return false;
+            }
+        }
+    }
+
+    if (pending->error)
+    {
+        std::rethrow_exception(pending->error);
+    }
+
+    return true;
+}
+
+
+void
+LoopGroup::releaseClaim(int fd, unsigned shard)
+{
+    BlockGuard ownersGuard(&m_ownersMutex);
+
+    m_owners.erase(fd);
+    m_shards[shard]->load.fetch_sub(1u, std::memory_order_relaxed);
+}
+
+
+RunLoop*
+LoopGroup::runLoop(unsigned shard) const
+{
+    return m_shards.at(shard)->thread->runLoop();
+}
+
+
+RunLoop*
+LoopGroup::currentRunLoop() const
+{
+    for (unsigned shardIdx = 0u; shardIdx < m_shards.size(); ++shardIdx)
+    {
+        if (this->isShardThread(shardIdx))
+        {
+            return m_shards[shardIdx]->thread->runLoop();
+        }
+    }
+
+    return nullptr;
+}
+
+
+size_t
+LoopGroup::load(unsigned shard) const
+{
+    return m_shards.at(shard)->load.load(std::memory_order_relaxed);
+}
+
+
+unsigned
+LoopGroup::shardForFd(int fd) const
+{
+    return static_cast<unsigned>(fd) % this->size();
+}
+
+
+unsigned
+LoopGroup::leastLoadedShard() const
+{
+    unsigned result = 0u;
+    size_t leastLoad = m_shards[0]->load.load(std::memory_order_relaxed);
+
+    for (unsigned shardIdx = 1u; shardIdx < m_shards.size(); ++shardIdx)
+    {
+        size_t shardLoad = m_shards[shardIdx]->load.load(std::memory_order_relaxed);
+
+        if (shardLoad < leastLoad)
+        {
+            leastLoad = shardLoad;
+            result = shardIdx;
+        }
+    }
+
+    return result;
+}
+
+
+unsigned
+LoopGroup::addInputSource(InputSource *inputSource, Placement placement)
+{
+    unsigned result = 0u;
+
+    {
+        /*
+         * Choose and claim under the lock, so concurrent callers asking for
+         * the least loaded shard do not all pile onto the same one.
+         */
+        BlockGuard ownersGuard(&m_ownersMutex);
+
+        if (PL_LEAST_LOADED == placement)
+        {
+            result = this->leastLoadedShard();
+        }
+        else
+        {
+            result = this->shardForFd(inputSource->fileDescriptor());
+        }
+
+        if (!m_owners.insert(OwnerMap::value_type(inputSource->fileDescriptor(), result)).second)
+        {
+            throw PreconditionNotMetException("Can not hand the same file descriptor to a loop group twice.");
+        }
+        m_shards[result]->load.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    this->registerOnShard(inputSource, result);
+
+    return result;
+}
+
+
+void
+LoopGroup::addInputSourceToShard(InputSource *inputSource, unsigned shard)
+{
+    if (shard >= m_shards.size())
+    {
+        throw PreconditionNotMetException("Loop group shard index in range.");
+    }
+
+    {
+        BlockGuard ownersGuard(&m_ownersMutex);
+
+        if (!m_owners.insert(OwnerMap::value_type(inputSource->fileDescriptor(), shard)).second)
+        {
+            throw PreconditionNotMetException("Can not hand the same file descriptor to a loop group twice.");
+        }
+        m_shards[shard]->load.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    this->registerOnShard(inputSource, shard);
+}
+
+
+void
+LoopGroup::registerOnShard(InputSource *inputSource, unsigned shard)
+{
+    RunLoop *shardRunLoop = m_shards[shard]->thread->runLoop();
+    bool applied = false;
+
+    /*
+     * The claim on the file descriptor is already made; give it back if
+     * the shard does not take the input source after all.
+     */
+    try
+    {
+        applied = this->applyOnShard(shard, [shardRunLoop, inputSource]() { shardRunLoop->registerInputSource(inputSource); });
+    }
+    catch (...)
+    {
+        this->releaseClaim(inputSource->fileDescriptor(), shard);
+        throw;
+    }
+
+    if (!applied)
+    {
+        this->releaseClaim(inputSource->fileDescriptor(), shard);
+        throw PreconditionNotMetException("Loop group shard running when an input source is handed to it.");
+    }
+}
+
+
+int
+LoopGroup::removeInputSource(InputSource *inputSource)
+{
+    unsigned shard = 0u;
+    RunLoop *shardRunLoop = nullptr;
+
+    {
+        BlockGuard ownersGuard(&m_ownersMutex);
+        OwnerMap::iterator theOwner = m_owners.find(inputSource->fileDescriptor());
+
+        if (theOwner == m_owners.end())
+        {
+            return -1;
+        }
+        shard = theOwner->second;
+        m_owners.erase(theOwner);
+        m_shards[shard]->load.fetch_sub(1u, std::memory_order_relaxed);
+    }
+
+    /*
+     * A shard that stopped before getting to the change no longer services
+     * the input source either, so there is nothing left to undo.
+     */
+    shardRunLoop = m_shards[shard]->thread->runLoop();
+    this->applyOnShard(shard, [shardRunLoop, inputSource]() { shardRunLoop->deregisterInputSource(inputSource); });
+
+    return static_cast<int>(shard);
+}
+
+
+int
+LoopGroup::ownerOf(int fd) const
+{
+    BlockGuard ownersGuard(&m_ownersMutex);
+    OwnerMap::const_iterator theOwner = m_owners.find(fd);
+
+    return (theOwner != m_owners.end()) ? static_cast<int>(theOwner->second) : -1;
+}
+
+
+RunLoop*
+LoopGroup::runLoopForFd(int fd) const
+{
+    int owner = this->ownerOf(fd);
+
+    return m_shards[(owner >= 0) ? static_cast<unsigned>(owner) : this->shardForFd(fd)]->thread->runLoop();
+}
+
+
+bool
+LoopGroup::postToOwner(int fd, TaskQueue::Task task)
+{
+    return this->runLoopForFd(fd)->post(std::move(task));
+}
+
+
+void
+LoopGroup::stop()
+{
+    if (m_stopRequested.exchange(true))
+    {
+        return;
+    }
+
+    /*
+     * RunLoop::terminate() wakes each loop up, so they all stop right away
+     * even if they are blocked waiting for input.
+     */
+    for (Shard *aShard : m_shards)
+    {
+        aShard->thread->runLoop()->terminate();
+    }
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
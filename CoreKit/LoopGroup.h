@@ -0,0 +1,265 @@
+/**
+ * \file LoopGroup.h
+ * \brief Contains the definition of the \c LoopGroup class.
+ * \date 2026-10-16 16:41:09
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_LOOPGROUP_H_
+#define _FOUNDATION_COREKIT_LOOPGROUP_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include <CoreKit/factory.h>
+#include <CoreKit/InputSource.h>
+#include <CoreKit/TaskQueue.h>
+#include <CoreKit/ThreadDelegate.h>
+
+namespace CoreKit
+{
+
+class Application;
+class RunLoop;
+class Thread;
+
+/**
+ * \brief Set of worker threads that share the input sources of a process.
+ *
+ * Each worker, or \e shard, is a \c CoreKit::Thread running its own
+ * \c CoreKit::RunLoop, optionally pinned to a set of CPUs. Input sources
+ * are handed to the group, which picks the shard that services them
+ * either by hashing their file descriptor or by choosing the shard with
+ * the fewest input sources. The group remembers which shard owns each file
+ * descriptor, so work related to a descriptor can be sent to the thread
+ * that services it with \c postToOwner().
+ *
+ * All methods may be called from any thread. Input sources handed to a
+ * shard from another thread are registered (and deregistered) by a closure
+ * posted to the shard's \c RunLoop; the calling thread waits for that
+ * closure to run, so the change has taken effect, and any error it raised
+ * has been passed on, by the time the call returns.
+ */
+class LoopGroup
+{
+    RF_CK_FACTORY_COMPATIBLE(LoopGroup);
+
+public:
+    /**
+     * \brief How \c addInputSource() picks a shard.
+     */
+    enum Placement
+    {
+        /**
+         * \brief Hash the file descriptor; see \c shardForFd().
+         */
+        PL_HASH = 0,
+        /**
+         * \brief Use the shard with the fewest input sources.
+         */
+        PL_LEAST_LOADED
+    };
+
+private:
+    /**
+     * \brief Behavior of one worker thread.
+     */
+    class Shard : public ThreadDelegate
+    {
+    public:
+        Shard(unsigned index, cpu_set_t const* affinity);
+        virtual ~Shard();
+
+        virtual void doThreadLogic(Thread *theThread);
+
+        unsigned index;
+        bool pinned;
+        cpu_set_t affinity;
+        Thread *thread;
+        std::atomic< size_t > load;
+    };
+
+    typedef std::unordered_map< int, unsigned > OwnerMap;
+
+    std::vector< Shard* > m_shards;
+    OwnerMap m_owners;
+    mutable pthread_mutex_t m_ownersMutex;
+    std::atomic< bool > m_stopRequested;
+
+    LoopGroup(LoopGroup const& other);
+    LoopGroup& operator=(LoopGroup const& other);
+
+    bool isShardThread(unsigned shard) const;
+    bool applyOnShard(unsigned shard, TaskQueue::Task const& change);
+    void registerOnShard(InputSource *inputSource, unsigned shard);
+    void releaseClaim(int fd, unsigned shard);
+
+public:
+    /**
+     * \brief Start the worker threads.
+     *
+     * \param[in] hostApp - Application the worker threads belong to; may be
+     *            \c NULL.
+     * \param[in] shardCount - Number of worker threads.
+     * \param[in] affinities - CPU affinity of each worker thread; worker
+     *            \c n is pinned to <tt>affinities[n % affinities.size()]</tt>.
+     *            Workers are left unpinned if empty.
+     *
+     * \throw PreconditionNotMetException if \c shardCount is zero.
+     */
+    LoopGroup(Application *hostApp, unsigned shardCount, std::vector< cpu_set_t > const& affinities = std::vector< cpu_set_t >());
+
+    /**
+     * \brief Destructor; stops the worker threads and waits for them.
+     */
+    ~LoopGroup();
+
+    /**
+     * \brief Access the number of worker threads.
+     *
+     * \return Number of shards in this group.
+     */
+    inline unsigned size() const { return static_cast<unsigned>(m_shards.size()); }
+
+    /**
+     * \brief Access the \c RunLoop of a worker thread.
+     *
+     * \param[in] shard - Shard index, less than \c size().
+     *
+     * \return Run loop serviced by the shard.
+     */
+    RunLoop* runLoop(unsigned shard) const;
+
+    /**
+     * \brief Access the \c RunLoop of the calling thread, if it is a shard.
+     *
+     * \return Run loop serviced by the calling thread; \c NULL if the calling
+     *         thread is not part of this group.
+     */
+    RunLoop* currentRunLoop() const;
+
+    /**
+     * \brief Access the number of input sources serviced by a shard.
+     *
+     * \param[in] shard - Shard index, less than \c size().
+     *
+     * \return Input sources currently assigned to the shard.
+     */
+    size_t load(unsigned shard) const;
+
+    /**
+     * \brief Pick a shard by hashing a file descriptor.
+     *
+     * The result only depends on the descriptor and the size of the group,
+     * so it may be used to agree on a shard before the descriptor is
+     * handed to the group.
+     *
+     * \param[in] fd - File descriptor.
+     *
+     * \return Shard index.
+     */
+    unsigned shardForFd(int fd) const;
+
+    /**
+     * \brief Pick the shard with the fewest input sources.
+     *
+     * \return Shard index; ties go to the lowest index.
+     */
+    unsigned leastLoadedShard() const;
+
+    /**
+     * \brief Hand an input source to a shard chosen by the group.
+     *
+     * \param[in] inputSource - Input source to service.
+     * \param[in] placement - How to choose the shard.
+     *
+     * \return Index of the shard that services the input source.
+     *
+     * \throw PreconditionNotMetException if the file descriptor of the
+     *        input source is already owned by a shard, or if the chosen
+     *        shard has stopped.
+     *
+     * Errors raised by \c RunLoop::registerInputSource() on the shard are
+     * thrown here as well; the input source is then not handed to the
+     * group.
+     */
+    unsigned addInputSource(InputSource *inputSource, Placement placement = PL_HASH);
+
+    /**
+     * \brief Hand an input source to a specific shard.
+     *
+     * \param[in] inputSource - Input source to service.
+     * \param[in] shard - Shard index, less than \c size().
+     *
+     * \throw PreconditionNotMetException if \c shard is out of range, if
+     *        the file descriptor of the input source is already owned by a
+     *        shard, or if the shard has stopped.
+     *
+     * Errors raised by \c RunLoop::registerInputSource() on the shard are
+     * thrown here as well; the input source is then not handed to the
+     * group.
+     */
+    void addInputSourceToShard(InputSource *inputSource, unsigned shard);
+
+    /**
+     * \brief Stop servicing an input source.
+     *
+     * Once this returns, the owning shard no longer touches the input
+     * source, which may then be closed or destroyed right away. A shard
+     * that stopped before it got to the deregistration is left alone, as it
+     * no longer services anything.
+     *
+     * \param[in] inputSource - Input source previously handed to the group.
+     *
+     * \return Index of the shard that serviced the input source; -1 if it
+     *         was not handed to the group.
+     */
+    int removeInputSource(InputSource *inputSource);
+
+    /**
+     * \brief Look up the shard that owns a file descriptor.
+     *
+     * \param[in] fd - File descriptor.
+     *
+     * \return Shard index; -1 if no input source with that descriptor was
+     *         handed to the group.
+     */
+    int ownerOf(int fd) const;
+
+    /**
+     * \brief Access the \c RunLoop of the shard that owns a file descriptor.
+     *
+     * \param[in] fd - File descriptor.
+     *
+     * \return Run loop of the owning shard or, if the descriptor is not
+     *         owned, of the shard given by \c shardForFd().
+     */
+    RunLoop* runLoopForFd(int fd) const;
+
+    /**
+     * \brief Run a closure on the shard that owns a file descriptor.
+     *
+     * \param[in] fd - File descriptor.
+     * \param[in] task - Closure to run; see \c RunLoop::post().
+     *
+     * \return \c true if the closure was queued; \c false if it was
+     *         dropped.
+     */
+    bool postToOwner(int fd, TaskQueue::Task task);
+
+    /**
+     * \brief Ask every worker thread to terminate its \c RunLoop.
+     *
+     * Returns right away; the destructor waits for the threads.
+     */
+    void stop();
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_LOOPGROUP_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -12,28 +12,76 @@
 #include <cstring>
 #include <algorithm>
 #include <functional>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <time.h>
 
+#include "Application.h"
+#include "IoUring.h"
 #include "RunLoop.h"
 #include "Thread.h"
+#include "WatchdogService.h"
+
 #include "SignalInputSource.h"
 #include "OsErrorException.h"
+#include "PreconditionNotMetException.h"
 
 #define RF_RL_MAX_SIMULT_EVENTS (10u)
+#define RF_RL_MAX_EVENT_BATCH_SIZE (1024u)
 #define RF_RL_EPOLL_TIMEOUT (1000u)
+#define RF_RL_TIMER_WHEEL_TICK (0.0)
+#define RF_RL_POST_QUEUE_CAPACITY (4096u)
+#define RF_RL_SPIN_BUDGET (0.0)
+#define RF_RL_SOCKET_BUSY_POLL_US (0)
+#define RF_RL_DISPATCH_STATS_LOG_INTERVAL (0.0)
+#define RF_RL_DISPATCH_BUDGET (0.0)
+#define RF_RL_NO_DISPATCH_DEADLINE (UINT64_MAX)
+#define RF_RL_URING_ENTRIES (256u)
+#define RF_RL_URING_BUFFER_COUNT (256u)
+#define RF_RL_URING_BUFFER_SIZE (2048u)
+#define RF_RL_IDLE_BUDGET (0.001)
+#define RF_RL_SLACK_TIMER_WHEEL_TICK (0.001)
+/*
+ * Completions of io_uring requests that no input source waits on, such as
+ * cancellations, carry this value.
+ */
+#define RF_RL_URING_IGNORED (UINT64_MAX)
+/*
+ * Layout of the payload stored alongside pre-read activity: a flag marking
+ * the activity as pre-read input, a flag marking it as holding a provided
+ * buffer, the buffer identifier, and the result of the read.
+ */
+#define RF_RL_PAYLOAD_DATA (1uLL << 63u)
+#define RF_RL_PAYLOAD_BUFFER (1uLL << 62u)
+#define RF_RL_PAYLOAD_BID_SHIFT (32u)
+#define RF_RL_PAYLOAD_BID_MASK (0xFFFFuLL)
 
 using std::find;
 using std::for_each;
 using std::mem_fun;
 using std::ptr_fun;
-using std::priority_queue;
 using std::bind1st;
 using std::map;
 using CoreKit::RunLoop;
 using CoreKit::InterruptListener;
 using CoreKit::SignalInputSource;
 using CoreKit::TimerInputSource;
+using CoreKit::TimerWheel;
+using CoreKit::WatchdogService;
+using CoreKit::TimerStatistics;
+using CoreKit::TaskQueue;
+using CoreKit::FramePool;
+using CoreKit::IoUring;
+using CoreKit::LatencyHistogram;
+using CoreKit::LoopCallback;
+using CoreKit::LoopCallbackHandle;
+using CoreKit::AppLog;
+using CoreKit::EndLog;
+
 using CoreKit::InputSource;
 using CoreKit::OsErrorException;
+using CoreKit::PreconditionNotMetException;
 
 /**
  * \brief Delete an \c InputSource instance if It Represents a Timer or Signal
@@ -72,15 +120,165 @@ static void deleteLoopIterCb(RunLoop::LoopIterCbBase *aLoopIterCb)
 }
 
 
+/**
+ * \brief Read the Monotonic Clock, in Seconds
+ */
+static double monotonicSecs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+}
+
+
+/**
+ * \brief Read the Monotonic Clock, in Nanoseconds
+ */
+static uint64_t monotonicNs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000uLL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+
+/**
+ * \brief Order Dispatch Statistics by Longest Callback Duration First
+ */
+static bool longestCallbackFirst(RunLoop::DispatchStatistics const& lhs, RunLoop::DispatchStatistics const& rhs)
+{
+    return lhs.callbackDuration.maxNs() > rhs.callbackDuration.maxNs();
+}
+
+
+namespace
+{
+
+/**
+ * \brief Timer Listener that Writes a \c RunLoop's Dispatch Statistics Report
+ */
+class DispatchStatsReporter : public InterruptListener
+{
+public:
+    explicit DispatchStatsReporter(RunLoop *runLoop)
+    : m_runLoop(runLoop)
+    {
+
+    }
+
+    virtual void timerExpired(int /* timerId */)
+    {
+        m_runLoop->logDispatchStatistics();
+        m_runLoop->resetDispatchStatistics();
+    }
+
+private:
+    RunLoop *m_runLoop;
+};
+
+} // end anonymous namespace
+
+
+/**
+ * \brief Configuration Handed to \c RunLoop Instances Built Without One
+ */
+static RunLoop::Configuration S_defaultConfiguration;
+
+
+RunLoop::Configuration::Configuration()
+: initialEventBatchSize(RF_RL_MAX_SIMULT_EVENTS), maxEventBatchSize(RF_RL_MAX_EVENT_BATCH_SIZE),
+  waitTimeoutMs(RF_RL_EPOLL_TIMEOUT), timerWheelTick(RF_RL_TIMER_WHEEL_TICK),
+  postQueueCapacity(RF_RL_POST_QUEUE_CAPACITY), postOverflowPolicy(TaskQueue::OP_BLOCK),
+  spinBudget(RF_RL_SPIN_BUDGET), socketBusyPollUs(RF_RL_SOCKET_BUSY_POLL_US),
+  collectDispatchStats(false), dispatchStatsLogInterval(RF_RL_DISPATCH_STATS_LOG_INTERVAL),
+  dispatchBudget(RF_RL_DISPATCH_BUDGET), backend(BK_EPOLL), uringEntries(RF_RL_URING_ENTRIES),
+  uringBufferCount(RF_RL_URING_BUFFER_COUNT), uringBufferSize(RF_RL_URING_BUFFER_SIZE),
+  idleBudget(RF_RL_IDLE_BUDGET)
+{
+
+}
+
+
+RunLoop::Statistics::Statistics()
+: spinPolls(0u), spinHits(0u), blockingWaits(0u), spinSeconds(0.0), sleepSeconds(0.0),
+  busyPollSockets(0u), busyPollFailures(0u), budgetExhaustions(0u), redispatches(0u),
+  uringBufferShortages(0u), idlePasses(0u), idleBudgetExhaustions(0u)
+{
+
+}
+
+
+RunLoop::Configuration const& RunLoop::defaultConfiguration()
+{
+    return S_defaultConfiguration;
+}
+
+
+void RunLoop::setDefaultConfiguration(RunLoop::Configuration const& config)
+{
+    S_defaultConfiguration = config;
+}
+
+
 RunLoop::RunLoop()
-: m_epollFd(-1), m_terminationRequested(false), m_sortedActivityQueue(RunLoop::InputSourceSort()),
-  m_hostThread(NULL)
+: RunLoop(S_defaultConfiguration)
+{
+
+}
+
+
+RunLoop::RunLoop(RunLoop::Configuration const& config)
+: m_timerWheel(nullptr), m_framePool(nullptr), m_watchdogService(nullptr), m_taskQueue(nullptr), m_statsReporter(nullptr),
+  m_statsReportTimerId(-1), m_statsReportInterval(0.0),
+ m_dispatchDeadlineNs(RF_RL_NO_DISPATCH_DEADLINE), m_epollFd(-1),
+  m_ioUring(nullptr), m_terminationRequested(false), m_firingLoopCbs(false), m_loopCbsRemoved(false),
+  m_nextIdleCb(0u), m_iterationDispatches(0u), m_hostThread(NULL)
 {
-    m_epollFd = epoll_create(RF_RL_MAX_SIMULT_EVENTS);
-    if (-1 == m_epollFd)
+    memset(&m_uringMsgHdr, 0x00, sizeof(m_uringMsgHdr));
+    m_uringMsgHdr.msg_namelen = sizeof(struct sockaddr_storage);
+
+    if (BK_IO_URING == config.backend)
+    {
+        try
+        {
+            m_ioUring = new IoUring(config.uringEntries);
+        }
+        catch (OsErrorException& ex)
+        {
+            if (G_MyApp != NULL)
+            {
+                G_MyApp->log() << AppLog::LL_WARNING << "io_uring unavailable, falling back to epoll: " << ex.what() << EndLog;
+            }
+            m_ioUring = nullptr;
+        }
+
+        /*
+         * Without provided buffers the ring still collects activity; input
+         * sources simply read their own input.
+         */
+        if ((m_ioUring != nullptr) && (config.uringBufferCount > 0u) && (config.uringBufferSize > 0u) &&
+            !m_ioUring->setupBufferRing(config.uringBufferCount, config.uringBufferSize) && (G_MyApp != NULL))
+        {
+            G_MyApp->log() << AppLog::LL_WARNING << "io_uring provided buffers unavailable; input sources will read their own input" << EndLog;
+        }
+    }
+
+    if (nullptr == m_ioUring)
     {
-        throw OsErrorException("epoll_create", errno);
+        m_epollFd = epoll_create(RF_RL_MAX_SIMULT_EVENTS);
+        if (-1 == m_epollFd)
+        {
+            throw OsErrorException("epoll_create", errno);
+        }
     }
+
+    m_taskQueue = new TaskQueue(config.postQueueCapacity, config.postOverflowPolicy);
+    this->registerInputSource(m_taskQueue);
+    this->setConfiguration(config);
 }
 
 
@@ -91,12 +289,39 @@ RunLoop::~RunLoop()
         close(m_epollFd);
     }
 
+    delete m_ioUring;
+    m_ioUring = nullptr;
+
+
     /*
      * We only delete timer and signal input sources, because we do not own
      * the other generic input sources.
      */
-    for_each(m_inputSources.begin(), m_inputSources.end(), ptr_fun(&deleteSignalAndTimerIs));
-    m_inputSources.clear();
+    for (SourceSlot const& aSlot : m_sourceSlots)
+    {
+        if (aSlot.source != nullptr)
+        {
+            deleteSignalAndTimerIs(aSlot.source);
+        }
+    }
+    m_sourceSlots.clear();
+    m_freeSourceSlots.clear();
+    m_sourceSlotIndex.clear();
+
+    delete m_timerWheel;
+    m_timerWheel = nullptr;
+
+    delete m_watchdogService;
+    m_watchdogService = nullptr;
+
+    delete m_statsReporter;
+    m_statsReporter = nullptr;
+
+    delete m_framePool;
+    m_framePool = nullptr;
+
+    delete m_taskQueue;
+    m_taskQueue = nullptr;
 
     for_each(m_loopIterEndCb.begin(), m_loopIterEndCb.end(), ptr_fun(&deleteLoopIterCb));
     m_loopIterEndCb.clear();
@@ -105,17 +330,49 @@ RunLoop::~RunLoop()
 
 void RunLoop::deregisterInputSource(InputSource* theInputSource)
 {
-    auto isIter = find(
-        m_inputSources.begin(),
-        m_inputSources.end(),
-        theInputSource
-    );
+    auto isIter = m_sourceSlotIndex.find(theInputSource);
 
-    if (isIter != m_inputSources.end())
+    if (isIter != m_sourceSlotIndex.end())
     {
-        m_inputSources.erase(isIter);
+        uint32_t slotIdx = (*isIter).second;
         struct epoll_event anEvent;
 
+        /*
+         * Retire the slot by bumping its generation. Any event for this input
+         * source still waiting in the current dispatch batch carries the old
+         * generation and will be skipped rather than dereferenced.
+         */
+        m_sourceSlotIndex.erase(isIter);
+        m_sourceSlots[slotIdx].source = nullptr;
+        m_sourceSlots[slotIdx].generation++;
+        m_sourceSlots[slotIdx].redispatchPending = false;
+        m_freeSourceSlots.push_back(slotIdx);
+        if (slotIdx < m_dispatchStats.size())
+        {
+            m_dispatchStats[slotIdx].source = nullptr;
+        }
+
+        if (m_ioUring != nullptr)
+        {
+            /*
+             * The generation bump already makes the RunLoop ignore whatever
+             * the outstanding operation still reports. Cancelling it right
+             * away lets the caller close the file descriptor safely.
+             */
+            if (m_sourceSlots[slotIdx].uringArmed)
+            {
+                struct io_uring_sqe *theSqe = m_ioUring->nextSqe();
+
+                theSqe->opcode = IORING_OP_ASYNC_CANCEL;
+                theSqe->fd = -1;
+                theSqe->addr = makeSourceHandle(slotIdx, m_sourceSlots[slotIdx].generation - 1u);
+                theSqe->user_data = RF_RL_URING_IGNORED;
+                m_sourceSlots[slotIdx].uringArmed = false;
+                m_ioUring->submit();
+            }
+            return;
+        }
+
         // Initialize the epoll() event instance that will be used to remove
         // the input source's file descriptor with our epoll() service
         // instance.
@@ -142,29 +399,77 @@ void RunLoop::deregisterInputSource(InputSource* theInputSource)
 void RunLoop::registerInputSource(InputSource* inputSource)
 {
     struct epoll_event anEvent;
+    uint32_t slotIdx = 0u;
 
     if (nullptr == inputSource)
     {
         return;
     }
 
+    /*
+     * Recycle a retired slot if one is available. The slot keeps its
+     * generation count, so handles issued for its previous occupant remain
+     * distinguishable from the ones issued for the new occupant.
+     */
+    if (m_freeSourceSlots.empty())
+    {
+        SourceSlot newSlot = { nullptr, 0u, false, UO_POLL, false };
+        m_sourceSlots.push_back(newSlot);
+        slotIdx = static_cast<uint32_t>(m_sourceSlots.size() - 1u);
+    }
+    else
+    {
+        slotIdx = m_freeSourceSlots.back();
+        m_freeSourceSlots.pop_back();
+    }
+
+    if (m_ioUring != nullptr)
+    {
+        m_sourceSlots[slotIdx].source = inputSource;
+        m_sourceSlots[slotIdx].uringOp = this->uringOpFor(inputSource);
+        m_sourceSlots[slotIdx].uringArmed = false;
+        m_sourceSlotIndex[inputSource] = slotIdx;
+        this->armUringSource(slotIdx);
+
+        if (m_configuration.socketBusyPollUs > 0)
+        {
+            this->applyBusyPoll(inputSource->fileDescriptor());
+        }
+        return;
+    }
+
     /*
      * Initialize the epoll() event instance that will be used to register the
      * new input source's file descriptor with our epoll() service instance.
-     * In doing so, we're storing a pointer to the input source in the epoll
-     * event structure so that when this input source exhibits activity we can
-     * quickly schedule their work.
+     * In doing so, we're storing the slot index and generation of the input
+     * source in the epoll event structure so that when this input source
+     * exhibits activity we can quickly schedule their work. Edge-triggered
+     * input sources have agreed to drain their file descriptor every time
+     * they are serviced, so they are only reported when new input arrives.
      */
     memset(&anEvent, 0x00, sizeof(anEvent));
-    anEvent.events = EPOLLIN;
-    anEvent.data.ptr = inputSource;
+    anEvent.events = EPOLLIN | (inputSource->edgeTriggered() ? EPOLLET : 0u);
+    anEvent.data.u64 = makeSourceHandle(slotIdx, m_sourceSlots[slotIdx].generation);
 
     if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, inputSource->fileDescriptor(), &anEvent) == -1)
     {
+        m_freeSourceSlots.push_back(slotIdx);
         throw OsErrorException("epoll_ctl", errno);
     }
 
-    m_inputSources.push_back(inputSource);
+    m_sourceSlots[slotIdx].source = inputSource;
+    m_sourceSlotIndex[inputSource] = slotIdx;
+
+    if (m_configuration.socketBusyPollUs > 0)
+    {
+        this->applyBusyPoll(inputSource->fileDescriptor());
+    }
+}
+
+
+bool RunLoop::isRegistered(InputSource* inputSource) const
+{
+    return (m_sourceSlotIndex.find(inputSource) != m_sourceSlotIndex.end());
 }
 
 
@@ -183,6 +488,11 @@ int RunLoop::registerTimerWithInterval(double timeInterval, InterruptListener* t
 {
     TimerInputSource *aTimerIs = NULL;
 
+    if (m_configuration.timerWheelTick > 0.0)
+    {
+        return this->timerWheel()->arm(timeInterval, (repeats ? timeInterval : 0.0), theListener);
+    }
+
     aTimerIs = new TimerInputSource(timeInterval, repeats, theListener);
     this->registerInputSource(aTimerIs);
     m_timers[aTimerIs->fileDescriptor()] = aTimerIs;
@@ -194,6 +504,11 @@ int RunLoop::registerTimerWithInterval(double timeInterval, InterruptListener* t
 int RunLoop::registerTimerWithInterval(double firstTimeout, double timeInterval, InterruptListener *theListener)
 {
     TimerInputSource *aTimerIs = NULL;
+
+    if (m_configuration.timerWheelTick > 0.0)
+    {
+        return this->timerWheel()->arm(firstTimeout, timeInterval, theListener);
+    }
     
     aTimerIs = new TimerInputSource(firstTimeout, timeInterval, theListener);
     this->registerInputSource(aTimerIs);
@@ -203,9 +518,85 @@ int RunLoop::registerTimerWithInterval(double firstTimeout, double timeInterval,
 }
 
 
+int RunLoop::registerTimerWithSlack(double firstTimeout, double timeInterval, double slack, InterruptListener *theListener)
+{
+    return this->timerWheel()->arm(firstTimeout, timeInterval, theListener, slack);
+}
+
+
+bool RunLoop::setTimerSlack(int timerId, double slack)
+{
+    if (!TimerWheel::isWheelTimerId(timerId) || (nullptr == m_timerWheel))
+    {
+        return false;
+    }
+
+    return m_timerWheel->setSlack(timerId, slack);
+}
+
+
+int RunLoop::registerPreciseTimer(double firstTimeout, double timeInterval, InterruptListener *theListener, clockid_t clockId)
+{
+    TimerInputSource *aTimerIs = NULL;
+
+    aTimerIs = new TimerInputSource(firstTimeout, timeInterval, clockId, theListener);
+    this->registerInputSource(aTimerIs);
+    m_timers[aTimerIs->fileDescriptor()] = aTimerIs;
+
+    return aTimerIs->fileDescriptor();
+}
+
+
+int RunLoop::registerTimerAtDeadline(struct timespec const& firstDeadline, double timeInterval, InterruptListener *theListener, clockid_t clockId)
+{
+    TimerInputSource *aTimerIs = NULL;
+
+    aTimerIs = new TimerInputSource(firstDeadline, timeInterval, clockId, theListener);
+    this->registerInputSource(aTimerIs);
+    m_timers[aTimerIs->fileDescriptor()] = aTimerIs;
+
+    return aTimerIs->fileDescriptor();
+}
+
+
+TimerStatistics const* RunLoop::timerStatistics(int timerId) const
+{
+    map<int, TimerInputSource*>::const_iterator timerEntry;
+
+    timerEntry = m_timers.find(timerId);
+    if (timerEntry != m_timers.end())
+    {
+        return &(*timerEntry).second->statistics();
+    }
+
+    return nullptr;
+}
+
+
+void RunLoop::resetTimerStatistics(int timerId)
+{
+    map<int, TimerInputSource*>::iterator timerEntry;
+
+    timerEntry = m_timers.find(timerId);
+    if (timerEntry != m_timers.end())
+    {
+        (*timerEntry).second->resetStatistics();
+    }
+}
+
+
 void RunLoop::deregisterTimer(int timerId)
 {
     map<int, TimerInputSource*>::iterator timerEntry;
+
+    if (TimerWheel::isWheelTimerId(timerId))
+    {
+        if (m_timerWheel != nullptr)
+        {
+            m_timerWheel->cancel(timerId);
+        }
+        return;
+    }
     
     timerEntry = m_timers.find(timerId);
     if (timerEntry != m_timers.end())
@@ -219,85 +610,1194 @@ void RunLoop::deregisterTimer(int timerId)
 }
 
 
-void RunLoop::addLoopIterEndCallback(RunLoop::LoopIterCbBase *loopIterEndCb)
+void RunLoop::rearmTimer(int timerId)
 {
-    m_loopIterEndCb.push_back(loopIterEndCb);
+    map<int, TimerInputSource*>::iterator timerEntry;
+
+    if (TimerWheel::isWheelTimerId(timerId))
+    {
+        if (m_timerWheel != nullptr)
+        {
+            m_timerWheel->rearm(timerId);
+        }
+        return;
+    }
+
+    timerEntry = m_timers.find(timerId);
+    if (timerEntry != m_timers.end())
+    {
+        (*timerEntry).second->rearm();
+    }
 }
 
 
-void RunLoop::run()
+TimerWheel* RunLoop::timerWheel()
 {
-    struct epoll_event theEvents[RF_RL_MAX_SIMULT_EVENTS];
-    int numFds = 0;
-    InputSource *anInputSource = NULL;
-
     /*
-     * This loop continues to run until a termination is requested as evident
-     * by the value of the m_terminationRequested instance field.
+     * The wheel, and its timerfd(), are only created once the first timer is
+     * registered, so loops that never use timers do not pay for it. Timers
+     * with slack need the wheel even when it is not enabled for the others.
      */
-    do
+    if (nullptr == m_timerWheel)
     {
-        numFds = epoll_wait(m_epollFd, &theEvents[0], RF_RL_MAX_SIMULT_EVENTS, RF_RL_EPOLL_TIMEOUT);
-        if (numFds > 0)
-        {
-            /*
-             * Store all the events that epoll_wait() detected into a
-             * prioritized queue. Then process each event from highest priority
-             * to lowest.
-             */
-            for_each(&theEvents[0], &theEvents[numFds], bind1st(mem_fun(&RunLoop::pushEpollEventInputSource), this));
-            while (!m_terminationRequested && (m_sortedActivityQueue.size() > 0))
-            {
-                /*
-                 * The InputSource instance pointer is stored in the event
-                 * definition, so in order to schedule the work for this source
-                 * all we have to do is typecast the "ptr" union member of the
-                 * "data" event structure member, and call its "fireCallback()"
-                 * method. The InputSource will know what to do from there.
-                 */
-                anInputSource = m_sortedActivityQueue.top();
-                anInputSource->fireCallback();
-
-                m_sortedActivityQueue.pop();
-            }
-        }
+        m_timerWheel = new TimerWheel((m_configuration.timerWheelTick > 0.0) ? m_configuration.timerWheelTick : RF_RL_SLACK_TIMER_WHEEL_TICK);
+        this->registerInputSource(m_timerWheel);
+    }
 
-        /*
-         * Invoke the end-of-loop list of callbacks.
-         */
-        if (!m_terminationRequested)
-        {
-            this->fireEndOfLoopCbs();
-        }
-    } while (false == m_terminationRequested);
+    return m_timerWheel;
 }
 
 
-bool RunLoop::InputSourceSort::operator()(InputSource *left, InputSource *right)
+FramePool* RunLoop::framePool()
 {
-    bool result = true;
+    if (nullptr == m_framePool)
+    {
+        m_framePool = new FramePool();
+    }
 
-    /*
-     * Lower relative priority values translate to a higher priority.
-     */
-    if (left->relativePriority() < right->relativePriority())
+    return m_framePool;
+}
+
+
+WatchdogService* RunLoop::watchdogService()
+{
+    if (nullptr == m_watchdogService)
     {
-        result = false;
+        m_watchdogService = new WatchdogService();
+        this->registerInputSource(m_watchdogService);
     }
 
-    return result;
+    return m_watchdogService;
 }
 
 
-void RunLoop::fireEndOfLoopCbs()
+void RunLoop::addLoopIterEndCallback(RunLoop::LoopIterCbBase *loopIterEndCb)
 {
-    for_each(m_loopIterEndCb.begin(), m_loopIterEndCb.end(), bind2nd(mem_fun(&LoopIterCbBase::operator()), this));
+    m_loopIterEndCb.push_back(loopIterEndCb);
+    this->addLoopCallback(LC_ITERATION_END, [loopIterEndCb](RunLoop *theRunLoop) { (*loopIterEndCb)(theRunLoop); });
 }
 
 
-void RunLoop::pushEpollEventInputSource(struct epoll_event anEvent)
+LoopCallbackHandle RunLoop::addLoopCallback(RunLoop::LoopCallbackKind kind, LoopCallback callback)
 {
-    m_sortedActivityQueue.push(reinterpret_cast<InputSource*>(anEvent.data.ptr));
+    LoopCallbackHandle result;
+    uint32_t slotIdx = 0u;
+
+    if ((kind < LC_ITERATION_END) || (kind >= LC_KIND_COUNT) || !callback)
+    {
+        throw PreconditionNotMetException("Can not register an empty loop callback, or one of an unknown kind.");
+    }
+
+    if (!m_freeLoopCbSlots.empty())
+    {
+        slotIdx = m_freeLoopCbSlots.back();
+        m_freeLoopCbSlots.pop_back();
+    }
+    else
+    {
+        slotIdx = static_cast<uint32_t>(m_loopCbSlots.size());
+        m_loopCbSlots.push_back(LoopCallbackSlot());
+        m_loopCbSlots.back().generation = 1u;
+    }
+
+    LoopCallbackSlot& theSlot = m_loopCbSlots[slotIdx];
+    theSlot.callback = std::move(callback);
+    theSlot.kind = kind;
+    theSlot.live = true;
+    m_loopCbOrder[kind].push_back(slotIdx);
+
+    result.index = slotIdx;
+    result.generation = theSlot.generation;
+
+    return result;
 }
 
+
+bool RunLoop::removeLoopCallback(LoopCallbackHandle& handle)
+{
+    bool result = false;
+
+    if (handle.isValid() && (handle.index < m_loopCbSlots.size()))
+    {
+        LoopCallbackSlot& theSlot = m_loopCbSlots[handle.index];
+
+        if (theSlot.live && (theSlot.generation == handle.generation))
+        {
+            /*
+             * A callback may be removing itself, so while callbacks run the
+             * slot is only marked; it is released once they are done.
+             */
+            theSlot.live = false;
+            m_loopCbsRemoved = true;
+            result = true;
+            if (!m_firingLoopCbs)
+            {
+                this->purgeRemovedLoopCbs();
+            }
+        }
+    }
+    handle = LoopCallbackHandle();
+
+    return result;
+}
+
+
+bool RunLoop::post(TaskQueue::Task task)
+{
+    return m_taskQueue->post(std::move(task));
+}
+
+
+bool RunLoop::post(TaskQueue::Task task, TaskQueue::OverflowPolicy policy)
+{
+    return m_taskQueue->post(std::move(task), policy);
+}
+
+
+size_t RunLoop::postBatch(std::vector<TaskQueue::Task>& tasks)
+{
+    return m_taskQueue->postBatch(tasks, m_taskQueue->defaultPolicy());
+}
+
+
+void RunLoop::setConfiguration(RunLoop::Configuration const& config)
+{
+    m_configuration = config;
+    m_configuration.backend = ((m_ioUring != nullptr) ? BK_IO_URING : BK_EPOLL);
+
+    /*
+     * Sanitize the settings so that the event array always has room for at
+     * least one event, and the growth limit is never below the initial size.
+     */
+    if (0u == m_configuration.initialEventBatchSize)
+    {
+        m_configuration.initialEventBatchSize = 1u;
+    }
+    if (m_configuration.maxEventBatchSize < m_configuration.initialEventBatchSize)
+    {
+        m_configuration.maxEventBatchSize = m_configuration.initialEventBatchSize;
+    }
+
+    /*
+     * The event array is resized right away, unless it has already grown
+     * past the new initial size and remains within the new limit.
+     */
+    if ((m_eventBuffer.size() < m_configuration.initialEventBatchSize) ||
+        (m_eventBuffer.size() > m_configuration.maxEventBatchSize))
+    {
+        m_eventBuffer.resize(m_configuration.initialEventBatchSize);
+    }
+    m_sortedActivityQueue.reserve(m_eventBuffer.size());
+
+    if (m_taskQueue != nullptr)
+    {
+        m_taskQueue->setDefaultPolicy(m_configuration.postOverflowPolicy);
+    }
+
+    this->updateDispatchStatsReport();
+}
+
+
+void RunLoop::run()
+{
+    m_taskQueue->setConsumerThread(pthread_self());
+
+    /*
+     * This loop continues to run until a termination is requested as evident
+     * by the value of the m_terminationRequested instance field.
+     */
+    do
+    {
+        /*
+         * Collect all the activity detected into a prioritized queue. Then
+         * process each input source from highest priority to lowest; input
+         * sources with the same priority are processed in the order their
+         * activity was reported.
+         */
+        this->waitForEvents();
+        this->dispatchActivity();
+        this->dispatchRedispatches();
+
+        /*
+         * Invoke the end-of-loop list of callbacks.
+         */
+        if (!m_terminationRequested)
+        {
+            this->fireEndOfLoopCbs();
+        }
+    } while (false == m_terminationRequested);
+
+    /*
+     * Activity left over from the final iteration is stale by the time this
+     * loop could run again.
+     */
+    this->discardActivity();
+}
+
+
+void RunLoop::terminate()
+{
+    m_terminationRequested.store(true, std::memory_order_release);
+
+    /*
+     * Wake the loop up in case it is blocked waiting for input; the task
+     * queue drains nothing, and the loop then sees the flag. Threads waiting
+     * for room in the queue must not wait on a loop that is going away.
+     */
+    if (m_taskQueue != nullptr)
+    {
+        m_taskQueue->shutDown();
+        m_taskQueue->wake();
+    }
+}
+
+
+void RunLoop::fireEndOfLoopCbs()
+{
+    uint64_t startNs = 0u;
+    bool hadActivity = (m_iterationDispatches > 0u);
+    bool timed = m_configuration.collectDispatchStats &&
+                 (!m_loopCbOrder[LC_ITERATION_END].empty() || (hadActivity && !m_loopCbOrder[LC_AFTER_ACTIVITY].empty()));
+
+    m_iterationDispatches = 0u;
+    if (timed)
+    {
+        startNs = monotonicNs();
+    }
+
+    this->fireLoopCbs(LC_ITERATION_END);
+    if (hadActivity)
+    {
+        this->fireLoopCbs(LC_AFTER_ACTIVITY);
+    }
+
+    if (timed)
+    {
+        m_endOfLoopDuration.record(monotonicNs() - startNs);
+    }
+}
+
+
+void RunLoop::fireLoopCbs(RunLoop::LoopCallbackKind kind)
+{
+    std::vector<uint32_t>& cbOrder = m_loopCbOrder[kind];
+    size_t cbCount = cbOrder.size();
+
+    if (0u == cbCount)
+    {
+        return;
+    }
+
+    /*
+     * Only the callbacks present when the pass started run; the slots live
+     * in a deque, so callbacks added meanwhile do not move them.
+     */
+    m_firingLoopCbs = true;
+    try
+    {
+        for (size_t cbIdx = 0u; cbIdx < cbCount; ++cbIdx)
+        {
+            LoopCallbackSlot& aSlot = m_loopCbSlots[cbOrder[cbIdx]];
+
+            if (aSlot.live)
+            {
+                aSlot.callback(this);
+            }
+        }
+    }
+    catch (...)
+    {
+        m_firingLoopCbs = false;
+        this->purgeRemovedLoopCbs();
+        throw;
+    }
+    m_firingLoopCbs = false;
+    this->purgeRemovedLoopCbs();
+}
+
+
+bool RunLoop::fireIdleCbs()
+{
+    std::vector<uint32_t>& idleOrder = m_loopCbOrder[LC_IDLE];
+    size_t cbCount = idleOrder.size();
+    uint64_t deadlineNs = RF_RL_NO_DISPATCH_DEADLINE;
+    bool result = true;
+
+    if (0u == cbCount)
+    {
+        return true;
+    }
+
+    if (m_configuration.idleBudget > 0.0)
+    {
+        deadlineNs = monotonicNs() + static_cast<uint64_t>(m_configuration.idleBudget * 1e9);
+    }
+    m_statistics.idlePasses++;
+
+    /*
+     * Each pass picks up where the last one stopped, so a callback placed
+     * late in the list is not starved when the budget is tight.
+     */
+    m_firingLoopCbs = true;
+    try
+    {
+        for (size_t cbIdx = 0u; (cbIdx < cbCount) && !m_terminationRequested; ++cbIdx)
+        {
+            if (m_nextIdleCb >= cbCount)
+            {
+                m_nextIdleCb = 0u;
+            }
+
+            LoopCallbackSlot& aSlot = m_loopCbSlots[idleOrder[m_nextIdleCb++]];
+
+            if (aSlot.live)
+            {
+                aSlot.callback(this);
+            }
+
+            if (((cbIdx + 1u) < cbCount) && (deadlineNs != RF_RL_NO_DISPATCH_DEADLINE) && (monotonicNs() >= deadlineNs))
+            {
+                m_statistics.idleBudgetExhaustions++;
+                result = false;
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        m_firingLoopCbs = false;
+        this->purgeRemovedLoopCbs();
+        throw;
+    }
+    m_firingLoopCbs = false;
+    this->purgeRemovedLoopCbs();
+
+    return result;
+}
+
+
+void RunLoop::purgeRemovedLoopCbs()
+{
+    if (!m_loopCbsRemoved)
+    {
+        return;
+    }
+    m_loopCbsRemoved = false;
+
+    for (std::vector<uint32_t>& cbOrder : m_loopCbOrder)
+    {
+        size_t keepCount = 0u;
+
+        for (uint32_t slotIdx : cbOrder)
+        {
+            LoopCallbackSlot& aSlot = m_loopCbSlots[slotIdx];
+
+            if (aSlot.live)
+            {
+                cbOrder[keepCount++] = slotIdx;
+                continue;
+            }
+
+            aSlot.callback.reset();
+            if (0u == ++aSlot.generation)
+            {
+                aSlot.generation = 1u;
+            }
+            m_freeLoopCbSlots.push_back(slotIdx);
+        }
+        cbOrder.resize(keepCount);
+    }
+}
+
+
+void RunLoop::pushEpollEventInputSource(struct epoll_event anEvent)
+{
+    InputSource *theInputSource = this->sourceForHandle(anEvent.data.u64);
+
+    /*
+     * Input sources waiting to be serviced again are queued by
+     * dispatchRedispatches(), so they are not serviced twice.
+     */
+    if ((theInputSource != nullptr) &&
+        !m_sourceSlots[static_cast<uint32_t>(anEvent.data.u64 & 0xFFFFFFFFuLL)].redispatchPending)
+    {
+        m_sortedActivityQueue.push(theInputSource, anEvent.data.u64);
+    }
+}
+
+
+int RunLoop::pollActivity(int timeoutMs)
+{
+    int numEvents = 0;
+    IoUring::Completion aCompletion;
+
+    /*
+     * Pre-read input set aside when the last dispatch budget ran out goes
+     * ahead of whatever this poll collects.
+     */
+    for (CarriedActivity const& carried : m_carriedActivity)
+    {
+        m_sortedActivityQueue.push(carried.source, carried.handle, carried.payload);
+    }
+    m_carriedActivity.clear();
+
+    if (nullptr == m_ioUring)
+    {
+        numEvents = epoll_wait(m_epollFd, m_eventBuffer.data(), static_cast<int>(m_eventBuffer.size()), timeoutMs);
+        if (numEvents > 0)
+        {
+            for_each(m_eventBuffer.begin(), m_eventBuffer.begin() + numEvents, bind1st(mem_fun(&RunLoop::pushEpollEventInputSource), this));
+            this->adaptEventBatchSize(numEvents);
+        }
+        return numEvents;
+    }
+
+    /*
+     * Operations re-armed since the last poll are submitted along with the
+     * wait, so re-arming costs no extra system call.
+     */
+    this->flushUringRearms();
+    if (m_ioUring->submitAndWait(timeoutMs) < 0)
+    {
+        numEvents = -1;
+    }
+
+    while (m_ioUring->popCompletion(aCompletion))
+    {
+        this->pushUringCompletion(aCompletion.userData, aCompletion.result, aCompletion.flags);
+        numEvents = ((numEvents < 0) ? 1 : (numEvents + 1));
+    }
+
+    return numEvents;
+}
+
+
+int RunLoop::waitForEvents()
+{
+    int numFds = 0;
+    double spinStart = 0.0;
+    double spinDeadline = 0.0;
+    double now = 0.0;
+    double waitStart = 0.0;
+
+    /*
+     * Input sources waiting to be serviced again make the loop busy, so
+     * only pick up whatever other activity is already available.
+     */
+    if (!m_redispatchHandles.empty() || !m_carriedActivity.empty())
+    {
+        return this->pollActivity(0);
+    }
+
+    /*
+     * Idle callbacks only run once a non-blocking poll finds no input, so
+     * they never hold up input that is already waiting. If the idle budget
+     * ran out, the loop comes back around without blocking to let the rest
+     * run.
+     */
+    if (!m_loopCbOrder[LC_IDLE].empty())
+    {
+        numFds = this->pollActivity(0);
+        if (numFds != 0)
+        {
+            return numFds;
+        }
+        if (!this->fireIdleCbs() || m_terminationRequested)
+        {
+            return this->pollActivity(0);
+        }
+    }
+
+    /*
+     * In low latency mode, poll without blocking until either input shows
+     * up or the spin budget is exhausted. Only then fall back to blocking,
+     * so an idle loop does not burn its core forever.
+     */
+    if (m_configuration.spinBudget > 0.0)
+    {
+        spinStart = monotonicSecs();
+        spinDeadline = spinStart + m_configuration.spinBudget;
+        do
+        {
+            numFds = this->pollActivity(0);
+            m_statistics.spinPolls++;
+            now = monotonicSecs();
+        } while ((0 == numFds) && (now < spinDeadline) && !m_terminationRequested);
+
+        m_statistics.spinSeconds += (now - spinStart);
+        if (numFds != 0)
+        {
+            if (numFds > 0)
+            {
+                m_statistics.spinHits++;
+            }
+            return numFds;
+        }
+    }
+
+    waitStart = monotonicSecs();
+    numFds = this->pollActivity(m_configuration.waitTimeoutMs);
+
+    m_statistics.sleepSeconds += (monotonicSecs() - waitStart);
+    m_statistics.blockingWaits++;
+
+    return numFds;
+}
+
+
+void RunLoop::applyBusyPoll(int fd)
+{
+    int sockType = 0;
+    socklen_t optLen = sizeof(sockType);
+    int busyPollUs = m_configuration.socketBusyPollUs;
+
+    /*
+     * Only sockets understand SO_BUSY_POLL. Asking for the socket type is
+     * the cheapest way to find out whether the descriptor is one.
+     */
+    if (getsockopt(fd, SOL_SOCKET, SO_TYPE, &sockType, &optLen) == -1)
+    {
+        return;
+    }
+
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busyPollUs, sizeof(busyPollUs)) == 0)
+    {
+        m_statistics.busyPollSockets++;
+    }
+    else
+    {
+        m_statistics.busyPollFailures++;
+    }
+}
+
+
+void RunLoop::dispatchActivity()
+{
+    InputSource *anInputSource = nullptr;
+    uint64_t sourceHandle = 0u;
+    uint64_t payload = 0u;
+    uint64_t harvestNs = this->startDispatchBudget();
+    uint64_t endNs = harvestNs;
+
+    while (!m_terminationRequested && (m_sortedActivityQueue.size() > 0))
+    {
+        /*
+         * The input source is removed from the queue before its callback
+         * runs, and its handle is checked against the slot table first. An
+         * input source deregistered by an earlier callback in this same batch
+         * no longer matches its handle and is skipped, since it may well have
+         * been destroyed already.
+         */
+        anInputSource = m_sortedActivityQueue.top();
+        sourceHandle = m_sortedActivityQueue.topHandle();
+        payload = m_sortedActivityQueue.topPayload();
+        m_sortedActivityQueue.pop();
+
+        if (this->sourceForHandle(sourceHandle) == anInputSource)
+        {
+            this->fireInputSource(anInputSource, sourceHandle, payload, harvestNs, endNs);
+            if ((endNs >= m_dispatchDeadlineNs) && !m_sortedActivityQueue.empty())
+            {
+                this->deferActivity();
+            }
+        }
+        else
+        {
+            this->releasePayload(payload);
+        }
+    }
+    m_dispatchDeadlineNs = RF_RL_NO_DISPATCH_DEADLINE;
+}
+
+
+void RunLoop::dispatchRedispatches()
+{
+    size_t handleIdx = 0u;
+    uint64_t harvestNs = 0u;
+    uint64_t endNs = 0u;
+
+    if (m_redispatchHandles.empty())
+    {
+        return;
+    }
+
+    /*
+     * Input sources that asked to be serviced again are serviced after the
+     * fresh activity, in the order they asked, so one that keeps yielding
+     * cannot starve the others regardless of priority. Requests made while
+     * this list is serviced wait for the next iteration.
+     */
+    m_servicedRedispatches.swap(m_redispatchHandles);
+    harvestNs = this->startDispatchBudget();
+    endNs = harvestNs;
+
+    for (handleIdx = 0u; (handleIdx < m_servicedRedispatches.size()) && !m_terminationRequested; ++handleIdx)
+    {
+        uint64_t sourceHandle = m_servicedRedispatches[handleIdx];
+        InputSource *anInputSource = this->sourceForHandle(sourceHandle);
+
+        if (nullptr == anInputSource)
+        {
+            continue;
+        }
+
+        m_sourceSlots[static_cast<uint32_t>(sourceHandle & 0xFFFFFFFFuLL)].redispatchPending = false;
+        m_statistics.redispatches++;
+        this->fireInputSource(anInputSource, sourceHandle, 0u, harvestNs, endNs);
+        if (endNs >= m_dispatchDeadlineNs)
+        {
+            ++handleIdx;
+            break;
+        }
+    }
+
+    /*
+     * Whatever the budget did not cover stays pending, ahead of the requests
+     * made in the meantime.
+     */
+    if (handleIdx < m_servicedRedispatches.size())
+    {
+        m_statistics.budgetExhaustions++;
+        m_servicedRedispatches.insert(m_servicedRedispatches.end(), m_redispatchHandles.begin(), m_redispatchHandles.end());
+        m_servicedRedispatches.erase(m_servicedRedispatches.begin(), m_servicedRedispatches.begin() + handleIdx);
+        m_redispatchHandles.swap(m_servicedRedispatches);
+    }
+    m_servicedRedispatches.clear();
+    m_dispatchDeadlineNs = RF_RL_NO_DISPATCH_DEADLINE;
+}
+
+
+uint64_t RunLoop::startDispatchBudget()
+{
+    uint64_t nowNs = 0u;
+
+    /*
+     * The clock is only read when something needs it. When it is, the end
+     * of one callback doubles as the start of the next, so it is read once
+     * per callback, and the queue delay of an input source includes the
+     * callbacks that ran ahead of it.
+     */
+    if (m_configuration.collectDispatchStats || (m_configuration.dispatchBudget > 0.0))
+    {
+        nowNs = monotonicNs();
+    }
+    if (m_configuration.dispatchBudget > 0.0)
+    {
+        m_dispatchDeadlineNs = nowNs + static_cast<uint64_t>(m_configuration.dispatchBudget * 1e9);
+    }
+
+    return nowNs;
+}
+
+
+void RunLoop::fireInputSource(InputSource *anInputSource, uint64_t sourceHandle, uint64_t payload, uint64_t harvestNs, uint64_t& endNs)
+{
+    uint64_t startNs = endNs;
+
+    m_iterationDispatches++;
+    if (payload & RF_RL_PAYLOAD_DATA)
+    {
+        this->deliverPreRead(anInputSource, sourceHandle, payload);
+    }
+    else
+    {
+        anInputSource->fireCallback();
+    }
+
+    if (!m_configuration.collectDispatchStats && (m_configuration.dispatchBudget <= 0.0))
+    {
+        return;
+    }
+
+    endNs = monotonicNs();
+
+    if (m_configuration.collectDispatchStats)
+    {
+        /*
+         * The callback may have deregistered its own input source, but the
+         * slot index remains valid for the record.
+         */
+        DispatchStatistics& stats = this->dispatchStatsFor(static_cast<uint32_t>(sourceHandle & 0xFFFFFFFFuLL), anInputSource);
+        stats.dispatches++;
+        stats.queueDelay.record(startNs - harvestNs);
+        stats.callbackDuration.record(endNs - startNs);
+    }
+}
+
+
+void RunLoop::deferActivity()
+{
+    InputSource *anInputSource = nullptr;
+    uint64_t sourceHandle = 0u;
+    uint64_t payload = 0u;
+
+    m_statistics.budgetExhaustions++;
+
+    /*
+     * Level-triggered input sources are still ready, so the next wait
+     * reports them again, in priority order alongside any newer activity.
+     * Edge-triggered ones will not be reported again, so they are carried
+     * over explicitly. Input already read on behalf of an input source
+     * exists nowhere else, so it is carried over as is.
+     */
+    while (!m_sortedActivityQueue.empty())
+    {
+        anInputSource = m_sortedActivityQueue.top();
+        sourceHandle = m_sortedActivityQueue.topHandle();
+        payload = m_sortedActivityQueue.topPayload();
+        m_sortedActivityQueue.pop();
+
+        if (this->sourceForHandle(sourceHandle) != anInputSource)
+        {
+            this->releasePayload(payload);
+        }
+        else if (payload & RF_RL_PAYLOAD_DATA)
+        {
+            CarriedActivity carried = { anInputSource, sourceHandle, payload };
+            m_carriedActivity.push_back(carried);
+        }
+        else if (anInputSource->edgeTriggered())
+        {
+            this->requestRedispatch(anInputSource);
+        }
+    }
+}
+
+
+void RunLoop::discardActivity()
+{
+    while (!m_sortedActivityQueue.empty())
+    {
+        this->releasePayload(m_sortedActivityQueue.topPayload());
+        m_sortedActivityQueue.pop();
+    }
+    for (CarriedActivity const& carried : m_carriedActivity)
+    {
+        this->releasePayload(carried.payload);
+    }
+    m_carriedActivity.clear();
+}
+
+
+void RunLoop::releasePayload(uint64_t payload)
+{
+    if ((payload & RF_RL_PAYLOAD_BUFFER) && (m_ioUring != nullptr))
+    {
+        m_ioUring->recycleBuffer(static_cast<uint16_t>((payload >> RF_RL_PAYLOAD_BID_SHIFT) & RF_RL_PAYLOAD_BID_MASK));
+    }
+}
+
+
+void RunLoop::deliverPreRead(InputSource *anInputSource, uint64_t sourceHandle, uint64_t payload)
+{
+    PreReadData readData;
+    uint8_t *theBuffer = nullptr;
+    int32_t readResult = static_cast<int32_t>(payload & 0xFFFFFFFFuLL);
+
+    memset(&readData, 0x00, sizeof(readData));
+    readData.result = readResult;
+
+    if (payload & RF_RL_PAYLOAD_BUFFER)
+    {
+        theBuffer = m_ioUring->buffer(static_cast<uint16_t>((payload >> RF_RL_PAYLOAD_BID_SHIFT) & RF_RL_PAYLOAD_BID_MASK));
+        readData.data = theBuffer;
+
+        /*
+         * Multishot recvmsg() lays out its buffer as a header, followed by
+         * the sender address, any control data, and finally the datagram.
+         * Whatever did not fit in the buffer was dropped by the kernel.
+         */
+        if (UO_RECVMSG_MULTI == m_sourceSlots[static_cast<uint32_t>(sourceHandle & 0xFFFFFFFFuLL)].uringOp)
+        {
+            struct io_uring_recvmsg_out const *msgOut = reinterpret_cast<struct io_uring_recvmsg_out const*>(theBuffer);
+            size_t headerSize = sizeof(*msgOut) + m_uringMsgHdr.msg_namelen + m_uringMsgHdr.msg_controllen;
+            size_t available = (static_cast<size_t>(readResult) > headerSize) ? (static_cast<size_t>(readResult) - headerSize) : 0u;
+
+            readData.peerAddress = reinterpret_cast<struct sockaddr const*>(theBuffer + sizeof(*msgOut));
+            readData.peerAddressLength = std::min<socklen_t>(msgOut->namelen, m_uringMsgHdr.msg_namelen);
+            readData.data = theBuffer + headerSize;
+            readData.result = static_cast<ssize_t>(std::min<size_t>(msgOut->payloadlen, available));
+            readData.messageFlags = static_cast<int>(msgOut->flags);
+            if (msgOut->payloadlen > available)
+            {
+                readData.messageFlags |= MSG_TRUNC;
+            }
+        }
+    }
+
+    try
+    {
+        anInputSource->dataAvailable(readData);
+    }
+    catch (...)
+    {
+        this->releasePayload(payload);
+        throw;
+    }
+    this->releasePayload(payload);
+}
+
+
+uint8_t RunLoop::uringOpFor(InputSource *inputSource) const
+{
+    int sockType = 0;
+    socklen_t optLen = sizeof(sockType);
+    bool isSocket = false;
+
+    if ((InputSource::PRM_NONE == inputSource->preReadMode()) || !m_ioUring->hasBufferRing())
+    {
+        return (inputSource->edgeTriggered() ? UO_POLL_MULTI : UO_POLL);
+    }
+
+    /*
+     * Sockets are read with multishot requests, which stay armed across
+     * reads. Anything else gets one read at a time.
+     */
+    isSocket = (getsockopt(inputSource->fileDescriptor(), SOL_SOCKET, SO_TYPE, &sockType, &optLen) == 0);
+    if (!isSocket)
+    {
+        return UO_READ;
+    }
+
+    return ((InputSource::PRM_MESSAGE == inputSource->preReadMode()) ? UO_RECVMSG_MULTI : UO_RECV_MULTI);
+}
+
+
+void RunLoop::armUringSource(uint32_t slotIdx)
+{
+    SourceSlot& theSlot = m_sourceSlots[slotIdx];
+    struct io_uring_sqe *theSqe = m_ioUring->nextSqe();
+
+    theSqe->fd = theSlot.source->fileDescriptor();
+    theSqe->user_data = makeSourceHandle(slotIdx, theSlot.generation);
+
+    switch (theSlot.uringOp)
+    {
+    case UO_POLL_MULTI:
+        theSqe->len = IORING_POLL_ADD_MULTI;
+        // Fall through
+    case UO_POLL:
+        theSqe->opcode = IORING_OP_POLL_ADD;
+        theSqe->poll32_events = POLLIN;
+        break;
+
+    case UO_RECV_MULTI:
+        theSqe->opcode = IORING_OP_RECV;
+        theSqe->ioprio = IORING_RECV_MULTISHOT;
+        theSqe->flags = IOSQE_BUFFER_SELECT;
+        theSqe->buf_group = IoUring::BufferGroup;
+        break;
+
+    case UO_RECVMSG_MULTI:
+        theSqe->opcode = IORING_OP_RECVMSG;
+        theSqe->addr = reinterpret_cast<uint64_t>(&m_uringMsgHdr);
+        theSqe->len = 1u;
+        theSqe->ioprio = IORING_RECV_MULTISHOT;
+        theSqe->flags = IOSQE_BUFFER_SELECT;
+        theSqe->buf_group = IoUring::BufferGroup;
+        break;
+
+    case UO_READ:
+        theSqe->opcode = IORING_OP_READ;
+        theSqe->off = static_cast<uint64_t>(-1);
+        theSqe->len = static_cast<uint32_t>(m_ioUring->bufferSize());
+        theSqe->flags = IOSQE_BUFFER_SELECT;
+        theSqe->buf_group = IoUring::BufferGroup;
+        break;
+    }
+
+    theSlot.uringArmed = true;
+}
+
+
+void RunLoop::flushUringRearms()
+{
+    for (uint64_t sourceHandle : m_uringRearms)
+    {
+        uint32_t slotIdx = static_cast<uint32_t>(sourceHandle & 0xFFFFFFFFuLL);
+
+        if ((this->sourceForHandle(sourceHandle) != nullptr) && !m_sourceSlots[slotIdx].uringArmed)
+        {
+            this->armUringSource(slotIdx);
+        }
+    }
+    m_uringRearms.clear();
+}
+
+
+void RunLoop::pushUringCompletion(uint64_t userData, int32_t result, uint32_t flags)
+{
+    InputSource *theInputSource = nullptr;
+    uint64_t payload = 0u;
+    uint32_t slotIdx = static_cast<uint32_t>(userData & 0xFFFFFFFFuLL);
+    bool finalCompletion = !(flags & IORING_CQE_F_MORE);
+
+    if (RF_RL_URING_IGNORED == userData)
+    {
+        return;
+    }
+
+    if (flags & IORING_CQE_F_BUFFER)
+    {
+        payload = RF_RL_PAYLOAD_BUFFER |
+            ((static_cast<uint64_t>(flags >> IORING_CQE_BUFFER_SHIFT) & RF_RL_PAYLOAD_BID_MASK) << RF_RL_PAYLOAD_BID_SHIFT);
+    }
+
+    /*
+     * Completions for retired registrations only need their buffer back.
+     */
+    theInputSource = this->sourceForHandle(userData);
+    if (nullptr == theInputSource)
+    {
+        this->releasePayload(payload);
+        return;
+    }
+
+    SourceSlot& theSlot = m_sourceSlots[slotIdx];
+    if (finalCompletion)
+    {
+        theSlot.uringArmed = false;
+    }
+
+    /*
+     * Kernels without multishot support reject the request outright; such
+     * input sources are watched with plain one-shot polls instead.
+     */
+    if ((-EINVAL == result) && (theSlot.uringOp != UO_POLL) && (theSlot.uringOp != UO_READ))
+    {
+        theSlot.uringOp = UO_POLL;
+        m_uringRearms.push_back(userData);
+        return;
+    }
+
+    if ((UO_POLL == theSlot.uringOp) || (UO_POLL_MULTI == theSlot.uringOp))
+    {
+        if (result < 0)
+        {
+            if ((result != -ECANCELED) && (G_MyApp != NULL))
+            {
+                G_MyApp->log() << AppLog::LL_WARNING << "RunLoop can not watch fd=" << theInputSource->fileDescriptor()
+                        << ": " << strerror(-result) << EndLog;
+            }
+            return;
+        }
+
+        if (!theSlot.redispatchPending)
+        {
+            m_sortedActivityQueue.push(theInputSource, userData);
+        }
+        if (finalCompletion)
+        {
+            m_uringRearms.push_back(userData);
+        }
+        return;
+    }
+
+    /*
+     * Running out of buffers holds the read up until the queued activity
+     * returns some; the read is re-armed at the next poll.
+     */
+    if (-ENOBUFS == result)
+    {
+        m_statistics.uringBufferShortages++;
+        if (finalCompletion)
+        {
+            m_uringRearms.push_back(userData);
+        }
+        return;
+    }
+
+    payload |= RF_RL_PAYLOAD_DATA | static_cast<uint32_t>(result);
+    m_sortedActivityQueue.push(theInputSource, userData, payload);
+    if (finalCompletion && (result > 0))
+    {
+        m_uringRearms.push_back(userData);
+    }
+}
+
+
+bool RunLoop::shouldYield() const
+{
+    return ((m_dispatchDeadlineNs != RF_RL_NO_DISPATCH_DEADLINE) && (monotonicNs() >= m_dispatchDeadlineNs));
+}
+
+
+void RunLoop::requestRedispatch(InputSource *inputSource)
+{
+    auto isIter = m_sourceSlotIndex.find(inputSource);
+
+    if (isIter != m_sourceSlotIndex.end())
+    {
+        SourceSlot& theSlot = m_sourceSlots[(*isIter).second];
+
+        if (!theSlot.redispatchPending)
+        {
+            theSlot.redispatchPending = true;
+            m_redispatchHandles.push_back(makeSourceHandle((*isIter).second, theSlot.generation));
+        }
+    }
+}
+
+
+RunLoop::DispatchStatistics& RunLoop::dispatchStatsFor(uint32_t slotIdx, InputSource *source)
+{
+    if (slotIdx >= m_dispatchStats.size())
+    {
+        m_dispatchStats.resize(m_sourceSlots.size());
+    }
+
+    DispatchStatistics& stats = m_dispatchStats[slotIdx];
+    if (stats.source != source)
+    {
+        stats.source = source;
+        stats.fileDescriptor = source->fileDescriptor();
+        stats.relativePriority = source->relativePriority();
+        stats.dispatches = 0u;
+        stats.queueDelay.reset();
+        stats.callbackDuration.reset();
+    }
+
+    return stats;
+}
+
+
+void RunLoop::dispatchStatistics(std::vector<RunLoop::DispatchStatistics>& snapshot) const
+{
+    snapshot.clear();
+    for (size_t slotIdx = 0u; slotIdx < m_dispatchStats.size(); ++slotIdx)
+    {
+        if ((m_dispatchStats[slotIdx].source != nullptr) &&
+            (m_sourceSlots[slotIdx].source == m_dispatchStats[slotIdx].source))
+        {
+            snapshot.push_back(m_dispatchStats[slotIdx]);
+        }
+    }
+}
+
+
+void RunLoop::resetDispatchStatistics()
+{
+    for (DispatchStatistics& stats : m_dispatchStats)
+    {
+        stats.dispatches = 0u;
+        stats.queueDelay.reset();
+        stats.callbackDuration.reset();
+    }
+    m_endOfLoopDuration.reset();
+}
+
+
+void RunLoop::logDispatchStatistics() const
+{
+    std::vector<DispatchStatistics> snapshot;
+
+    if (NULL == G_MyApp)
+    {
+        return;
+    }
+
+    this->dispatchStatistics(snapshot);
+    std::sort(snapshot.begin(), snapshot.end(), longestCallbackFirst);
+
+    for (DispatchStatistics const& stats : snapshot)
+    {
+        if (0u == stats.dispatches)
+        {
+            continue;
+        }
+
+        G_MyApp->log() << AppLog::LL_INFO
+                << "RunLoop dispatch: fd=" << stats.fileDescriptor
+                << " prio=" << static_cast<unsigned>(stats.relativePriority)
+                << " count=" << stats.dispatches
+                << " delay(ns) mean=" << static_cast<uint64_t>(stats.queueDelay.meanNs())
+                << " p99=" << stats.queueDelay.percentileNs(0.99)
+                << " max=" << stats.queueDelay.maxNs()
+                << " callback(ns) mean=" << static_cast<uint64_t>(stats.callbackDuration.meanNs())
+                << " p99=" << stats.callbackDuration.percentileNs(0.99)
+                << " max=" << stats.callbackDuration.maxNs()
+                << EndLog;
+    }
+
+    if (m_endOfLoopDuration.count() > 0u)
+    {
+        G_MyApp->log() << AppLog::LL_INFO
+                << "RunLoop end-of-loop callbacks: count=" << m_endOfLoopDuration.count()
+                << " duration(ns) mean=" << static_cast<uint64_t>(m_endOfLoopDuration.meanNs())
+                << " p99=" << m_endOfLoopDuration.percentileNs(0.99)
+                << " max=" << m_endOfLoopDuration.maxNs()
+                << EndLog;
+    }
+
+    if (m_timerWheel != nullptr)
+    {
+        G_MyApp->log() << AppLog::LL_INFO
+                << "RunLoop timer wheel: wakeups=" << m_timerWheel->wakeups()
+                << " saved=" << m_timerWheel->wakeupsSaved()
+                << EndLog;
+    }
+
+}
+
+
+void RunLoop::updateDispatchStatsReport()
+{
+    double interval = (m_configuration.collectDispatchStats ? m_configuration.dispatchStatsLogInterval : 0.0);
+
+    if ((m_statsReportTimerId != -1) && (interval == m_statsReportInterval))
+    {
+        return;
+    }
+
+    if (m_statsReportTimerId != -1)
+    {
+        this->deregisterTimer(m_statsReportTimerId);
+        m_statsReportTimerId = -1;
+    }
+
+    m_statsReportInterval = interval;
+    if (interval > 0.0)
+    {
+        if (nullptr == m_statsReporter)
+        {
+            m_statsReporter = new DispatchStatsReporter(this);
+        }
+        m_statsReportTimerId = this->registerTimerWithInterval(interval, m_statsReporter, true);
+    }
+}
+
+
+InputSource* RunLoop::sourceForHandle(uint64_t sourceHandle) const
+{
+    uint32_t slotIdx = static_cast<uint32_t>(sourceHandle & 0xFFFFFFFFuLL);
+    uint32_t generation = static_cast<uint32_t>(sourceHandle >> 32u);
+
+    if ((slotIdx < m_sourceSlots.size()) && (m_sourceSlots[slotIdx].generation == generation))
+    {
+        return m_sourceSlots[slotIdx].source;
+    }
+
+    return nullptr;
+}
+
+
+void RunLoop::adaptEventBatchSize(int numFds)
+{
+    /*
+     * A wait that fills the entire event array is a sign that more input
+     * sources were ready than we could collect. Double the array (up to the
+     * configured limit) so the next burst is collected in a single wait. The
+     * array never shrinks, since a loop that saw one burst will likely see
+     * another.
+     */
+    if ((static_cast<size_t>(numFds) == m_eventBuffer.size()) &&
+        (m_eventBuffer.size() < m_configuration.maxEventBatchSize))
+    {
+        m_eventBuffer.resize(std::min<size_t>(m_eventBuffer.size() * 2u, m_configuration.maxEventBatchSize));
+        m_sortedActivityQueue.reserve(m_eventBuffer.size());
+    }
+}
+
+
+
 // vim: set ts=4 sw=4 expandtab:
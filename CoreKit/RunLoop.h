@@ -8,17 +8,32 @@
 #define EA_FAF0C499_1C34_481d_B100_AF7997CA029B__INCLUDED_
 
 #include <sys/epoll.h>
+#include <sys/socket.h>
+#include <atomic>
+#include <deque>
 #include <vector>
-#include <queue>
 #include <map>
 
+#include <unordered_map>
+
+
+#include "ActivityQueue.h"
 #include "InputSource.h"
+#include "LatencyHistogram.h"
+#include "LoopCallback.h"
+
 #include "factory.h"
+#include "FramePool.h"
 #include "TimerInputSource.h"
+#include "TimerWheel.h"
+#include "TaskQueue.h"
 
 namespace CoreKit
 {
+class IoUring;
 class Thread;
+class WatchdogService;
+
 
 	/**
 	 * \brief Main Loop that Schedules All Work for a \c Thread
@@ -122,6 +137,321 @@ class Thread;
 		static LoopIterCbBase* newLoopIterCb(TargetType cbTarget)
 		{ return new LoopIterCb<TargetType>(cbTarget); }
 
+		/**
+		 * \brief When a Callback Registered via \c addLoopCallback() Runs
+		 */
+		enum LoopCallbackKind
+		{
+			/**
+			 * \brief At the End of Every Loop Iteration
+			 */
+			LC_ITERATION_END = 0,
+			/**
+			 * \brief At the End of Iterations that Serviced at Least One Input Source
+			 *
+			 * Wake ups that time out, or are interrupted, do not run these.
+			 */
+			LC_AFTER_ACTIVITY,
+			/**
+			 * \brief When the Loop has No Pending Input, Within \c Configuration::idleBudget
+			 *
+			 * Idle callbacks run right before the loop would block waiting
+			 * for input, and only if a non-blocking poll finds none. They
+			 * run round-robin; when the budget runs out, the remaining ones
+			 * run first in the next idle pass, and the loop polls instead of
+			 * blocking until they all had their turn.
+			 */
+			LC_IDLE,
+			/**
+			 * \brief Number of Callback Kinds; Not a Valid Kind
+			 */
+			LC_KIND_COUNT
+		};
+
+		/**
+		 * \brief Operating System Services a \c RunLoop Can Use to Wait for Input
+		 */
+		enum Backend
+		{
+			/**
+			 * \brief Wait for Input Using \c epoll()
+			 */
+			BK_EPOLL,
+			/**
+			 * \brief Wait for Input Using \c io_uring
+			 *
+			 * Collects activity, and optionally reads input, through a single
+			 * shared ring, which saves system calls when many input sources
+			 * are busy. Requires Linux 5.11 or later; on older kernels, or if
+			 * the ring can not be created, the \c RunLoop falls back to
+			 * \c BK_EPOLL and logs a warning.
+			 */
+			BK_IO_URING
+		};
+
+		/**
+		 * \brief Tunable Parameters that Govern How a \c RunLoop Waits for Input
+		 *
+		 * The \c RunLoop::Configuration structure collects the settings that
+		 * decide how much work a single wait on the operating system
+		 * multiplexor is able to pick up. Busy applications with many active
+		 * input sources should raise the batch sizes so that a single
+		 * \c epoll_wait() call reports all of the pending activity.
+		 */
+		struct Configuration
+		{
+			/**
+			 * \brief Number of Events Collected per Wait When the \c RunLoop Starts
+			 */
+			unsigned initialEventBatchSize;
+			/**
+			 * \brief Upper Limit for the Number of Events Collected per Wait
+			 *
+			 * Whenever a wait fills up the entire event array, the
+			 * \c RunLoop doubles the size of the array (up to this limit)
+			 * so that subsequent bursts are collected with fewer calls. A
+			 * value equal to \c initialEventBatchSize disables the growth.
+			 */
+			unsigned maxEventBatchSize;
+			/**
+			 * \brief Maximum Time, in Milliseconds, a Single Wait May Block
+			 */
+			int waitTimeoutMs;
+			/**
+			 * \brief Resolution, in Seconds, of the Shared Timer Wheel
+			 *
+			 * When positive, timers created via
+			 * \c registerTimerWithInterval() are multiplexed over a single
+			 * \c TimerWheel (and a single \c timerfd()) instead of each
+			 * getting its own \c TimerInputSource. Expirations are rounded
+			 * up to the next multiple of this resolution. Zero, the
+			 * default, keeps one \c TimerInputSource per timer, save for
+			 * those created via \c registerTimerWithSlack().
+			 */
+			double timerWheelTick;
+			/**
+			 * \brief Maximum Number of Posted Closures Waiting to Run
+			 *
+			 * See \c RunLoop::post(). Only honored at construction time.
+			 */
+			unsigned postQueueCapacity;
+			/**
+			 * \brief What \c RunLoop::post() Does When the Queue is Full
+			 */
+			TaskQueue::OverflowPolicy postOverflowPolicy;
+			/**
+			 * \brief Time, in Seconds, to Poll for Input Before Blocking
+			 *
+			 * When positive, \c run() repeatedly polls the multiplexor
+			 * without blocking for up to this long before falling back to a
+			 * blocking wait. This trades CPU time for wake up latency and is
+			 * meant for loops running on isolated cores. Zero, the default,
+			 * always blocks right away.
+			 */
+			double spinBudget;
+			/**
+			 * \brief \c SO_BUSY_POLL Value, in Microseconds, Applied to Registered Sockets
+			 *
+			 * When positive, every socket registered with the \c RunLoop
+			 * has its \c SO_BUSY_POLL option set to this value, so the
+			 * kernel busy polls the device queue when the socket is read.
+			 * Raising the value above the \c net.core.busy_read sysctl may
+			 * require \c CAP_NET_ADMIN; failures are counted in
+			 * \c Statistics::busyPollFailures. Zero, the default, leaves
+			 * sockets untouched.
+			 */
+			int socketBusyPollUs;
+			/**
+			 * \brief Whether to Time Every Input Source Callback
+			 *
+			 * When \c true, the \c RunLoop records, for every input source,
+			 * the delay between the time its activity was collected and the
+			 * time its callback started, as well as the duration of the
+			 * callback. The time spent in end-of-loop callbacks is recorded
+			 * too. See \c dispatchStatistics(). Costs one clock read per
+			 * callback; defaults to \c false.
+			 */
+			bool collectDispatchStats;
+			/**
+			 * \brief Interval, in Seconds, Between Dispatch Statistics Reports
+			 *
+			 * When positive, and \c collectDispatchStats is \c true, the
+			 * \c RunLoop periodically writes its dispatch statistics to the
+			 * application log via \c logDispatchStatistics(). Zero, the
+			 * default, disables the periodic report.
+			 */
+			double dispatchStatsLogInterval;
+			/**
+			 * \brief Time Budget, in Seconds, for Servicing One Batch of Activity
+			 *
+			 * When positive, the \c RunLoop stops servicing input sources once
+			 * the budget is spent and collects fresh activity before resuming,
+			 * so that timers and signals are serviced promptly even when a
+			 * burst of input is pending. Handlers that drain a backlog should
+			 * poll \c shouldYield() and call \c requestRedispatch() to resume
+			 * their work in the next iteration. Zero, the default, means no
+			 * limit.
+			 */
+			double dispatchBudget;
+			/**
+			 * \brief Operating System Service Used to Wait for Input
+			 *
+			 * Only honored at construction time; \c configuration() reports
+			 * the backend actually in use. Defaults to \c BK_EPOLL.
+			 */
+			Backend backend;
+			/**
+			 * \brief Size of the \c io_uring Submission Queue
+			 *
+			 * Only honored at construction time, with the \c BK_IO_URING
+			 * backend.
+			 */
+			unsigned uringEntries;
+			/**
+			 * \brief Number of Buffers the \c io_uring Backend Reads Input Into
+			 *
+			 * Rounded up to a power of two. Shared by all input sources that
+			 * let the \c RunLoop read their input; see
+			 * \c InputSource::setPreReadMode(). Zero disables pre-reading.
+			 * Only honored at construction time.
+			 */
+			unsigned uringBufferCount;
+			/**
+			 * \brief Size, in Bytes, of Each Buffer the \c io_uring Backend Reads Input Into
+			 *
+			 * Only honored at construction time.
+			 */
+			unsigned uringBufferSize;
+			/**
+			 * \brief Time Budget, in Seconds, for One Pass of Idle Callbacks
+			 *
+			 * Checked after each \c LC_IDLE callback, so one callback that
+			 * runs long overshoots it; idle callbacks are expected to do a
+			 * small slice of work per call. Zero means no limit.
+			 */
+			double idleBudget;
+
+			/**
+			 * \brief Initialize All Settings to Their Default Values
+			 */
+			Configuration();
+		};
+
+		/**
+		 * \brief Access the Configuration Applied to New \c RunLoop Instances
+		 *
+		 * \return Configuration used by the default \c RunLoop constructor.
+		 */
+		static Configuration const& defaultConfiguration();
+		/**
+		 * \brief Alter the Configuration Applied to New \c RunLoop Instances
+		 *
+		 * Threads spawned by the \c Application class create their
+		 * \c RunLoop instances using the default constructor; this method is
+		 * the way to tune all of them at once. Instances that already exist
+		 * are not affected.
+		 *
+		 * \param config Configuration the default \c RunLoop constructor
+		 *               should use from now on.
+		 */
+		static void setDefaultConfiguration(Configuration const& config);
+
+		/**
+		 * \brief Timing Information Collected for a Single Input Source
+		 */
+		struct DispatchStatistics
+		{
+			/**
+			 * \brief Input Source the Statistics Belong To
+			 */
+			InputSource *source;
+			/**
+			 * \brief File Descriptor of the Input Source
+			 */
+			int fileDescriptor;
+			/**
+			 * \brief Relative Priority of the Input Source
+			 */
+			uint8_t relativePriority;
+			/**
+			 * \brief Number of Times the Input Source Callback Ran
+			 */
+			uint64_t dispatches;
+			/**
+			 * \brief Delay Between Collecting the Activity and Starting the Callback
+			 */
+			LatencyHistogram queueDelay;
+			/**
+			 * \brief Duration of the Input Source Callback
+			 */
+			LatencyHistogram callbackDuration;
+		};
+
+		/**
+		 * \brief Counters that Describe How a \c RunLoop Spends its Time Waiting
+		 */
+		struct Statistics
+		{
+			/**
+			 * \brief Number of Non-Blocking Polls Made While Spinning
+			 */
+			uint64_t spinPolls;
+			/**
+			 * \brief Number of Spins that Found Input Before the Budget Ran Out
+			 */
+			uint64_t spinHits;
+			/**
+			 * \brief Number of Blocking Waits on the Multiplexor
+			 */
+			uint64_t blockingWaits;
+			/**
+			 * \brief Total Time, in Seconds, Spent Spinning
+			 */
+			double spinSeconds;
+			/**
+			 * \brief Total Time, in Seconds, Spent in Blocking Waits
+			 */
+			double sleepSeconds;
+			/**
+			 * \brief Number of Sockets that Accepted the \c SO_BUSY_POLL Setting
+			 */
+			uint64_t busyPollSockets;
+			/**
+			 * \brief Number of Sockets that Rejected the \c SO_BUSY_POLL Setting
+			 */
+			uint64_t busyPollFailures;
+			/**
+			 * \brief Number of Batches Cut Short Because the Dispatch Budget Ran Out
+			 */
+			uint64_t budgetExhaustions;
+			/**
+			 * \brief Number of Input Sources Serviced Again at their Own Request
+			 */
+			uint64_t redispatches;
+			/**
+			 * \brief Number of Reads Held Up Because No \c io_uring Buffer was Free
+			 *
+			 * A steadily increasing count means
+			 * \c Configuration::uringBufferCount is too small for the input
+			 * load.
+			 */
+			uint64_t uringBufferShortages;
+			/**
+			 * \brief Number of Times Idle Callbacks Ran
+			 */
+			uint64_t idlePasses;
+			/**
+			 * \brief Number of Idle Passes Cut Short Because the Idle Budget Ran Out
+			 */
+			uint64_t idleBudgetExhaustions;
+
+			/**
+			 * \brief Initialize All Counters to Zero
+			 */
+			Statistics();
+		};
+
+
 		/**
 		 * \brief Initialize the Operating System Service Used for Input Multiplexing
 		 *
@@ -130,8 +460,17 @@ class Thread;
 		 * between all registered input sources. The multiplexing service is
 		 * not activated, however, in this constructor.
 		 *
+		 * The instance is configured with the settings reported by
+		 * \c defaultConfiguration().
 		 */
 		RunLoop();
+		/**
+		 * \brief Initialize the Multiplexing Service Using Explicit Settings
+		 *
+		 * \param config Settings this \c RunLoop instance should use.
+		 */
+		explicit RunLoop(Configuration const& config);
+
 		/**
 		 * \brief Release All Resources Held by the \c RunLoop Instance
 		 *
@@ -162,13 +501,132 @@ class Thread;
 		 * \param hostThread \c Thread object hosting this \c RunLoop.
 		 */
 		inline void setHostThread(Thread *hostThread) { m_hostThread = hostThread; }
+		/**
+		 * \brief Access the Settings Used by this \c RunLoop
+		 *
+		 * \return Configuration currently in effect.
+		 */
+		inline Configuration const& configuration() const { return m_configuration; }
+		/**
+		 * \brief Alter the Settings Used by this \c RunLoop
+		 *
+		 * The new settings take effect at the next wait on the multiplexor.
+		 *
+		 * \param config Settings this \c RunLoop instance should use.
+		 */
+		void setConfiguration(Configuration const& config);
+		/**
+		 * \brief Report the Operating System Service this \c RunLoop Waits On
+		 *
+		 * \return \c BK_IO_URING if the \c io_uring backend was requested and
+		 *         could be set up; \c BK_EPOLL otherwise.
+		 */
+		inline Backend backend() const { return m_configuration.backend; }
+		/**
+		 * \brief Report the Number of Events Currently Collected per Wait
+		 *
+		 * \return Size of the event array handed to \c epoll_wait().
+		 */
+		inline size_t eventBatchSize() const { return m_eventBuffer.size(); }
+		/**
+		 * \brief Access the Wait Time Counters of this \c RunLoop
+		 *
+		 * The split between spinning and sleeping is the figure to watch
+		 * when tuning \c Configuration::spinBudget.
+		 *
+		 * \return Counters accumulated since construction or the last call
+		 *         to \c resetStatistics().
+		 */
+		inline Statistics const& statistics() const { return m_statistics; }
+		/**
+		 * \brief Zero Out the Wait Time Counters of this \c RunLoop
+		 */
+		inline void resetStatistics() { m_statistics = Statistics(); }
+		/**
+		 * \brief Copy the Dispatch Statistics of All Registered Input Sources
+		 *
+		 * Statistics are only collected while
+		 * \c Configuration::collectDispatchStats is \c true. Like every
+		 * other \c RunLoop method, this one should be called from the thread
+		 * running the \c RunLoop; other threads may obtain a snapshot using
+		 * \c post().
+		 *
+		 * \param snapshot Receives one entry per registered input source
+		 *                 that has been dispatched at least once.
+		 */
+		void dispatchStatistics(std::vector<DispatchStatistics>& snapshot) const;
+		/**
+		 * \brief Access the Time Spent in End-of-Loop Callbacks
+		 *
+		 * \return Histogram with one sample per run loop iteration.
+		 */
+		inline LatencyHistogram const& endOfLoopStatistics() const { return m_endOfLoopDuration; }
+		/**
+		 * \brief Count the Wake Ups Caused by Timers on the Shared Timer Wheel
+		 *
+		 * \return Number of times the wheel's \c timerfd() fired.
+		 */
+		inline uint64_t timerWakeups() const { return ((m_timerWheel != nullptr) ? m_timerWheel->wakeups() : 0u); }
+		/**
+		 * \brief Count the Timer Wake Ups Avoided Thanks to Timer Slack
+		 *
+		 * Compared with \c timerWakeups(), the figure to watch when tuning
+		 * the slack given to \c registerTimerWithSlack().
+		 *
+		 * \return Number of wake ups saved; see \c TimerWheel::wakeupsSaved().
+		 */
+		inline uint64_t timerWakeupsSaved() const { return ((m_timerWheel != nullptr) ? m_timerWheel->wakeupsSaved() : 0u); }
+		/**
+		 * \brief Discard All Dispatch Statistics Collected So Far
+		 */
+		void resetDispatchStatistics();
+		/**
+		 * \brief Write a Summary of the Dispatch Statistics to the Application Log
+		 *
+		 * One line is written per input source, sorted by the longest
+		 * callback duration, followed by one line for the end-of-loop
+		 * callbacks.
+		 */
+		void logDispatchStatistics() const;
+		/**
+		 * \brief Check Whether the Current Dispatch Budget is Spent
+		 *
+		 * Meant to be polled by input source callbacks that process a
+		 * backlog in a loop. Once this method returns \c true, the callback
+		 * should stop, call \c requestRedispatch() if work remains, and
+		 * return. Always \c false if \c Configuration::dispatchBudget is zero.
+		 *
+		 * \return \c true if the callback should return control to the
+		 *         \c RunLoop; \c false otherwise.
+		 */
+		bool shouldYield() const;
+		/**
+		 * \brief Service an Input Source Again in the Next Iteration
+		 *
+		 * The input source is queued for servicing in the next run loop
+		 * iteration regardless of the state of its file descriptor, and
+		 * the next wait for activity does not block. Useful for input
+		 * sources that keep their own backlog, and for edge-triggered input
+		 * sources that stopped draining their descriptor early. Requests
+		 * for input sources not registered with this \c RunLoop, or already
+		 * pending, are ignored.
+		 *
+		 * \param inputSource Input source to service again.
+		 */
+		void requestRedispatch(InputSource *inputSource);
+
 		/**
 		 * \brief Remove an Input Source from the Multiplexor
 		 *
 		 * The \c deregisterInputSource() method is used to remove an input
 		 * source from the multiplexor \c RunLoop uses to schedule work. In
 		 * other words, activity from the removed input source will no longer
-		 * trigged work scheduling from this \c RunLoop instance.
+		 * trigged work scheduling from this \c RunLoop instance.\par
+		 *
+		 * Removal takes constant time. It is safe to call this method from
+		 * within an input source callback, even for an input source that
+		 * exhibited activity in the same run loop iteration and has not been
+		 * serviced yet; that activity is discarded.
 		 *
 		 * \param theInputSource \c InputSource instance that should be removed
 		 *                       from this \c RunLoop instance's multiplexor.
@@ -184,6 +642,16 @@ class Thread;
 		 *
 		 * \param inputSource \c InputSource instance that should be added to
 		 *                    this \c RunLoop instance's multiplexor.
+		 *
+		 * \note Input sources that report \c InputSource::edgeTriggered() as
+		 *       \c true are registered with \c EPOLLET and must drain their
+		 *       file descriptor every time they are serviced.
+		 *
+		 * \note With the \c BK_IO_URING backend, input sources that opt into
+		 *       pre-reading via \c InputSource::setPreReadMode() have their
+		 *       input read by the \c RunLoop and handed to
+		 *       \c InputSource::dataAvailable() instead of having
+		 *       \c InputSource::fireCallback() invoked.
          *
          * \note Although this method may be used to register signal and timer
          *       input sources, it is advised that users instead call
@@ -193,6 +661,14 @@ class Thread;
          *       sources.
 		 */
 		virtual void registerInputSource(InputSource* inputSource);
+		/**
+		 * \brief Check Whether an \c InputSource is Registered with this \c RunLoop
+		 *
+		 * \param inputSource \c InputSource instance to look for.
+		 *
+		 * \return \c true if \c inputSource is currently registered.
+		 */
+		bool isRegistered(InputSource* inputSource) const;
 		/**
 		 * \brief Register an \c InterruptListener to Listen For Operating System Signals
 		 *
@@ -262,6 +738,105 @@ class Thread;
          * \return Identifier for the newly-registered \c TimerInputSource
          */
         int registerTimerWithInterval(double firstTimeout, double timeInterval, InterruptListener *theListener);
+		/**
+		 * \brief Initiate a Timer that May Fire Late to Share a Wake Up with Other Timers
+		 *
+		 * Meant for low precision timers, such as polls, watchdog ticks and
+		 * status reports. The timer always lives on the shared
+		 * \c TimerWheel, which is created with a 1 ms resolution if
+		 * \c Configuration::timerWheelTick is zero. Each expiration may be
+		 * delayed by up to \c slack so that timers due close together are
+		 * serviced in a single wake up; periodic timers stay on their
+		 * original schedule regardless. See \c timerWakeupsSaved().
+		 *
+		 * \param firstTimeout Seconds until the first expiration.
+		 * \param timeInterval Seconds between subsequent expirations; zero
+		 *                     for a one-shot timer.
+		 * \param slack Seconds each expiration may be delayed by; rounded
+		 *              down to the wheel resolution.
+		 * \param theListener \c InterruptListener instance that is interested
+		 *                    in the expirations of this timer.
+		 *
+		 * \return Identifier for the new timer.
+		 */
+		int registerTimerWithSlack(double firstTimeout, double timeInterval, double slack, InterruptListener *theListener);
+		/**
+		 * \brief Change the Slack of a Timer on the Shared Timer Wheel
+		 *
+		 * \param timerId Timer identifier offered by one of the timer
+		 *                registration methods.
+		 * \param slack Seconds each expiration may be delayed by.
+		 *
+		 * \return \c true if the slack was changed; \c false if the timer is
+		 *         unknown or has its own \c TimerInputSource, whose
+		 *         expirations can not be coalesced.
+		 */
+		bool setTimerSlack(int timerId, double slack);
+
+		/**
+		 * \brief Initiate a Timer with its Own \c timerfd() on a Specific Clock
+		 *
+		 * Timers created with \c registerPreciseTimer() always get a
+		 * dedicated \c TimerInputSource, even when the shared
+		 * \c TimerWheel is enabled, so their expirations are not rounded to
+		 * the wheel resolution. This is the method to use for control loops
+		 * that must run at a fixed rate. Listeners receive the overrun count
+		 * and lateness of each expiration via
+		 * \c InterruptListener::timerExpired(int,TimerExpiration const&),
+		 * and the same information is accumulated in the statistics
+		 * available from \c timerStatistics().
+		 *
+		 * \param firstTimeout Seconds to wait before the first expiration.
+		 * \param timeInterval Period of the timer expressed in seconds; zero
+		 *                     for a one-shot timer.
+		 * \param theListener \c InterruptListener instance that is interested
+		 *                    in the expirations of this timer.
+		 * \param clockId Clock the timer is based on.
+		 *
+		 * \return Identifier for the newly-registered \c TimerInputSource
+		 */
+		int registerPreciseTimer(double firstTimeout, double timeInterval, InterruptListener *theListener, clockid_t clockId = CLOCK_MONOTONIC);
+		/**
+		 * \brief Initiate a Timer that First Expires at an Absolute Deadline
+		 *
+		 * Behaves like \c registerPreciseTimer(), except that the first
+		 * expiration is given as a point in time on the selected clock.
+		 * Subsequent expirations occur at exact multiples of the period
+		 * from that deadline.
+		 *
+		 * \param firstDeadline Time of the first expiration.
+		 * \param timeInterval Period of the timer expressed in seconds; zero
+		 *                     for a one-shot timer.
+		 * \param theListener \c InterruptListener instance that is interested
+		 *                    in the expirations of this timer.
+		 * \param clockId Clock \c firstDeadline is expressed on.
+		 *
+		 * \return Identifier for the newly-registered \c TimerInputSource
+		 */
+		int registerTimerAtDeadline(struct timespec const& firstDeadline, double timeInterval, InterruptListener *theListener, clockid_t clockId = CLOCK_MONOTONIC);
+		/**
+		 * \brief Access the Lateness Statistics Accumulated for a Timer
+		 *
+		 * Statistics are only kept for timers backed by their own
+		 * \c TimerInputSource; timers multiplexed over the shared
+		 * \c TimerWheel report their overruns and lateness to their
+		 * listener only.
+		 *
+		 * \param timerId Timer identifier offered by one of the timer
+		 *                registration methods.
+		 *
+		 * \return Statistics for the timer, or \c nullptr if \c timerId does
+		 *         not identify a timer backed by its own \c TimerInputSource.
+		 */
+		TimerStatistics const* timerStatistics(int timerId) const;
+		/**
+		 * \brief Discard the Lateness Statistics Accumulated for a Timer
+		 *
+		 * \param timerId Timer identifier offered by one of the timer
+		 *                registration methods.
+		 */
+		void resetTimerStatistics(int timerId);
+
 		/**
 		 * \brief Deregister a timer from the Multiplexor
 		 *
@@ -273,6 +848,19 @@ class Thread;
 		 *                registerTimerWithInterval() method.
 		 */
 		virtual void deregisterTimer(int timerId);
+		/**
+		 * \brief Restart the Countdown of a Registered Timer
+		 *
+		 * The \c rearmTimer() method pushes the next expiration of a timer
+		 * created using \c registerTimerWithInterval() out to its first
+		 * timeout (or its interval, if no separate first timeout was given),
+		 * measured from the time of the call. This is the inexpensive way to
+		 * implement inactivity timeouts.
+		 *
+		 * \param timerId Timer identifier offered by the \c
+		 *                registerTimerWithInterval() method.
+		 */
+		void rearmTimer(int timerId);
 
         /**
          * \brief Register and end-of-loop-iteration callback.
@@ -282,10 +870,105 @@ class Thread;
          * \c CoreKit::RunLoop class assumes ownership of the instance memory
          * and will de-allocate it once this instance is destroyed.
          *
+         * \note New code should use \c addLoopCallback(), which does not
+         *       allocate for small targets and returns a removable handle.
+         *
          * \param[in] loopIterEndCb - Object to invoke at every run loop
          *            iteration end.
          */
 		void addLoopIterEndCallback(LoopIterCbBase *loopIterEndCb);
+		/**
+		 * \brief Register a Callback Run Between Loop Iterations
+		 *
+		 * Callbacks of the same kind run in the order they were added.
+		 * Callbacks may add and remove callbacks, including themselves; a
+		 * callback added while callbacks run first runs in the next
+		 * iteration. Must be called from this \c RunLoop's thread.
+		 *
+		 * \param kind When the callback runs.
+		 * \param callback Callback to run; any callable taking a
+		 *                 \c RunLoop pointer converts to it.
+		 *
+		 * \return Handle to pass to \c removeLoopCallback().
+		 */
+		LoopCallbackHandle addLoopCallback(LoopCallbackKind kind, LoopCallback callback);
+		/**
+		 * \brief Remove a Callback Registered via \c addLoopCallback()
+		 *
+		 * \param handle Handle returned by \c addLoopCallback(); reset so it
+		 *               no longer refers to anything.
+		 *
+		 * \return \c true if the callback was removed; \c false if it was
+		 *         already gone.
+		 */
+		bool removeLoopCallback(LoopCallbackHandle& handle);
+		/**
+		 * \brief Run a Closure on this \c RunLoop's Thread
+		 *
+		 * The \c post() method is the way for any thread to hand work over
+		 * to the thread hosting this \c RunLoop instance. The closure is
+		 * placed in a lock-free queue and runs during a later iteration of
+		 * \c run(). Closures posted by the same thread run in the order they
+		 * were posted.\par
+		 *
+		 * If the queue is full, the \c postOverflowPolicy from this
+		 * instance's configuration decides whether the caller waits, the
+		 * closure is dropped, or an exception is thrown.
+		 *
+		 * \param task Closure to run on this \c RunLoop's thread.
+		 *
+		 * \return \c true if the closure was queued; \c false if it was
+		 *         dropped.
+		 */
+		bool post(TaskQueue::Task task);
+		/**
+		 * \brief Run a Closure on this \c RunLoop's Thread Using a Specific Overflow Policy
+		 *
+		 * \param task Closure to run on this \c RunLoop's thread.
+		 * \param policy What to do if the queue is full.
+		 *
+		 * \return \c true if the closure was queued; \c false if it was
+		 *         dropped.
+		 */
+		bool post(TaskQueue::Task task, TaskQueue::OverflowPolicy policy);
+		/**
+		 * \brief Run Several Closures on this \c RunLoop's Thread
+		 *
+		 * Behaves like \c post(), but wakes this \c RunLoop up only once for
+		 * the whole batch. Closures that were queued are moved out of
+		 * \c tasks.
+		 *
+		 * \param tasks Closures to run on this \c RunLoop's thread.
+		 *
+		 * \return Number of closures queued.
+		 */
+		size_t postBatch(std::vector<TaskQueue::Task>& tasks);
+		/**
+		 * \brief Count the Posted Closures Dropped Because the Queue was Full
+		 *
+		 * \return Number of dropped closures.
+		 */
+		inline uint64_t droppedPostCount() const { return m_taskQueue->droppedCount(); }
+		/**
+		 * \brief Access the Allocator for Coroutine Frames Bound to this \c RunLoop
+		 *
+		 * The pool is created the first time it is needed. It is not thread
+		 * safe, so it is only meant for coroutines resumed by this
+		 * \c RunLoop's thread; see \c CoreKit/Coroutine.h.
+		 *
+		 * \return Frame pool owned by this \c RunLoop instance.
+		 */
+		FramePool* framePool();
+		/**
+		 * \brief Access the Service Managing the Watchdogs Bound to this \c RunLoop
+		 *
+		 * The service, and its single \c timerfd(), are created the first
+		 * time they are needed. Like the \c RunLoop itself, the service
+		 * must only be used from this \c RunLoop's thread.
+		 *
+		 * \return Watchdog service owned by this \c RunLoop instance.
+		 */
+		WatchdogService* watchdogService();
 		/**
 		 * \brief Monitor All Input Sources and Schedule Work Accordingly
 		 *
@@ -300,8 +983,13 @@ class Thread;
 		 *
 		 * The \c terminate() method instructs this \c RunLoop instance's
 		 * work scheduler to terminate at its next available opportunity.
+		 * It is safe to call from any thread: the loop's wake up
+		 * \c eventfd() (the one \c post() uses) is signaled, so a loop
+		 * blocked waiting for input returns right away instead of at its
+		 * next timeout. A \c SynchronizedRunLoop also interrupts the wait
+		 * on its synchronization object.
 		 */
-		inline void terminate() { m_terminationRequested = true; }
+		virtual void terminate();
 		/**
 		 * \brief Check Whether Termination of this \c RunLoop Work Scheduler was Requested
 		 *
@@ -311,38 +999,381 @@ class Thread;
 		 * \return \c true if this \c RunLoop instance's work scheduler has
 		 *         been asked to terminate; \c false otherwise.
 		 */
-		inline bool isTerminationRequested() const { return m_terminationRequested; }
+		inline bool isTerminationRequested() const { return m_terminationRequested.load(std::memory_order_acquire); }
 
 	protected:
-		struct InputSourceSort
+		void pushEpollEventInputSource(struct epoll_event anEvent);
+		/**
+		 * \brief Collect Input Activity into the Activity Queue
+		 *
+		 * \param timeoutMs Longest time to wait for activity, in
+		 *                  milliseconds; zero polls without blocking.
+		 *
+		 * \return Number of events or completions collected; negative if
+		 *         the wait failed.
+		 */
+		int pollActivity(int timeoutMs);
+		/**
+		 * \brief Service All Queued Input Sources in Priority Order
+		 *
+		 * Input sources deregistered while the queue is serviced are
+		 * skipped. Servicing stops early if termination is requested.
+		 */
+		void dispatchActivity();
+		/**
+		 * \brief Service the Input Sources that Requested to be Serviced Again
+		 *
+		 * Called after \c dispatchActivity(), with a budget of its own.
+		 */
+		void dispatchRedispatches();
+		/**
+		 * \brief Start the Dispatch Budget for a Batch of Callbacks
+		 *
+		 * \return Monotonic time, in nanoseconds, at which the batch starts;
+		 *         zero if neither statistics nor a budget need the clock.
+		 */
+		uint64_t startDispatchBudget();
+		/**
+		 * \brief Invoke an Input Source Callback, Timing it if Required
+		 *
+		 * \param anInputSource Input source to service.
+		 * \param sourceHandle Registration handle of the input source.
+		 * \param payload Input read on behalf of the input source, as
+		 *                encoded by \c pushUringCompletion(); zero if none.
+		 * \param harvestNs Time at which the batch started.
+		 * \param endNs On input, the time the callback starts; on output,
+		 *              the time it ended.
+		 */
+		void fireInputSource(InputSource *anInputSource, uint64_t sourceHandle, uint64_t payload, uint64_t harvestNs, uint64_t& endNs);
+		/**
+		 * \brief Set Aside the Activity Left Over When the Dispatch Budget Runs Out
+		 */
+		void deferActivity();
+		/**
+		 * \brief Drop All Queued Activity, Returning Any Buffers it Holds
+		 */
+		void discardActivity();
+		/**
+		 * \brief Hand Input Read by the \c io_uring Backend to its Input Source
+		 *
+		 * \param anInputSource Input source the input was read for.
+		 * \param sourceHandle Registration handle of the input source.
+		 * \param payload Encoded outcome of the read.
+		 */
+		void deliverPreRead(InputSource *anInputSource, uint64_t sourceHandle, uint64_t payload);
+		/**
+		 * \brief Give the \c io_uring Buffer Held by an Activity Payload Back
+		 *
+		 * \param payload Payload stored alongside queued activity.
+		 */
+		void releasePayload(uint64_t payload);
+		/**
+		 * \brief Pick the \c io_uring Operation that Watches an Input Source
+		 *
+		 * \param inputSource Input source being registered.
+		 *
+		 * \return One of the \c UringOp values.
+		 */
+		uint8_t uringOpFor(InputSource *inputSource) const;
+		/**
+		 * \brief Queue the \c io_uring Operation that Watches a Registered Input Source
+		 *
+		 * \param slotIdx Slot of the input source in the slot table.
+		 */
+		void armUringSource(uint32_t slotIdx);
+		/**
+		 * \brief Queue the Operations of All Input Sources Waiting to be Re-armed
+		 */
+		void flushUringRearms();
+		/**
+		 * \brief Translate an \c io_uring Completion into Queued Activity
+		 *
+		 * \param userData Value the operation was submitted with.
+		 * \param result Result of the operation.
+		 * \param flags \c IORING_CQE_F_* flags of the completion.
+		 */
+		void pushUringCompletion(uint64_t userData, int32_t result, uint32_t flags);
+
+		/**
+		 * \brief Build the Handle Stored in the \c epoll() Event of a Registration
+		 *
+		 * \param slotIdx Index of the registration in the slot table.
+		 * \param generation Generation of the slot at registration time.
+		 *
+		 * \return Handle combining both values.
+		 */
+		static inline uint64_t makeSourceHandle(uint32_t slotIdx, uint32_t generation)
+		{ return (static_cast<uint64_t>(generation) << 32u) | slotIdx; }
+		/**
+		 * \brief Resolve a Registration Handle to its \c InputSource
+		 *
+		 * \param sourceHandle Handle produced by \c makeSourceHandle().
+		 *
+		 * \return Registered \c InputSource, or \c nullptr if the
+		 *         registration the handle refers to has been retired.
+		 */
+		InputSource* sourceForHandle(uint64_t sourceHandle) const;
+		/**
+		 * \brief Grow the Event Array After a Wait that Filled it Up
+		 *
+		 * \param numFds Number of events reported by the last wait.
+		 */
+		void adaptEventBatchSize(int numFds);
+		/**
+		 * \brief Wait for Input Activity, Spinning First if so Configured
+		 *
+		 * \return Number of events or completions collected, as reported
+		 *         by \c pollActivity().
+		 */
+		int waitForEvents();
+		/**
+		 * \brief Access the Dispatch Statistics Record for a Slot
+		 *
+		 * The record is (re)initialized whenever the slot holds an input
+		 * source other than the one the record was collected for.
+		 *
+		 * \param slotIdx Slot of the input source in the slot table.
+		 * \param source Input source currently occupying the slot.
+		 *
+		 * \return Statistics record for the input source.
+		 */
+		DispatchStatistics& dispatchStatsFor(uint32_t slotIdx, InputSource *source);
+		/**
+		 * \brief Arm, Re-arm or Disarm the Periodic Dispatch Statistics Report
+		 */
+		void updateDispatchStatsReport();
+		/**
+		 * \brief Apply the Configured \c SO_BUSY_POLL Value to a Socket
+		 *
+		 * \param fd File descriptor of a newly-registered input source;
+		 *           ignored unless it is a socket.
+		 */
+		void applyBusyPoll(int fd);
+		/**
+		 * \brief Access the Shared Timer Wheel, Creating it if Necessary
+		 *
+		 * \return Timer wheel registered with this \c RunLoop instance.
+		 */
+		TimerWheel* timerWheel();
+
+		/**
+		 * \brief Settings Used by this \c RunLoop Instance
+		 */
+		Configuration m_configuration;
+		/**
+		 * \brief Event Array Handed to the Operating System Multiplexor
+		 */
+		std::vector<struct epoll_event> m_eventBuffer;
+
+		/**
+		 * \brief \c io_uring Operations Used to Watch an Input Source
+		 */
+		enum UringOp
 		{
-		public:
-			bool operator()(InputSource *left, InputSource *right);
+			UO_POLL,
+			UO_POLL_MULTI,
+			UO_RECV_MULTI,
+			UO_RECVMSG_MULTI,
+			UO_READ
 		};
 
-		void pushEpollEventInputSource(struct epoll_event anEvent);
 		/**
-		 * \brief Collection of All \c InputSource Instances Managed by this \c RunLoop Instance
+		 * \brief Registration Record for a Single \c InputSource
+		 */
+		struct SourceSlot
+		{
+			/**
+			 * \brief Registered \c InputSource; \c nullptr if the Slot is Free
+			 */
+			InputSource *source;
+			/**
+			 * \brief Number of Times this Slot has Been Retired
+			 */
+			uint32_t generation;
+			/**
+			 * \brief Whether the \c InputSource is Waiting in \c m_redispatchHandles
+			 */
+			bool redispatchPending;
+			/**
+			 * \brief \c UringOp Watching the \c InputSource
+			 */
+			uint8_t uringOp;
+			/**
+			 * \brief Whether the \c io_uring Operation is Outstanding
+			 */
+			bool uringArmed;
+		};
+
+		/**
+		 * \brief Activity Set Aside Because it Carries Input that Must Not be Lost
+		 */
+		struct CarriedActivity
+		{
+			InputSource *source;
+			uint64_t handle;
+			uint64_t payload;
+		};
+
+		/**
+		 * \brief Entry of the Table of Callbacks Registered via \c addLoopCallback()
+		 */
+		struct LoopCallbackSlot
+		{
+			LoopCallback callback;
+			/**
+			 * \brief Bumped Every Time the Slot is Freed, so Stale Handles Stop Matching
+			 */
+			uint32_t generation;
+			LoopCallbackKind kind;
+			/**
+			 * \brief Whether the Callback is Registered and not Removed
+			 */
+			bool live;
+		};
+
+		/**
+		 * \brief Slot Table of All \c InputSource Instances Managed by this \c RunLoop Instance
+		 */
+		std::vector<SourceSlot> m_sourceSlots;
+		/**
+		 * \brief Indices of Retired Entries in \c m_sourceSlots Ready for Reuse
 		 */
-		std::vector<InputSource*> m_inputSources;
+		std::vector<uint32_t> m_freeSourceSlots;
+		/**
+		 * \brief Slot Index of Each Registered \c InputSource
+		 */
+		std::unordered_map<InputSource*, uint32_t> m_sourceSlotIndex;
 		/**
 		 * \brief Dictionary holding all timers registered with this \c RunLoop instance
 		 */
 		std::map<int, TimerInputSource*> m_timers;
+		/**
+		 * \brief Timer Wheel Shared by All Timers When Enabled in the Configuration
+		 */
+		TimerWheel *m_timerWheel;
+		/**
+		 * \brief Allocator for Coroutine Frames, Created on First Use
+		 */
+		FramePool *m_framePool;
+		/**
+		 * \brief Service Driving All Watchdogs, Created on First Use
+		 */
+		WatchdogService *m_watchdogService;
+
+		/**
+		 * \brief Queue of Closures Handed to this \c RunLoop via \c post()
+		 */
+		TaskQueue *m_taskQueue;
+		/**
+		 * \brief Wait Time Counters
+		 */
+		Statistics m_statistics;
+		/**
+		 * \brief Dispatch Statistics, Indexed by Slot in \c m_sourceSlots
+		 */
+		std::vector<DispatchStatistics> m_dispatchStats;
+		/**
+		 * \brief Time Spent in End-of-Loop Callbacks per Iteration
+		 */
+		LatencyHistogram m_endOfLoopDuration;
+		/**
+		 * \brief Listener that Writes the Periodic Dispatch Statistics Report
+		 */
+		InterruptListener *m_statsReporter;
+		/**
+		 * \brief Timer that Drives the Periodic Dispatch Statistics Report
+		 */
+		int m_statsReportTimerId;
+		/**
+		 * \brief Interval the Report Timer was Armed With
+		 */
+		double m_statsReportInterval;
+		/**
+		 * \brief Handles of Input Sources to Service in the Next Iteration
+		 */
+		std::vector<uint64_t> m_redispatchHandles;
+		/**
+		 * \brief Handles Being Serviced by \c dispatchRedispatches()
+		 */
+		std::vector<uint64_t> m_servicedRedispatches;
+
+		/**
+		 * \brief Monotonic Time, in Nanoseconds, at which the Dispatch Budget Runs Out
+		 */
+		uint64_t m_dispatchDeadlineNs;
+
 		/**
 		 * \brief Handle to the Operating System Input Multiplexing Service
 		 */
 		int m_epollFd;
+		/**
+		 * \brief Ring Used in Place of \c m_epollFd by the \c io_uring Backend
+		 */
+		IoUring *m_ioUring;
+		/**
+		 * \brief Handles of Input Sources Whose \c io_uring Operation Must be Re-armed
+		 */
+		std::vector<uint64_t> m_uringRearms;
+		/**
+		 * \brief Message Header Shared by All \c UO_RECVMSG_MULTI Operations
+		 */
+		struct msghdr m_uringMsgHdr;
+		/**
+		 * \brief Pre-read Input Deferred by \c deferActivity()
+		 */
+		std::vector<CarriedActivity> m_carriedActivity;
+
 		/**
 		 * \brief Field Used to Remember if Work Scheduler Termination Was Requested.
 		 */
-		bool m_terminationRequested;
+		std::atomic<bool> m_terminationRequested;
+
+		/**
+		 * \brief Callbacks Handed Over via \c addLoopIterEndCallback(), Owned by this Instance
+		 */
 		std::vector<LoopIterCbBase*> m_loopIterEndCb;
-		typedef std::priority_queue<InputSource*,std::vector<InputSource*>,InputSourceSort> ActivityQueue_t;
-		ActivityQueue_t m_sortedActivityQueue;
+		/**
+		 * \brief Callbacks Registered via \c addLoopCallback(), Indexed by Handle
+		 *
+		 * A \c std::deque so that adding a callback while others run does
+		 * not move the running ones.
+		 */
+		std::deque<LoopCallbackSlot> m_loopCbSlots;
+		/**
+		 * \brief Indices of Unused Entries in \c m_loopCbSlots
+		 */
+		std::vector<uint32_t> m_freeLoopCbSlots;
+		/**
+		 * \brief Indices into \c m_loopCbSlots, per Kind, in Run Order
+		 */
+		std::vector<uint32_t> m_loopCbOrder[LC_KIND_COUNT];
+		/**
+		 * \brief Whether Loop Callbacks are Running, so Removals Must Wait
+		 */
+		bool m_firingLoopCbs;
+		/**
+		 * \brief Whether a Loop Callback was Removed While Loop Callbacks Ran
+		 */
+		bool m_loopCbsRemoved;
+		/**
+		 * \brief Position in \c m_loopCbOrder[LC_IDLE] of the Next Idle Callback to Run
+		 */
+		size_t m_nextIdleCb;
+		/**
+		 * \brief Number of Input Source Callbacks Run in the Current Iteration
+		 */
+		uint64_t m_iterationDispatches;
+		/**
+		 * \brief Input Sources with Pending Activity, Ordered by Priority
+		 */
+		ActivityQueue m_sortedActivityQueue;
 		Thread *m_hostThread;
 
 		void fireEndOfLoopCbs();
+		bool fireIdleCbs();
+		void fireLoopCbs(LoopCallbackKind kind);
+		void purgeRemovedLoopCbs();
+
 	};
 
 }
@@ -21,6 +21,11 @@ using CoreKit::SignalInputSource;
 using CoreKit::InterruptListener;
 using CoreKit::OsErrorException;
 
+/**
+ * \brief Number of \c signalfd_siginfo Entries Read from the \c signalfd() at Once
+ */
+#define RF_SIS_BATCH_SIZE (16)
+
 SignalInputSource::SignalInputSource(int sigNum, InterruptListener *intrListener)
 : m_sigNum(sigNum), m_intrListener(intrListener), m_signalFd(-1)
 {
@@ -99,23 +104,27 @@ InterruptListener* SignalInputSource::interruptListener() const
 
 void SignalInputSource::fireCallback()
 {
-	struct signalfd_siginfo aSigInfo;
+	struct signalfd_siginfo sigInfos[RF_SIS_BATCH_SIZE];
 	ssize_t readResult = 0;
 
 	/*
 	 * signalfd() will publish via the file descriptor instances of the
 	 * signalfd_siginfo data structure whenever the application process
 	 * receives the signal of interest. See the signalfd() man page for more
-	 * details.
+	 * details. A single read returns as many of them as fit in the buffer;
+	 * only a full buffer means more may be waiting.
 	 */
 	do
 	{
-		readResult = read(m_signalFd, &aSigInfo, sizeof(aSigInfo));
-	} while (sizeof(aSigInfo) == readResult);
-
-	/*
-	 * Call the InterruptListener to let them execute any custom logic in
-	 * response to the received signal.
-	 */
-	m_intrListener->signalReceived(m_sigNum);
+		readResult = read(m_signalFd, sigInfos, sizeof(sigInfos));
+		if (readResult >= static_cast<ssize_t>(sizeof(struct signalfd_siginfo)))
+		{
+			/*
+			 * Call the InterruptListener to let them execute any custom
+			 * logic in response to the received signals.
+			 */
+			m_intrListener->signalsReceived(sigInfos, readResult / sizeof(struct signalfd_siginfo));
+		}
+	} while (static_cast<ssize_t>(sizeof(sigInfos)) == readResult);
 }
+
@@ -90,11 +90,14 @@ namespace CoreKit
 		 */
 		virtual InterruptListener* interruptListener() const;
 		/**
-		 * \brief Execute the \c InterruptListener::signalReceived() Callback
+		 * \brief Execute the \c InterruptListener::signalsReceived() Callback
 		 *
 		 * The \c fireCallback() method is part of the \c InputSource interface
-		 * and it calls the \c InterruptListener::signalReceived() method on
+		 * and it calls the \c InterruptListener::signalsReceived() method on
 		 * the \c InterruptListener instance registered with this input source.
+		 * Every pending instance of the signal is read from the \c signalfd()
+		 * at once (up to \c RF_SIS_BATCH_SIZE per read) and reported as one
+		 * batch.
 		 * \par
 		 *
 		 * This method is primarily used by the \c RunLoop class whenever it
@@ -6,6 +6,8 @@
  */
 
 #include <sys/epoll.h>
+#include <pthread.h>
+
 #include <cerrno>
 #include <algorithm>
 #include <functional>
@@ -16,8 +18,6 @@
 
 #include "SynchronizedRunLoop.h"
 
-#define RF_SRL_MAX_SIMULT_EVENTS (50u)
-
 using std::for_each;
 using std::bind1st;
 using std::mem_fun;
@@ -27,77 +27,99 @@ using CoreKit::OsErrorException;
 using CoreKit::InputSource;
 
 SynchronizedRunLoop::SynchronizedRunLoop(sem_t* runLoopSyncObj)
-: RunLoop(), m_runLoopSyncObj(runLoopSyncObj)
+: RunLoop(), m_frameSync(new SemaphoreFrameSync(runLoopSyncObj, false)), m_ownsFrameSync(true)
+{
+
+}
+
+
+SynchronizedRunLoop::SynchronizedRunLoop(sem_t* runLoopSyncObj, RunLoop::Configuration const& config)
+: RunLoop(config), m_frameSync(new SemaphoreFrameSync(runLoopSyncObj, false)), m_ownsFrameSync(true)
 {
 
 }
 
 
+SynchronizedRunLoop::SynchronizedRunLoop(FrameSync* frameSync, RunLoop::Configuration const& config)
+: RunLoop(config), m_frameSync(frameSync), m_ownsFrameSync(false)
+{
+
+}
+
 
+SynchronizedRunLoop::~SynchronizedRunLoop()
+{
+    if (m_ownsFrameSync)
+    {
+        delete m_frameSync;
+    }
+    m_frameSync = nullptr;
+}
 
 
 void SynchronizedRunLoop::run()
 {
-    int waitResult = 0;
-    int numFds = 0;
-    struct epoll_event theEvents[RF_SRL_MAX_SIMULT_EVENTS];
-    InputSource *anInputSource = NULL;
+    uint64_t framesReleased = 0u;
+
+    m_taskQueue->setConsumerThread(pthread_self());
 
     /*
-     * At the top of this loop we have a semaphore wait, that will force us to
-     * remain dormant until the external scheduler "posts" (i.e., increments)
-     * the semaphore, indicating it's our turn to run. After waiting on the
-     * semaphore, this loop examines all input sources and schedules work for
-     * those that exhibit input activity. The examination of these input
-     * sources (via epoll_wait()) doesn't block but instead reports what file
-     * descriptors are ready for input servicing.
+     * At the top of this loop we have a frame wait, that will force us to
+     * remain dormant until the external scheduler releases a frame (e.g.,
+     * "posts" the semaphore), indicating it's our turn to run. After the
+     * wait, this loop examines all input sources and schedules work for
+     * those that exhibit input activity, then runs the rate groups due in
+     * the frame. The examination of these input sources (via pollActivity())
+     * doesn't block but instead reports what file descriptors are ready for
+     * input servicing.
      */
     do
     {
         /*
-         * Wait for the semaphore to be available. That means it's our turn.
+         * Wait for the synchronization object to release a frame. That means
+         * it's our turn. A wait interrupted by a signal still services the
+         * input sources, but does not count as a frame.
          */
-        waitResult = sem_wait(m_runLoopSyncObj);
-        if ((waitResult != 0) && (errno != EINTR))
-        {
-            throw OsErrorException("sem_wait", errno);
-        }
+        framesReleased = m_frameSync->wait();
+        m_frameScheduler.beginFrame(framesReleased);
 
         /*
-         * The timeout for this epoll_wait() call is 0, meaning it will not
-         * block and simply return with the number of file descriptors that are
-         * exhibiting input activity at the time of the call.
+         * The timeout for this poll is 0, meaning it will not block and
+         * simply queue the input sources that are exhibiting input activity
+         * at the time of the call. Then process each of them from highest
+         * priority to lowest.
          */
-        numFds = epoll_wait(m_epollFd, &theEvents[0], RF_SRL_MAX_SIMULT_EVENTS,0);
-        if (numFds > 0)
-        {
-            /*
-             * Store all the events that epoll_wait() detected into a
-             * prioritized queue. Then process each event from highest priority
-             * to lowest.
-             */
-            for_each(&theEvents[0], &theEvents[numFds], bind1st(mem_fun(&SynchronizedRunLoop::pushEpollEventInputSource), this));
-            while (m_sortedActivityQueue.size() > 0)
-            {
-                /*
-                 * The InputSource instance pointer is stored in the event
-                 * definition, so in order to schedule the work for this source
-                 * all we have to do is typecast the "ptr" union member of the
-                 * "data" event structure member, and call its "fireCallback()"
-                 * method. The InputSource will know what to do from there.
-                 */
-                anInputSource = m_sortedActivityQueue.top();
-                anInputSource->fireCallback();
-                m_sortedActivityQueue.pop();
-            }
-        }
-
+        this->pollActivity(0);
+        this->dispatchActivity();
+        this->dispatchRedispatches();
+        m_frameScheduler.runRateGroups();
 
         if (!m_terminationRequested)
         {
             this->fireEndOfLoopCbs();
         }
+        m_frameScheduler.endFrame();
+
+        /*
+         * Idle callbacks use the slack left before the next frame, so their
+         * time is not charged to this one. Input left pending by the
+         * dispatch budget makes the loop busy.
+         */
+        if (!m_terminationRequested && m_redispatchHandles.empty() && m_carriedActivity.empty())
+        {
+            this->fireIdleCbs();
+        }
     } while(false == m_terminationRequested);
+
+    this->discardActivity();
 }
 
+
+void SynchronizedRunLoop::terminate()
+{
+    RunLoop::terminate();
+    m_frameSync->interrupt();
+}
+
+
 // vim: set ts=4 sw=4 expandtab:
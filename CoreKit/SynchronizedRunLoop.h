@@ -9,12 +9,21 @@
 
 #include <semaphore.h>
 
+#include <CoreKit/FrameScheduler.h>
+#include <CoreKit/FrameSync.h>
 #include <CoreKit/RunLoop.h>
 
 namespace CoreKit
 {
     /**
      * \brief Run loop slaved to an external synchronization object.
+     *
+     * Every frame released through the synchronization object runs one
+     * iteration: the input sources with activity are serviced, then the
+     * rate groups registered with \c frameScheduler() that are due in that
+     * frame. Idle callbacks run once the frame is over, in the time left
+     * before the next one.
+     *
      * \author Rolando J. Nieves
      * \date 2012-11-16 10:13:00
      */
@@ -29,18 +38,55 @@ namespace CoreKit
          */
         explicit SynchronizedRunLoop(sem_t* runLoopSyncObj);
 
+        /**
+         * \brief Initialize the synchronization object and the run loop settings.
+         *
+         * \param[in] runLoopSyncObj - Synchronization object to use.
+         * \param[in] config - Settings for the underlying run loop. The wait
+         *                     timeout is ignored, since this run loop never
+         *                     blocks on its multiplexor.
+         */
+        SynchronizedRunLoop(sem_t* runLoopSyncObj, RunLoop::Configuration const& config);
+
+        /**
+         * \brief Initialize the run loop with any kind of synchronization object.
+         *
+         * \param[in] frameSync - Synchronization object to use; not owned,
+         *                        so it must outlive this run loop.
+         * \param[in] config - Settings for the underlying run loop.
+         */
+        SynchronizedRunLoop(FrameSync* frameSync, RunLoop::Configuration const& config);
+
         /**
          * \brief Destructor.
          */
-        virtual ~SynchronizedRunLoop() = default;
+        virtual ~SynchronizedRunLoop();
 
         /**
          * \brief Start the run loop.
          */
         virtual void run();
 
+        /**
+         * \brief Request termination of this run loop.
+         *
+         * Besides what \c RunLoop::terminate() does, interrupts the wait on
+         * the synchronization object, so the loop stops without waiting for
+         * the next frame.
+         */
+        virtual void terminate();
+
+        /**
+         * \brief Access the scheduler of the rate groups run every frame.
+         *
+         * \return Frame scheduler owned by this run loop.
+         */
+        inline FrameScheduler& frameScheduler() { return m_frameScheduler; }
+
     private:
-        sem_t *m_runLoopSyncObj;
+        FrameSync *m_frameSync;
+        bool m_ownsFrameSync;
+        FrameScheduler m_frameScheduler;
     };
 
 }
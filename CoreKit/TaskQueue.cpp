@@ -0,0 +1,242 @@
+/**
+ * \file TaskQueue.cpp
+ * \brief Contains the implementation of the \c TaskQueue class.
+ * \date 2026-10-16 11:24:51
+ * \author Rolando J. Nieves
+ */
+
+#include <cerrno>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <CoreKit/OsErrorException.h>
+#include <CoreKit/PreconditionNotMetException.h>
+#include <CoreKit/RuntimeErrorException.h>
+
+#include "TaskQueue.h"
+
+#define RF_CK_TQ_BLOCK_SPINS (64u)
+#define RF_CK_TQ_BLOCK_SLEEP_NS (50000L)
+#define RF_CK_TQ_PRIORITY (128u)
+
+
+namespace CoreKit
+{
+
+TaskQueue::TaskQueue(size_t capacity, OverflowPolicy defaultPolicy):
+    InputSource(RF_CK_TQ_PRIORITY),
+    m_tasks(capacity),
+    m_eventFd(-1),
+    m_wakePending(false),
+    m_defaultPolicy(defaultPolicy),
+    m_droppedCount(0u),
+    m_consumerKnown(false),
+    m_shutDown(false),
+    m_consumerThread()
+{
+    m_eventFd = eventfd(0uLL, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (-1 == m_eventFd)
+    {
+        throw OsErrorException("eventfd()", errno);
+    }
+}
+
+
+TaskQueue::~TaskQueue()
+{
+    if (m_eventFd != -1)
+    {
+        close(m_eventFd);
+        m_eventFd = -1;
+    }
+}
+
+
+int
+TaskQueue::fileDescriptor() const
+{
+    return m_eventFd;
+}
+
+
+InterruptListener*
+TaskQueue::interruptListener() const
+{
+    return nullptr;
+}
+
+
+void
+TaskQueue::fireCallback()
+{
+    eventfd_t readValue = 0uLL;
+    Task aTask;
+    size_t budget = m_tasks.capacity();
+
+    /*
+     * Empty the eventfd() first, then clear the wake up flag before
+     * draining. A closure posted before the flag is cleared is drained
+     * below; one posted after raises the flag again and writes the
+     * eventfd(), which stays readable for the next run loop iteration.
+     * Clearing the flag first would let a post's write be consumed here
+     * while its flag stays raised, and every later post would skip the
+     * write.
+     */
+    eventfd_read(m_eventFd, &readValue);
+    m_wakePending.store(false, std::memory_order_seq_cst);
+
+    try
+    {
+        while ((budget > 0u) && m_tasks.tryPop(aTask))
+        {
+            --budget;
+            aTask();
+            aTask = nullptr;
+        }
+    }
+    catch (...)
+    {
+        /*
+         * Make sure the closures behind the one that failed still run.
+         */
+        this->wake();
+        throw;
+    }
+
+    if (0u == budget)
+    {
+        this->wake();
+    }
+}
+
+
+bool
+TaskQueue::post(Task&& task)
+{
+    return this->post(std::move(task), this->defaultPolicy());
+}
+
+
+bool
+TaskQueue::post(Task&& task, OverflowPolicy policy)
+{
+    bool result = m_tasks.tryPush(std::move(task)) || this->handleOverflow(task, policy);
+
+    if (result)
+    {
+        this->wake();
+    }
+
+    return result;
+}
+
+
+size_t
+TaskQueue::postBatch(std::vector< Task >& tasks, OverflowPolicy policy)
+{
+    size_t result = 0u;
+
+    for (Task& aTask : tasks)
+    {
+        if (m_tasks.tryPush(std::move(aTask)) || this->handleOverflow(aTask, policy))
+        {
+            ++result;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (result > 0u)
+    {
+        this->wake();
+    }
+
+    return result;
+}
+
+
+void
+TaskQueue::wake()
+{
+    if (!m_wakePending.exchange(true, std::memory_order_seq_cst))
+    {
+        eventfd_write(m_eventFd, 1uLL);
+    }
+}
+
+
+void
+TaskQueue::setConsumerThread(pthread_t consumerThread)
+{
+    m_consumerThread = consumerThread;
+    m_consumerKnown.store(true, std::memory_order_release);
+}
+
+
+void
+TaskQueue::shutDown()
+{
+    m_shutDown.store(true, std::memory_order_release);
+}
+
+
+bool
+TaskQueue::handleOverflow(Task& task, OverflowPolicy policy)
+{
+    bool result = false;
+    unsigned spins = 0u;
+    struct timespec backoff = { 0, RF_CK_TQ_BLOCK_SLEEP_NS };
+
+    switch (policy)
+    {
+    case OP_BLOCK:
+        if (m_consumerKnown.load(std::memory_order_acquire) &&
+            pthread_equal(pthread_self(), m_consumerThread))
+        {
+            throw PreconditionNotMetException("Blocking post to a full task queue from its own run loop thread.");
+        }
+
+        /*
+         * Make sure the consumer is awake, then spin briefly before backing
+         * off to short sleeps until room frees up. A consumer that is gone
+         * never makes room, so stop waiting once the queue is shut down.
+         */
+        this->wake();
+        while (!(result = m_tasks.tryPush(std::move(task))))
+        {
+            if (m_shutDown.load(std::memory_order_acquire))
+            {
+                m_droppedCount.fetch_add(1u, std::memory_order_relaxed);
+                break;
+            }
+            if (spins < RF_CK_TQ_BLOCK_SPINS)
+            {
+                ++spins;
+                sched_yield();
+            }
+            else
+            {
+                nanosleep(&backoff, nullptr);
+            }
+        }
+        break;
+
+    case OP_DROP:
+        m_droppedCount.fetch_add(1u, std::memory_order_relaxed);
+        break;
+
+    case OP_THROW:
+    default:
+        throw RuntimeErrorException("Task queue full.");
+    }
+
+    return result;
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
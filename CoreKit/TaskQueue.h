@@ -0,0 +1,215 @@
+/**
+ * \file TaskQueue.h
+ * \brief Contains the definition of the \c TaskQueue class.
+ * \date 2026-10-16 11:24:51
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_TASKQUEUE_H_
+#define _FOUNDATION_COREKIT_TASKQUEUE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <CoreKit/BoundedMpmcQueue.h>
+#include <CoreKit/InputSource.h>
+
+namespace CoreKit
+{
+
+/**
+ * \brief \c CoreKit::RunLoop input source that runs closures posted by any thread.
+ *
+ * Closures are stored in a fixed capacity \c BoundedMpmcQueue, so posting
+ * never takes a lock. A single \c eventfd() wakes up the consuming
+ * \c RunLoop, and an atomic flag ensures only the first of a burst of posts
+ * pays for the \c eventfd_write() system call.
+ *
+ * \note Instances are normally created and owned by \c CoreKit::RunLoop.
+ *       See \c RunLoop::post().
+ */
+class TaskQueue : public InputSource
+{
+public:
+    /**
+     * \brief Type of the closures accepted by the queue.
+     */
+    using Task = std::function< void() >;
+
+    /**
+     * \brief What to do when a closure is posted to a full queue.
+     */
+    enum OverflowPolicy
+    {
+        /**
+         * \brief Wait until the consumer makes room, or the queue is shut down.
+         */
+        OP_BLOCK = 0,
+        /**
+         * \brief Discard the closure and count it as dropped.
+         */
+        OP_DROP,
+        /**
+         * \brief Throw a \c CoreKit::RuntimeErrorException.
+         */
+        OP_THROW
+    };
+
+private:
+    BoundedMpmcQueue< Task > m_tasks;
+    int m_eventFd;
+    std::atomic< bool > m_wakePending;
+    std::atomic< int > m_defaultPolicy;
+    std::atomic< uint64_t > m_droppedCount;
+    std::atomic< bool > m_consumerKnown;
+    std::atomic< bool > m_shutDown;
+    pthread_t m_consumerThread;
+
+    bool handleOverflow(Task& task, OverflowPolicy policy);
+
+public:
+    /**
+     * \brief Main constructor.
+     *
+     * \param[in] capacity - Maximum number of closures waiting to run.
+     * \param[in] defaultPolicy - Policy used by the \c post() overloads that
+     *            do not specify one.
+     */
+    TaskQueue(size_t capacity, OverflowPolicy defaultPolicy);
+
+    TaskQueue(TaskQueue const& other) = delete;
+    TaskQueue(TaskQueue&& other) = delete;
+
+    /**
+     * \brief Destructor.
+     *
+     * Closures still in the queue are discarded without running.
+     */
+    virtual ~TaskQueue();
+
+    /**
+     * \brief Access the underlying \c eventfd() file descriptor.
+     *
+     * \return File descriptor associated with this input source.
+     */
+    virtual int fileDescriptor() const override;
+
+    /**
+     * \brief Closures carry their own context, so the queue has no listener.
+     *
+     * \return Always \c nullptr.
+     */
+    virtual InterruptListener* interruptListener() const override;
+
+    /**
+     * \brief Run the closures waiting in the queue.
+     *
+     * At most one queue's worth of closures run per call, so closures that
+     * keep posting more work cannot starve the other input sources.
+     */
+    virtual void fireCallback() override;
+
+    /**
+     * \brief Queue a closure using the default overflow policy.
+     *
+     * Safe to call from any thread.
+     *
+     * \param[in] task - Closure to run on the consuming \c RunLoop.
+     *
+     * \return \c true if the closure was queued; \c false if it was dropped.
+     */
+    bool post(Task&& task);
+
+    /**
+     * \brief Queue a closure using a specific overflow policy.
+     *
+     * Safe to call from any thread.
+     *
+     * \param[in] task - Closure to run on the consuming \c RunLoop.
+     * \param[in] policy - What to do if the queue is full.
+     *
+     * \return \c true if the closure was queued; \c false if it was dropped.
+     */
+    bool post(Task&& task, OverflowPolicy policy);
+
+    /**
+     * \brief Queue several closures, waking the consumer only once.
+     *
+     * Safe to call from any thread. The closures that were queued are moved
+     * out of \c tasks.
+     *
+     * \param[in,out] tasks - Closures to run on the consuming \c RunLoop.
+     * \param[in] policy - What to do if the queue fills up.
+     *
+     * \return Number of closures queued.
+     */
+    size_t postBatch(std::vector< Task >& tasks, OverflowPolicy policy);
+
+    /**
+     * \brief Wake up the consuming \c RunLoop.
+     *
+     * Wake ups are coalesced: only the first call after the consumer last
+     * drained the queue reaches the \c eventfd().
+     */
+    void wake();
+
+    /**
+     * \brief Record the thread that consumes the queue.
+     *
+     * With the \c OP_BLOCK policy, a full queue would never drain if the
+     * consumer thread itself waited on it; posts from that thread throw a
+     * \c CoreKit::PreconditionNotMetException instead.
+     *
+     * \param[in] consumerThread - Thread running the consuming \c RunLoop.
+     */
+    void setConsumerThread(pthread_t consumerThread);
+
+    /**
+     * \brief Stop waiting for a consumer that is gone.
+     *
+     * Called once the consuming \c RunLoop stops for good. From then on,
+     * posts that find the queue full are dropped even under the
+     * \c OP_BLOCK policy, and posts already waiting for room give up.
+     */
+    void shutDown();
+
+    /**
+     * \brief Access the policy used by the \c post() overloads that do not specify one.
+     *
+     * \return Default overflow policy.
+     */
+    inline OverflowPolicy defaultPolicy() const { return static_cast< OverflowPolicy >(m_defaultPolicy.load(std::memory_order_relaxed)); }
+
+    /**
+     * \brief Alter the policy used by the \c post() overloads that do not specify one.
+     *
+     * \param[in] policy - New default overflow policy.
+     */
+    inline void setDefaultPolicy(OverflowPolicy policy) { m_defaultPolicy.store(policy, std::memory_order_relaxed); }
+
+    /**
+     * \brief Count the closures discarded due to the \c OP_DROP policy.
+     *
+     * \return Number of dropped closures.
+     */
+    inline uint64_t droppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Access the maximum number of closures waiting to run.
+     *
+     * \return Queue capacity.
+     */
+    inline size_t capacity() const { return m_tasks.capacity(); }
+
+    TaskQueue& operator=(TaskQueue const& other) = delete;
+    TaskQueue& operator=(TaskQueue&& other) = delete;
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_TASKQUEUE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -17,9 +17,12 @@
 #include "Thread.h"
 
 using CoreKit::Thread;
+using CoreKit::ThreadAttributes;
 using CoreKit::RunLoop;
 using CoreKit::ThreadDelegate;
 using CoreKit::OsErrorException;
+using CoreKit::AppLog;
+using CoreKit::EndLog;
 
 /**
  * \brief Common Entry Point for POSIX Threads
@@ -35,6 +38,11 @@ void* Thread::threadKickoffRoutine(void *userData)
 {
 	Thread *theThread = (Thread *)userData;
 
+	if (theThread->m_attributes.stackPrefault > 0u)
+	{
+		ThreadAttributes::prefaultStack(theThread->m_attributes.stackPrefault);
+	}
+
 	theThread->threadDelegate()->doThreadLogic(theThread);
 
     theThread->m_threadState = Thread::STOPPED;
@@ -60,16 +68,61 @@ Thread::Thread(pthread_t runningThreadId, sem_t *runLoopSyncObj)
 }
 
 
+Thread::Thread(pthread_t runningThreadId, FrameSync *frameSync)
+: m_threadDelegate(nullptr), m_runLoop(nullptr), m_threadState(Thread::RUNNING), m_threadId(runningThreadId),
+  m_isDetached(true), m_hostApp(nullptr)
+{
+	m_runLoop = new SynchronizedRunLoop(frameSync, RunLoop::defaultConfiguration());
+	m_runLoop->setHostThread(this);
+}
+
+
 Thread::Thread(ThreadDelegate* thrDelegate, Application *hostApp, bool detached)
     : m_threadDelegate(thrDelegate),m_runLoop(nullptr),m_threadState(Thread::JOINED),m_threadId(0),
       m_isDetached(detached), m_hostApp(hostApp)
 {
+	this->spawn();
+}
+
+
+Thread::Thread(ThreadDelegate* thrDelegate, Application *hostApp, ThreadAttributes const& attributes, bool detached)
+    : m_threadDelegate(thrDelegate),m_runLoop(nullptr),m_threadState(Thread::JOINED),m_threadId(0),
+      m_isDetached(detached), m_hostApp(hostApp), m_attributes(attributes)
+{
+	this->spawn();
+}
+
+
+void Thread::spawn()
+{
+	int createResult = 0;
+
 	m_runLoop = construct(RunLoop::myType());
 	m_runLoop->setHostThread(this);
 
-	if (pthread_create(&m_threadId, nullptr, &Thread::threadKickoffRoutine, this) == -1)
+	if (m_attributes.isDefault())
+	{
+		createResult = pthread_create(&m_threadId, nullptr, &Thread::threadKickoffRoutine, this);
+	}
+	else
+	{
+		createResult = m_attributes.createThread(&m_threadId, &Thread::threadKickoffRoutine, this, "subordinate thread");
+		if ((0 == createResult) && (m_hostApp != nullptr))
+		{
+			m_hostApp->log() << AppLog::LL_INFO << "Subordinate thread started with "
+				<< m_attributes.describe() << "." << EndLog;
+		}
+	}
+
+	/*
+	 * pthread_create() reports failures through its return value, not
+	 * through errno.
+	 */
+	if (createResult != 0)
 	{
-		throw OsErrorException("pthread_create", errno);
+		destroy(m_runLoop);
+		m_runLoop = nullptr;
+		throw OsErrorException("pthread_create", createResult);
 	}
 
 	if (m_isDetached)
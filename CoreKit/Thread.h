@@ -10,6 +10,8 @@
 #include <pthread.h>
 #include <semaphore.h>
 
+#include "FrameSync.h"
+#include "ThreadAttributes.h"
 #include "ThreadDelegate.h"
 #include "RunLoop.h"
 #include "factory.h"
@@ -86,6 +88,18 @@ namespace CoreKit
          *            run loop.
          */
 		Thread(pthread_t runningThreadId, sem_t *runLoopSyncObj);
+		/**
+		 * \brief Adopt an already running thread paced by any kind of synchronization object.
+		 *
+		 * Behaves like the constructor that takes a semaphore, but accepts
+		 * any of the \c FrameSync variants.
+		 *
+		 * \param runningThreadId Identifier of the POSIX thread this instance
+		 *                        should adopt.
+		 * \param frameSync Synchronization object that paces the host run
+		 *                  loop; not owned, so it must outlive this instance.
+		 */
+		Thread(pthread_t runningThreadId, FrameSync *frameSync);
 		/**
 		 * \brief Spawn a New Concurrent Task Using a POSIX Thread
 		 *
@@ -106,6 +120,24 @@ namespace CoreKit
 		 *                 otherwise.
 		 */
 		Thread(ThreadDelegate* thrDelegate, Application *hostApp, bool detached = true);
+		/**
+		 * \brief Spawn a New Concurrent Task with Real-Time Settings
+		 *
+		 * Behaves like the constructor above, but starts the POSIX thread
+		 * with the scheduling policy, priority, CPU affinity and stack
+		 * settings given. Settings the process is not allowed to use are
+		 * dropped with a warning; \c attributes() tells what took effect,
+		 * which is also written to the application log.
+		 *
+		 * \param thrDelegate \c ThreadDelegate derived instance that is
+		 *                    responsible for implementing custom task
+		 *                    behavior.
+		 * \param hostApp \c Application instance that is hosting this thread.
+		 * \param attributes Real-time settings for the new thread.
+		 * \param detached \c true if the thread should be created as
+		 *                 "detached;" \c false otherwise.
+		 */
+		Thread(ThreadDelegate* thrDelegate, Application *hostApp, ThreadAttributes const& attributes, bool detached = true);
 		/**
 		 * \brief Terminate the Concurrent Task and Release All Allocated Objects
 		 *
@@ -167,6 +199,14 @@ namespace CoreKit
 		 *         task behavior.
 		 */
 		virtual pthread_t threadId() const { return m_threadId; };
+		/**
+		 * \brief Access the Real-Time Settings in Effect for This \c Thread
+		 *
+		 * \return Settings the thread was started with, minus those the
+		 *         process was not allowed to use; all defaults for adopted
+		 *         threads.
+		 */
+		inline ThreadAttributes const& attributes() const { return m_attributes; }
 
 		/**
 		 * \brief Clean Up After ("join") a POSIX Thread
@@ -208,8 +248,14 @@ namespace CoreKit
 		 * \brief Application Instance Managing this Concurrent Thread
 		 */
 		Application *m_hostApp;
+		/**
+		 * \brief Real-Time Settings in Effect for the Concurrent Task
+		 */
+		ThreadAttributes m_attributes;
 
         static void* threadKickoffRoutine(void *userData);
+        void spawn();
+
 	};
 
 }
@@ -0,0 +1,338 @@
+/**
+ * \file ThreadAttributes.cpp
+ * \brief Contains the implementation of the \c ThreadAttributes class.
+ * \date 2026-10-16 19:40:22
+ * \author Rolando J. Nieves
+ */
+
+#include <alloca.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include <CoreKit/Application.h>
+
+#include "ThreadAttributes.h"
+
+/**
+ * \brief Bytes of stack, next to the guard page, never prefaulted.
+ */
+#define RF_CK_TATTR_STACK_MARGIN (64u * 1024u)
+
+
+namespace CoreKit
+{
+
+/**
+ * \brief Translate a policy into its POSIX counterpart.
+ */
+static int
+nativePolicyFor(ThreadAttributes::SchedulingPolicy policy)
+{
+    switch (policy)
+    {
+    case ThreadAttributes::SP_FIFO:
+        return SCHED_FIFO;
+
+    case ThreadAttributes::SP_RR:
+        return SCHED_RR;
+
+    default:
+        return SCHED_OTHER;
+    }
+}
+
+
+/**
+ * \brief Name a policy the way the system documentation does.
+ */
+static char const*
+policyName(ThreadAttributes::SchedulingPolicy policy)
+{
+    switch (policy)
+    {
+    case ThreadAttributes::SP_OTHER:
+        return "SCHED_OTHER";
+
+    case ThreadAttributes::SP_FIFO:
+        return "SCHED_FIFO";
+
+    case ThreadAttributes::SP_RR:
+        return "SCHED_RR";
+
+    default:
+        return "inherited scheduling";
+    }
+}
+
+
+/**
+ * \brief List the CPUs in a mask, comma separated.
+ */
+static std::string
+cpuListFor(cpu_set_t const& cpus)
+{
+    std::ostringstream listText;
+    bool first = true;
+
+    for (unsigned aCpu = 0u; aCpu < CPU_SETSIZE; ++aCpu)
+    {
+        if (CPU_ISSET(aCpu, &cpus))
+        {
+            listText << (first ? "" : ",") << aCpu;
+            first = false;
+        }
+    }
+
+    return listText.str();
+}
+
+
+ThreadAttributes::ThreadAttributes():
+    policy(SP_INHERIT),
+    priority(0),
+    pinned(false),
+    stackSize(0u),
+    stackPrefault(0u)
+{
+    CPU_ZERO(&cpus);
+}
+
+
+bool
+ThreadAttributes::isDefault() const
+{
+    return ((SP_INHERIT == policy) && !pinned && (0u == stackSize) && (0u == stackPrefault));
+}
+
+
+std::string
+ThreadAttributes::describe() const
+{
+    std::ostringstream description;
+
+    description << policyName(policy);
+    if ((SP_FIFO == policy) || (SP_RR == policy))
+    {
+        description << " priority " << priority;
+    }
+    if (pinned)
+    {
+        description << ", CPUs " << cpuListFor(cpus);
+    }
+    if (stackSize > 0u)
+    {
+        description << ", " << (stackSize / 1024u) << " KiB stack";
+    }
+    if (stackPrefault > 0u)
+    {
+        description << ", " << (stackPrefault / 1024u) << " KiB of stack prefaulted";
+    }
+
+    return description.str();
+}
+
+
+void
+ThreadAttributes::dropScheduling(std::string const& threadName, int errorCode)
+{
+    if (G_MyApp != nullptr)
+    {
+        G_MyApp->log() << AppLog::LL_WARNING << "The " << threadName << " can not use "
+            << policyName(policy) << " priority " << priority << ": ";
+        if (EPERM == errorCode)
+        {
+            G_MyApp->log() << "the process lacks the privilege (it needs CAP_SYS_NICE, or an RLIMIT_RTPRIO of at least "
+                << priority << ")";
+        }
+        else
+        {
+            G_MyApp->log() << strerror(errorCode);
+        }
+        G_MyApp->log() << "; it keeps its current scheduling." << EndLog;
+    }
+
+    policy = SP_INHERIT;
+    priority = 0;
+}
+
+
+void
+ThreadAttributes::dropAffinity(std::string const& threadName, int errorCode)
+{
+    if (G_MyApp != nullptr)
+    {
+        G_MyApp->log() << AppLog::LL_WARNING << "The " << threadName << " can not be pinned to CPUs "
+            << cpuListFor(cpus) << ": " << strerror(errorCode) << "; it may run on any CPU." << EndLog;
+    }
+
+    pinned = false;
+    CPU_ZERO(&cpus);
+}
+
+
+int
+ThreadAttributes::createThread(pthread_t *threadId, void* (*startRoutine)(void*), void *startArg, std::string const& threadName)
+{
+    int result = 0;
+
+    if ((policy != SP_FIFO) && (policy != SP_RR))
+    {
+        priority = 0;
+    }
+
+    /*
+     * Each failed attempt drops one setting, so this runs at most three
+     * times; an error no setting accounts for ends it right away.
+     */
+    for (;;)
+    {
+        pthread_attr_t threadAttr;
+        size_t actualStackSize = 0u;
+
+        pthread_attr_init(&threadAttr);
+        if ((stackSize > 0u) && ((result = pthread_attr_setstacksize(&threadAttr, stackSize)) != 0))
+        {
+            if (G_MyApp != nullptr)
+            {
+                G_MyApp->log() << AppLog::LL_WARNING << "The " << threadName << " can not have a "
+                    << stackSize << " byte stack: " << strerror(result) << "; it gets the default size." << EndLog;
+            }
+            stackSize = 0u;
+        }
+        pthread_attr_getstacksize(&threadAttr, &actualStackSize);
+        if (stackPrefault > 0u)
+        {
+            size_t usableStack = (actualStackSize > RF_CK_TATTR_STACK_MARGIN) ? (actualStackSize - RF_CK_TATTR_STACK_MARGIN) : 0u;
+
+            stackPrefault = (stackPrefault < usableStack) ? stackPrefault : usableStack;
+        }
+
+        if (policy != SP_INHERIT)
+        {
+            struct sched_param schedParam;
+
+            memset(&schedParam, 0, sizeof(schedParam));
+            schedParam.sched_priority = priority;
+            pthread_attr_setinheritsched(&threadAttr, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&threadAttr, nativePolicyFor(policy));
+            if ((result = pthread_attr_setschedparam(&threadAttr, &schedParam)) != 0)
+            {
+                pthread_attr_destroy(&threadAttr);
+                this->dropScheduling(threadName, result);
+                continue;
+            }
+        }
+
+        if (pinned && ((result = pthread_attr_setaffinity_np(&threadAttr, sizeof(cpu_set_t), &cpus)) != 0))
+        {
+            pthread_attr_destroy(&threadAttr);
+            this->dropAffinity(threadName, result);
+            continue;
+        }
+
+        result = pthread_create(threadId, &threadAttr, startRoutine, startArg);
+        pthread_attr_destroy(&threadAttr);
+
+        if (0 == result)
+        {
+            break;
+        }
+        else if (((EPERM == result) || (EINVAL == result)) && (policy != SP_INHERIT))
+        {
+            this->dropScheduling(threadName, result);
+        }
+        else if ((EINVAL == result) && pinned)
+        {
+            this->dropAffinity(threadName, result);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+
+void
+ThreadAttributes::applyToCurrentThread(std::string const& threadName)
+{
+    int result = 0;
+
+    if (policy != SP_INHERIT)
+    {
+        struct sched_param schedParam;
+
+        if ((policy != SP_FIFO) && (policy != SP_RR))
+        {
+            priority = 0;
+        }
+        memset(&schedParam, 0, sizeof(schedParam));
+        schedParam.sched_priority = priority;
+        if ((result = pthread_setschedparam(pthread_self(), nativePolicyFor(policy), &schedParam)) != 0)
+        {
+            this->dropScheduling(threadName, result);
+        }
+    }
+
+    if (pinned && ((result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus)) != 0))
+    {
+        this->dropAffinity(threadName, result);
+    }
+
+    stackSize = 0u;
+    if (stackPrefault > 0u)
+    {
+        stackPrefault = ThreadAttributes::prefaultStack(stackPrefault);
+    }
+}
+
+
+size_t
+ThreadAttributes::prefaultStack(size_t byteCount)
+{
+    pthread_attr_t selfAttr;
+    void *stackLow = nullptr;
+    size_t stackBytes = 0u;
+    size_t usableStack = 0u;
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile unsigned char *touchArea = nullptr;
+
+    /*
+     * The stack grows down, so what is left of it lies between the current
+     * frame and its lowest address.
+     */
+    if (pthread_getattr_np(pthread_self(), &selfAttr) == 0)
+    {
+        if (pthread_attr_getstack(&selfAttr, &stackLow, &stackBytes) == 0)
+        {
+            uintptr_t stackLeft = reinterpret_cast<uintptr_t>(&usableStack) - reinterpret_cast<uintptr_t>(stackLow);
+
+            usableStack = (stackLeft > RF_CK_TATTR_STACK_MARGIN) ? (stackLeft - RF_CK_TATTR_STACK_MARGIN) : 0u;
+        }
+        pthread_attr_destroy(&selfAttr);
+    }
+
+    byteCount = (byteCount < usableStack) ? byteCount : usableStack;
+    if (0u == byteCount)
+    {
+        return 0u;
+    }
+
+    touchArea = static_cast<volatile unsigned char*>(alloca(byteCount));
+    for (size_t offset = 0u; offset < byteCount; offset += pageSize)
+    {
+        touchArea[offset] = 0u;
+    }
+    touchArea[byteCount - 1u] = 0u;
+
+    return byteCount;
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,141 @@
+/**
+ * \file ThreadAttributes.h
+ * \brief Contains the definition of the \c ThreadAttributes class.
+ * \date 2026-10-16 19:40:22
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_THREADATTRIBUTES_H_
+#define _FOUNDATION_COREKIT_THREADATTRIBUTES_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <string>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Real-time settings of a thread.
+ *
+ * Collects the scheduling policy and priority, the CPUs a thread may run
+ * on, its stack size and how much of its stack is touched up front, so
+ * that a control loop neither waits on a lower priority task nor takes a
+ * page fault the first time its stack grows.\par
+ *
+ * Settings the process is not allowed to use (real-time policies need
+ * \c CAP_SYS_NICE or a large enough \c RLIMIT_RTPRIO) are not fatal: they
+ * are dropped, with a warning in the application log, and the thread runs
+ * with whatever remains. The instance is updated to say what took effect.
+ */
+class ThreadAttributes
+{
+public:
+    enum SchedulingPolicy
+    {
+        /**
+         * \brief Keep the policy and priority of the creating thread.
+         */
+        SP_INHERIT = 0,
+        /**
+         * \brief Regular time sharing (\c SCHED_OTHER).
+         */
+        SP_OTHER,
+        /**
+         * \brief Real-time, first in first out (\c SCHED_FIFO).
+         */
+        SP_FIFO,
+        /**
+         * \brief Real-time, round robin (\c SCHED_RR).
+         */
+        SP_RR
+    };
+
+    /**
+     * \brief Scheduling policy.
+     */
+    SchedulingPolicy policy;
+    /**
+     * \brief Scheduling priority; only meaningful for \c SP_FIFO and
+     *        \c SP_RR, where it ranges from 1 to 99.
+     */
+    int priority;
+    /**
+     * \brief Whether \c cpus restricts the CPUs the thread may run on.
+     */
+    bool pinned;
+    /**
+     * \brief CPUs the thread may run on, when \c pinned.
+     */
+    cpu_set_t cpus;
+    /**
+     * \brief Stack size, in bytes; zero for the system default.
+     */
+    size_t stackSize;
+    /**
+     * \brief Bytes of stack touched before the thread does any work; zero
+     *        to touch none. Clipped so a guard margin is left untouched.
+     */
+    size_t stackPrefault;
+
+    ThreadAttributes();
+
+    /**
+     * \brief Tell whether every setting is left at the system default.
+     */
+    bool isDefault() const;
+
+    /**
+     * \brief Describe the settings in a form fit for the application log.
+     *
+     * \return Text such as "SCHED_FIFO priority 80, CPUs 2,3, 64 KiB of
+     *         stack prefaulted".
+     */
+    std::string describe() const;
+
+    /**
+     * \brief Start a thread with these settings.
+     *
+     * Settings that \c pthread_create() refuses for lack of privileges, or
+     * as invalid, are dropped one at a time, with a warning, until the
+     * thread starts.
+     *
+     * \param[out] threadId - Receives the identifier of the new thread.
+     * \param[in] startRoutine - Entry point of the new thread.
+     * \param[in] startArg - Argument for \c startRoutine.
+     * \param[in] threadName - Name used in warnings, e.g. "main thread".
+     *
+     * \return Zero on success; the \c pthread_create() error otherwise.
+     */
+    int createThread(pthread_t *threadId, void* (*startRoutine)(void*), void *startArg, std::string const& threadName);
+
+    /**
+     * \brief Apply these settings to the calling thread.
+     *
+     * The stack size of a running thread can not change, so \c stackSize
+     * is ignored. Settings that fail are dropped with a warning.
+     *
+     * \param[in] threadName - Name used in warnings, e.g. "main thread".
+     */
+    void applyToCurrentThread(std::string const& threadName);
+
+    /**
+     * \brief Touch the calling thread's stack so its pages are resident.
+     *
+     * \param[in] byteCount - Bytes to touch, below the current stack frame.
+     *
+     * \return Bytes actually touched, after leaving the guard margin.
+     */
+    static size_t prefaultStack(size_t byteCount);
+
+private:
+    void dropScheduling(std::string const& threadName, int errorCode);
+    void dropAffinity(std::string const& threadName, int errorCode);
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_THREADATTRIBUTES_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -13,6 +13,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <cmath>
+#include <stdexcept>
 
 #include <CoreKit/InterruptListener.h>
 #include <CoreKit/OsErrorException.h>
@@ -20,86 +22,119 @@
 
 #include "TimerInputSource.h"
 
+#define RF_TIS_NS_PER_SEC (1000000000.0)
+
 using CoreKit::TimerInputSource;
+using CoreKit::TimerStatistics;
+using CoreKit::TimerExpiration;
 using CoreKit::InterruptListener;
 using CoreKit::OsErrorException;
 
-TimerInputSource::TimerInputSource(double interval, bool repeats, InterruptListener *timerListener)
-: m_timerInterval(interval), m_repeats(repeats), m_timerFd(-1), m_timerListener(timerListener)
+/**
+ * \brief Convert a Duration in Seconds to Nanoseconds
+ */
+static int64_t secsToNs(double secs)
 {
-    struct itimerspec timerSpec;
+    return static_cast<int64_t>(std::llround(secs * RF_TIS_NS_PER_SEC));
+}
+
+
+/**
+ * \brief Convert a \c timespec to Nanoseconds
+ */
+static int64_t timespecToNs(struct timespec const& ts)
+{
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+
+/**
+ * \brief Convert Nanoseconds to a \c timespec
+ */
+static void nsToTimespec(int64_t ns, struct timespec& ts)
+{
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+}
+
 
+/**
+ * \brief Read the Current Time, in Nanoseconds, from a Specific Clock
+ */
+static int64_t nowNs(clockid_t clockId)
+{
+    struct timespec now;
+
+    clock_gettime(clockId, &now);
+
+    return timespecToNs(now);
+}
+
+TimerInputSource::TimerInputSource(double interval, bool repeats, InterruptListener *timerListener)
+: m_timerInterval(repeats ? interval : 0.0), m_repeats(repeats), m_timerFd(-1),
+  m_timerListener(timerListener), m_firstTimeout(interval), m_clockId(CLOCK_MONOTONIC), m_nextDeadlineNs(0)
+{
     if (nullptr == timerListener)
     {
         throw std::runtime_error("Invalid interrupt listener dependency injected.");
     }
 
-    memset(&timerSpec, 0x00, sizeof(timerSpec));
-    SystemTime::secsToTimespec(interval, timerSpec.it_value);
-    if (m_repeats)
-    {
-        SystemTime::secsToTimespec(interval, timerSpec.it_interval);
-    }
-    m_timerFd = timerfd_create(CLOCK_REALTIME,
-#if defined(HAVE_TFD_NONBLOCK) && (HAVE_TFD_NONBLOCK == 1)
-        TFD_NONBLOCK
-#else
-        0
-#endif /* defined(HAVE_TFD_NONBLOCK) && (HAVE_TFD_NONBLOCK == 1) */
-        );
-    if (-1 == m_timerFd)
-    {
-        throw OsErrorException("timerfd_create", errno);
-    }
-#if !defined(HAVE_TFD_NONBLOCK) || (HAVE_TFD_NONBLOCK == 0)
-    if (fcntl(m_timerFd, F_SETFL, O_NONBLOCK) == -1)
-    {
-        throw OsErrorException("timer fd fcntl", errno);
-    }
-#endif /* !defined(HAVE_TFD_NONBLOCK) || (HAVE_TFD_NONBLOCK == 0) */
-
-    if (timerfd_settime(m_timerFd, 0, &timerSpec, nullptr) == -1)
-    {
-        throw OsErrorException("timerfd_settime", errno);
-    }
+    this->createTimerFd();
+    this->program(nowNs(m_clockId) + secsToNs(m_firstTimeout));
 }
 
 
 TimerInputSource::TimerInputSource(double firstTimeout, double interval, InterruptListener *timerListener)
-: m_timerInterval(interval), m_repeats(true), m_timerFd(-1), m_timerListener(timerListener)
+: m_timerInterval(interval), m_repeats(true), m_timerFd(-1),
+  m_timerListener(timerListener), m_firstTimeout(firstTimeout), m_clockId(CLOCK_MONOTONIC), m_nextDeadlineNs(0)
 {
-    struct itimerspec timerSpec;
-    
     if (nullptr == timerListener)
     {
         throw std::runtime_error("Invalid interrupt listener dependency injected.");
     }
-    
-    memset(&timerSpec, 0x00, sizeof(timerSpec));
-    SystemTime::secsToTimespec(firstTimeout, timerSpec.it_value);
-    SystemTime::secsToTimespec(interval, timerSpec.it_interval);
-    m_timerFd = timerfd_create(CLOCK_REALTIME,
-#if defined(HAVE_TFD_NONBLOCK) && (HAVE_TFD_NONBLOCK == 1)
-        TFD_NONBLOCK
-#else
-        0
-#endif /* defined(HAVE_TFD_NONBLOCK) && (HAVE_TFD_NONBLOCK == 1) */
-    );
-    if (-1 == m_timerFd)
+
+    this->createTimerFd();
+    this->program(nowNs(m_clockId) + secsToNs(m_firstTimeout));
+}
+
+
+TimerInputSource::TimerInputSource(double firstTimeout, double interval, clockid_t clockId, InterruptListener *timerListener)
+: m_timerInterval(interval), m_repeats(interval > 0.0), m_timerFd(-1),
+  m_timerListener(timerListener), m_firstTimeout(firstTimeout), m_clockId(clockId), m_nextDeadlineNs(0)
+{
+    if (nullptr == timerListener)
     {
-        throw OsErrorException("TimerInputSource alternate constructor timerfd_create", errno);
+        throw std::runtime_error("Invalid interrupt listener dependency injected.");
     }
-#if !defined(HAVE_TFD_NONBLOCK) || (HAVE_TFD_NONBLOCK == 0)
-    if (fcntl(m_timerFd, F_SETFL, O_NONBLOCK) == -1)
+
+    this->createTimerFd();
+    this->program(nowNs(m_clockId) + secsToNs(m_firstTimeout));
+}
+
+
+TimerInputSource::TimerInputSource(struct timespec const& firstDeadline, double interval, clockid_t clockId, InterruptListener *timerListener)
+: m_timerInterval(interval), m_repeats(interval > 0.0), m_timerFd(-1),
+  m_timerListener(timerListener), m_firstTimeout(0.0), m_clockId(clockId), m_nextDeadlineNs(0)
+{
+    int64_t deadlineNs = timespecToNs(firstDeadline);
+
+    if (nullptr == timerListener)
     {
-        throw OsErrorException("TimerInputSource alternate constructor timer fd fcntl", errno);
+        throw std::runtime_error("Invalid interrupt listener dependency injected.");
     }
-#endif /* !defined(HAVE_TFD_NONBLOCK) || (HAVE_TFD_NONBLOCK == 0) */
 
-    if (timerfd_settime(m_timerFd, 0, &timerSpec, nullptr) == -1)
+    /*
+     * Remember the distance to the deadline so that rearm() has a sensible
+     * first timeout to work with.
+     */
+    m_firstTimeout = static_cast<double>(deadlineNs - nowNs(m_clockId)) / RF_TIS_NS_PER_SEC;
+    if (m_firstTimeout < 0.0)
     {
-        throw OsErrorException("TimerInputSource alternate constructor timerfd_settime", errno);
+        m_firstTimeout = 0.0;
     }
+
+    this->createTimerFd();
+    this->program(deadlineNs);
 }
 
 
@@ -131,18 +166,146 @@ void TimerInputSource::fireCallback()
 {
     ssize_t readResult = 0;
     uint64_t readVal = 0uLL;
+    int64_t intervalNs = secsToNs(m_timerInterval);
+    int64_t actualNs = 0;
+    TimerExpiration expiration;
 
+    memset(&expiration, 0x00, sizeof(expiration));
     do
     {
         /*
          * Upon timer expiration, the timerfd() facility transmits a 64-bit
-         * integer value via its associated file descriptor. See the manual
-         * page for timerfd_create() for more information.
+         * integer value via its associated file descriptor, which counts the
+         * number of expirations since the last read. See the manual page for
+         * timerfd_create() for more information.
          */
         readResult = read(m_timerFd, &readVal, sizeof(readVal));
+        if (sizeof(readVal) == readResult)
+        {
+            expiration.expirations += readVal;
+        }
     } while (sizeof(readVal) == readResult);
 
-    m_timerListener->timerExpired(m_timerFd);
+    if (0uLL == expiration.expirations)
+    {
+        return;
+    }
+
+    /*
+     * The timer was programmed with an absolute deadline, so the time at
+     * which the most recent period ended can be computed exactly. Lateness
+     * is measured against that period, and the next deadline moves forward
+     * by every period that elapsed.
+     */
+    actualNs = nowNs(m_clockId);
+    expiration.overruns = expiration.expirations - 1uLL;
+    nsToTimespec(m_nextDeadlineNs + static_cast<int64_t>(expiration.overruns) * intervalNs, expiration.scheduled);
+    nsToTimespec(actualNs, expiration.actual);
+    expiration.lateness = static_cast<double>(actualNs - timespecToNs(expiration.scheduled)) / RF_TIS_NS_PER_SEC;
+    m_nextDeadlineNs += static_cast<int64_t>(expiration.expirations) * intervalNs;
+    m_statistics.record(expiration);
+
+    m_timerListener->timerExpired(m_timerFd, expiration);
+}
+
+
+void TimerInputSource::rearm()
+{
+    this->program(nowNs(m_clockId) + secsToNs(m_firstTimeout));
+}
+
+
+void TimerInputSource::createTimerFd()
+{
+    m_timerFd = timerfd_create(m_clockId,
+#if defined(HAVE_TFD_NONBLOCK) && (HAVE_TFD_NONBLOCK == 1)
+        TFD_NONBLOCK
+#else
+        0
+#endif /* defined(HAVE_TFD_NONBLOCK) && (HAVE_TFD_NONBLOCK == 1) */
+        );
+    if (-1 == m_timerFd)
+    {
+        throw OsErrorException("timerfd_create", errno);
+    }
+#if !defined(HAVE_TFD_NONBLOCK) || (HAVE_TFD_NONBLOCK == 0)
+    if (fcntl(m_timerFd, F_SETFL, O_NONBLOCK) == -1)
+    {
+        throw OsErrorException("timer fd fcntl", errno);
+    }
+#endif /* !defined(HAVE_TFD_NONBLOCK) || (HAVE_TFD_NONBLOCK == 0) */
+}
+
+
+void TimerInputSource::program(int64_t firstDeadlineNs)
+{
+    struct itimerspec timerSpec;
+
+    memset(&timerSpec, 0x00, sizeof(timerSpec));
+    nsToTimespec(firstDeadlineNs, timerSpec.it_value);
+    if (m_repeats)
+    {
+        nsToTimespec(secsToNs(m_timerInterval), timerSpec.it_interval);
+    }
+
+    /*
+     * An all-zero it_value would disarm the timer, which is never what the
+     * caller asked for.
+     */
+    if ((0 == timerSpec.it_value.tv_sec) && (0 == timerSpec.it_value.tv_nsec))
+    {
+        timerSpec.it_value.tv_nsec = 1;
+    }
+
+    if (timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &timerSpec, nullptr) == -1)
+    {
+        throw OsErrorException("timerfd_settime", errno);
+    }
+    m_nextDeadlineNs = firstDeadlineNs;
+}
+
+
+TimerStatistics::TimerStatistics()
+{
+    this->reset();
+}
+
+
+void TimerStatistics::reset()
+{
+    callbacks = 0uLL;
+    overruns = 0uLL;
+    minLateness = 0.0;
+    maxLateness = 0.0;
+    meanLateness = 0.0;
+    latenessM2 = 0.0;
+}
+
+
+void TimerStatistics::record(TimerExpiration const& expiration)
+{
+    double delta = 0.0;
+
+    callbacks++;
+    overruns += expiration.overruns;
+    if ((1uLL == callbacks) || (expiration.lateness < minLateness))
+    {
+        minLateness = expiration.lateness;
+    }
+    if ((1uLL == callbacks) || (expiration.lateness > maxLateness))
+    {
+        maxLateness = expiration.lateness;
+    }
+
+    delta = expiration.lateness - meanLateness;
+    meanLateness += delta / static_cast<double>(callbacks);
+    latenessM2 += delta * (expiration.lateness - meanLateness);
+}
+
+
+double TimerStatistics::latenessStdDev() const
+{
+    return (callbacks > 0uLL) ? std::sqrt(latenessM2 / static_cast<double>(callbacks)) : 0.0;
 }
 
 // vim: set ts=4 sw=4 expandtab:
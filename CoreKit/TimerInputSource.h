@@ -7,10 +7,73 @@
 #if !defined(EA_99058D7E_4524_4463_A96C_BE7F41C39E86__INCLUDED_)
 #define EA_99058D7E_4524_4463_A96C_BE7F41C39E86__INCLUDED_
 
+#include <stdint.h>
+#include <time.h>
+
 #include "InputSource.h"
 
 namespace CoreKit
 {
+	struct TimerExpiration;
+
+	/**
+	 * \brief Running Lateness and Overrun Statistics for a Single Timer
+	 *
+	 * The \c TimerStatistics structure accumulates, for every callback
+	 * delivered by a \c TimerInputSource, the difference between the time
+	 * the timer was scheduled to expire and the time the expiration was
+	 * processed. The mean and standard deviation are maintained using
+	 * Welford's online algorithm, so no samples are stored.
+	 */
+	struct TimerStatistics
+	{
+		/**
+		 * \brief Number of Callbacks Delivered
+		 */
+		uint64_t callbacks;
+		/**
+		 * \brief Total Number of Timer Periods Missed Across All Callbacks
+		 */
+		uint64_t overruns;
+		/**
+		 * \brief Smallest Lateness Observed, in Seconds
+		 */
+		double minLateness;
+		/**
+		 * \brief Largest Lateness Observed, in Seconds
+		 */
+		double maxLateness;
+		/**
+		 * \brief Mean Lateness, in Seconds
+		 */
+		double meanLateness;
+		/**
+		 * \brief Sum of Squared Deviations from the Mean Lateness
+		 */
+		double latenessM2;
+
+		/**
+		 * \brief Initialize All Statistics to Zero
+		 */
+		TimerStatistics();
+		/**
+		 * \brief Discard All Accumulated Statistics
+		 */
+		void reset();
+		/**
+		 * \brief Account for One Timer Callback
+		 *
+		 * \param expiration Details of the callback being accounted for.
+		 */
+		void record(TimerExpiration const& expiration);
+		/**
+		 * \brief Compute the Standard Deviation of the Lateness (the Jitter)
+		 *
+		 * \return Population standard deviation of the lateness, in seconds.
+		 */
+		double latenessStdDev() const;
+	};
+
 	/**
 	 * \brief \c InputSource that Models One Shot and Recurring Timers
 	 * 
@@ -19,7 +82,16 @@ namespace CoreKit
 	 *
 	 * The \c TimerInputSource class utilizes the Linux \c timerfd() facility
 	 * to create a file descriptor that exhibits input activity whenever a
-	 * timer expires.
+	 * timer expires.\par
+	 *
+	 * Timers are always programmed using absolute deadlines, and recurring
+	 * timers expire at exact multiples of their period from the first
+	 * deadline, regardless of how late each callback is delivered. Unless
+	 * told otherwise, timers use \c CLOCK_MONOTONIC so that adjustments to
+	 * the wall clock do not disturb them. Each callback reports the number
+	 * of periods that elapsed and its lateness via
+	 * \c InterruptListener::timerExpired(int,TimerExpiration const&), and
+	 * the same information is accumulated in a \c TimerStatistics instance.
 	 *
 	 * \note
 	 * Although the \c TimerInputSource class may be used on its own to
@@ -65,6 +137,31 @@ namespace CoreKit
          *                      receiving events from this timer.
          */
         TimerInputSource(double firstTimeout, double interval, InterruptListener *timerListener);
+		/**
+		 * \brief Create a Timer on a Specific Clock
+		 *
+		 * \param firstTimeout Seconds to wait before the first expiration.
+		 * \param interval Period of the timer expressed in seconds; zero
+		 *                 for a one-shot timer.
+		 * \param clockId Clock the timer is based on, either
+		 *                \c CLOCK_MONOTONIC or \c CLOCK_REALTIME.
+		 * \param timerListener \c InterruptListener instance interested in
+		 *                      receiving events from this timer.
+		 */
+		TimerInputSource(double firstTimeout, double interval, clockid_t clockId, InterruptListener *timerListener);
+		/**
+		 * \brief Create a Timer that First Expires at an Absolute Deadline
+		 *
+		 * \param firstDeadline Time of the first expiration, expressed on
+		 *                      the clock identified by \c clockId.
+		 * \param interval Period of the timer expressed in seconds; zero
+		 *                 for a one-shot timer.
+		 * \param clockId Clock the timer is based on, either
+		 *                \c CLOCK_MONOTONIC or \c CLOCK_REALTIME.
+		 * \param timerListener \c InterruptListener instance interested in
+		 *                      receiving events from this timer.
+		 */
+		TimerInputSource(struct timespec const& firstDeadline, double interval, clockid_t clockId, InterruptListener *timerListener);
 		/**
 		 * \brief Close the \c timerfd() Facility Used to Receive Timer Events
 		 */
@@ -98,15 +195,53 @@ namespace CoreKit
 		 *
 		 * The \c fireCallback() method is part of the \c InputSource interface
 		 * and it calls the \c InterruptListener::timerExpired() method on
-		 * the \c InterruptListener instance registered with this input source.
+		 * the \c InterruptListener instance registered with this input source,
+		 * passing along the overrun count and lateness of the expiration.
 		 * \par
 		 *
 		 * This method is primarily used by the \c RunLoop class whenever it
 		 * schedules this input source to perform work.
 		 */
 		virtual void fireCallback();
+		/**
+		 * \brief Restart the Countdown of this Timer
+		 *
+		 * The \c rearm() method re-programs the \c timerfd() facility so the
+		 * timer next expires once its first timeout elapses, measured from
+		 * the time of the call. Recurring timers resume their period after
+		 * that.
+		 */
+		void rearm();
+		/**
+		 * \brief Access the Lateness Statistics Accumulated for this Timer
+		 *
+		 * \return Statistics for all callbacks delivered so far.
+		 */
+		inline TimerStatistics const& statistics() const { return m_statistics; }
+		/**
+		 * \brief Discard the Lateness Statistics Accumulated for this Timer
+		 */
+		inline void resetStatistics() { m_statistics.reset(); }
+		/**
+		 * \brief Obtain the Clock this Timer is Based On
+		 *
+		 * \return Clock identifier used to create this timer.
+		 */
+		inline clockid_t clockId() const { return m_clockId; }
 
 	private:
+		/**
+		 * \brief Create the \c timerfd() Facility on the Configured Clock
+		 */
+		void createTimerFd();
+		/**
+		 * \brief Program the \c timerfd() Facility with an Absolute First Deadline
+		 *
+		 * \param firstDeadlineNs First expiration, in nanoseconds on the
+		 *                        configured clock.
+		 */
+		void program(int64_t firstDeadlineNs);
+
 		/**
 		 * \brief File Descriptor Used to Receive Timer Events
 		 */
@@ -123,6 +258,22 @@ namespace CoreKit
 		 * \brief \c InterruptListener Derived Instance Interested in Timer Events from This Instance
 		 */
 		InterruptListener *m_timerListener;
+		/**
+		 * \brief Decimal Number that Describes the Time to the First Expiration
+		 */
+		double m_firstTimeout;
+		/**
+		 * \brief Clock on Which this Timer is Based
+		 */
+		clockid_t m_clockId;
+		/**
+		 * \brief Next Scheduled Expiration, in Nanoseconds on \c m_clockId
+		 */
+		int64_t m_nextDeadlineNs;
+		/**
+		 * \brief Lateness Statistics for this Timer
+		 */
+		TimerStatistics m_statistics;
 	};
 
 }
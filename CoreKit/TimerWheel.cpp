@@ -0,0 +1,717 @@
+/**
+ * \file TimerWheel.cpp
+ * \brief Contains the implementation of the \c TimerWheel class.
+ * \date 2026-10-16 09:12:40
+ * \author Rolando J. Nieves
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <CoreKit/InterruptListener.h>
+#include <CoreKit/OsErrorException.h>
+
+#include "TimerWheel.h"
+
+#define RF_CK_TW_ID_MARKER (0x40000000)
+#define RF_CK_TW_INDEX_BITS (19u)
+#define RF_CK_TW_INDEX_MASK ((1u << RF_CK_TW_INDEX_BITS) - 1u)
+#define RF_CK_TW_GEN_MASK (0x7FFu)
+#define RF_CK_TW_SLOT_MASK (CoreKit::TimerWheel::NumSlots - 1u)
+#define RF_CK_TW_NO_DEADLINE (UINT64_MAX)
+#define RF_CK_TW_NS_PER_SEC (1000000000uLL)
+
+
+/**
+ * \brief Convert Nanoseconds to a \c timespec
+ */
+static void nsToTimespec(uint64_t ns, struct timespec& ts)
+{
+    ts.tv_sec = static_cast<time_t>(ns / RF_CK_TW_NS_PER_SEC);
+    ts.tv_nsec = static_cast<long>(ns % RF_CK_TW_NS_PER_SEC);
+}
+
+
+namespace CoreKit
+{
+
+const uint32_t TimerWheel::NumSlots;
+
+
+TimerWheel::TimerWheel(double tickInterval):
+    InputSource(),
+    m_timerFd(-1),
+    m_tickNs(0u),
+    m_originNs(0u),
+    m_lastProcessedTick(0u),
+    m_programmedTick(RF_CK_TW_NO_DEADLINE),
+    m_dispatching(false),
+    m_activeCount(0u),
+    m_wakeups(0u),
+    m_wakeupsSaved(0u),
+    m_freeHead(-1)
+{
+    if (!(tickInterval > 0.0))
+    {
+        throw std::invalid_argument("Timer wheel tick interval must be positive.");
+    }
+    m_tickNs = static_cast<uint64_t>(std::llround(tickInterval * RF_CK_TW_NS_PER_SEC));
+    if (0u == m_tickNs)
+    {
+        m_tickNs = 1u;
+    }
+
+    for (uint32_t slotIdx = 0u; slotIdx < NumSlots; ++slotIdx)
+    {
+        m_slots[slotIdx].head = -1;
+        m_slots[slotIdx].minExpiryTick = RF_CK_TW_NO_DEADLINE;
+        m_slots[slotIdx].minDeadlineTick = RF_CK_TW_NO_DEADLINE;
+    }
+    memset(&m_slotBitmap[0], 0x00, sizeof(m_slotBitmap));
+
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (-1 == m_timerFd)
+    {
+        throw OsErrorException("timerfd_create", errno);
+    }
+
+    /*
+     * All tick arithmetic is relative to the moment the wheel was created,
+     * which keeps the tick counter small and the slot hashing stable.
+     */
+    m_originNs = this->currentNs();
+}
+
+
+TimerWheel::~TimerWheel()
+{
+    if (m_timerFd != -1)
+    {
+        close(m_timerFd);
+        m_timerFd = -1;
+    }
+}
+
+
+int
+TimerWheel::fileDescriptor() const
+{
+    return m_timerFd;
+}
+
+
+InterruptListener*
+TimerWheel::interruptListener() const
+{
+    return nullptr;
+}
+
+
+void
+TimerWheel::fireCallback()
+{
+    uint64_t expirations = 0u;
+    uint64_t nowTick = 0u;
+    uint64_t tick = 0u;
+    uint64_t nowNs = 0u;
+    uint64_t deadlineTick = m_programmedTick;
+    TimerExpiration expiration;
+
+    /*
+     * Drain the expiration count. The timerfd() is always armed as a one
+     * shot, so once it fires nothing is programmed anymore.
+     */
+    while (read(m_timerFd, &expirations, sizeof(expirations)) == sizeof(expirations));
+    m_programmedTick = RF_CK_TW_NO_DEADLINE;
+    m_wakeups++;
+
+    /*
+     * Visit every slot that the wheel went past since the last visit. If a
+     * full revolution (or more) went by, every slot has to be visited once.
+     */
+    nowNs = this->currentNs();
+    nowTick = (nowNs - m_originNs) / m_tickNs;
+    m_expired.clear();
+    if ((nowTick - m_lastProcessedTick) >= NumSlots)
+    {
+        for (uint32_t slotIdx = 0u; slotIdx < NumSlots; ++slotIdx)
+        {
+            this->collectExpired(slotIdx, nowTick);
+        }
+    }
+    else
+    {
+        for (tick = m_lastProcessedTick + 1u; tick <= nowTick; ++tick)
+        {
+            this->collectExpired(static_cast<uint32_t>(tick & RF_CK_TW_SLOT_MASK), nowTick);
+        }
+    }
+    m_lastProcessedTick = nowTick;
+    this->countSavedWakeups(deadlineTick);
+
+    /*
+     * Fire the expired timers. Recurring timers are linked back into the
+     * wheel before their callback runs, so a listener may safely cancel or
+     * re-arm its own timer (or any other) from within the callback. Entries
+     * whose generation changed while waiting in the expired list were
+     * cancelled by an earlier callback and are skipped.
+     */
+    memset(&expiration, 0x00, sizeof(expiration));
+    nsToTimespec(nowNs, expiration.actual);
+    m_dispatching = true;
+    for (size_t expIdx = 0u; expIdx < m_expired.size(); ++expIdx)
+    {
+        int32_t entryIdx = m_expired[expIdx] & static_cast<int32_t>(RF_CK_TW_INDEX_MASK);
+        uint32_t generation = static_cast<uint32_t>(m_expired[expIdx]) >> RF_CK_TW_INDEX_BITS;
+        Entry *theEntry = &m_entries[entryIdx];
+        InterruptListener *theListener = theEntry->listener;
+        int timerId = this->makeTimerId(entryIdx);
+        uint64_t scheduledNs = 0u;
+
+        if ((theEntry->state != ES_EXPIRED) || ((theEntry->generation & RF_CK_TW_GEN_MASK) != generation))
+        {
+            continue;
+        }
+
+        expiration.overruns = 0u;
+        if (theEntry->periodTicks > 0u)
+        {
+            /*
+             * Stay on the original schedule, skipping any periods that were
+             * missed entirely.
+             */
+            expiration.overruns = (nowTick - theEntry->expiryTick) / theEntry->periodTicks;
+            theEntry->expiryTick += expiration.overruns * theEntry->periodTicks;
+            scheduledNs = m_originNs + theEntry->expiryTick * m_tickNs;
+            theEntry->expiryTick += theEntry->periodTicks;
+            this->link(entryIdx);
+        }
+        else
+        {
+            /*
+             * One-shot timers keep their identifier until they are
+             * cancelled, so they may be re-armed after they expire.
+             */
+            scheduledNs = m_originNs + theEntry->expiryTick * m_tickNs;
+            theEntry->state = ES_IDLE;
+        }
+
+        expiration.expirations = expiration.overruns + 1u;
+        nsToTimespec(scheduledNs, expiration.scheduled);
+        expiration.lateness = (static_cast<double>(nowNs) - static_cast<double>(scheduledNs)) / RF_CK_TW_NS_PER_SEC;
+
+        theListener->timerExpired(timerId, expiration);
+    }
+    m_dispatching = false;
+    m_expired.clear();
+
+    this->programEarliest();
+}
+
+
+int
+TimerWheel::arm(double firstTimeout, double interval, InterruptListener *listener, double slack)
+{
+    int32_t entryIdx = -1;
+    Entry *theEntry = nullptr;
+
+    if (nullptr == listener)
+    {
+        throw std::runtime_error("Invalid interrupt listener dependency injected.");
+    }
+
+    entryIdx = this->allocateEntry();
+    theEntry = &m_entries[entryIdx];
+    theEntry->listener = listener;
+    theEntry->firstNs = (firstTimeout > 0.0) ? static_cast<uint64_t>(firstTimeout * RF_CK_TW_NS_PER_SEC) : 0u;
+    theEntry->periodTicks = (interval > 0.0) ? this->secsToTicks(interval) : 0u;
+    theEntry->slackTicks = this->slackToTicks(slack, theEntry->periodTicks);
+    theEntry->expiryTick = this->expiryTickAfter(theEntry->firstNs);
+    this->link(entryIdx);
+    ++m_activeCount;
+
+    if (!m_dispatching && ((theEntry->expiryTick + theEntry->slackTicks) < m_programmedTick))
+    {
+        this->program(theEntry->expiryTick + theEntry->slackTicks);
+    }
+
+    return this->makeTimerId(entryIdx);
+}
+
+
+bool
+TimerWheel::setSlack(int timerId, double slack)
+{
+    int32_t entryIdx = this->entryIndexFor(timerId);
+    Entry *theEntry = nullptr;
+
+    if (-1 == entryIdx)
+    {
+        return false;
+    }
+
+    /*
+     * Re-linking refreshes the slot's bounds with the new deadline.
+     */
+    theEntry = &m_entries[entryIdx];
+    theEntry->slackTicks = this->slackToTicks(slack, theEntry->periodTicks);
+    if (ES_LINKED == theEntry->state)
+    {
+        this->unlink(entryIdx);
+        this->link(entryIdx);
+        if (!m_dispatching && ((theEntry->expiryTick + theEntry->slackTicks) < m_programmedTick))
+        {
+            this->program(theEntry->expiryTick + theEntry->slackTicks);
+        }
+    }
+
+    return true;
+}
+
+
+bool
+TimerWheel::rearm(int timerId)
+{
+    int32_t entryIdx = this->entryIndexFor(timerId);
+    Entry *theEntry = nullptr;
+
+    if (-1 == entryIdx)
+    {
+        return false;
+    }
+
+    theEntry = &m_entries[entryIdx];
+    if (ES_LINKED == theEntry->state)
+    {
+        this->unlink(entryIdx);
+    }
+    theEntry->expiryTick = this->expiryTickAfter(theEntry->firstNs);
+    this->link(entryIdx);
+
+    if (!m_dispatching && ((theEntry->expiryTick + theEntry->slackTicks) < m_programmedTick))
+    {
+        this->program(theEntry->expiryTick + theEntry->slackTicks);
+    }
+
+    return true;
+}
+
+
+bool
+TimerWheel::cancel(int timerId)
+{
+    int32_t entryIdx = this->entryIndexFor(timerId);
+
+    if (-1 == entryIdx)
+    {
+        return false;
+    }
+
+    if (ES_LINKED == m_entries[entryIdx].state)
+    {
+        this->unlink(entryIdx);
+    }
+    this->releaseEntry(entryIdx);
+
+    /*
+     * The timerfd() is intentionally left alone. At worst it produces one
+     * wake up with nothing to expire, after which it is re-programmed.
+     */
+    return true;
+}
+
+
+bool
+TimerWheel::ownsTimerId(int timerId) const
+{
+    return (this->entryIndexFor(timerId) != -1);
+}
+
+
+bool
+TimerWheel::isWheelTimerId(int timerId)
+{
+    return ((timerId > 0) && ((timerId & RF_CK_TW_ID_MARKER) != 0));
+}
+
+
+double
+TimerWheel::tickInterval() const
+{
+    return static_cast<double>(m_tickNs) / RF_CK_TW_NS_PER_SEC;
+}
+
+
+uint64_t
+TimerWheel::currentNs() const
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<uint64_t>(now.tv_sec) * RF_CK_TW_NS_PER_SEC + now.tv_nsec;
+}
+
+
+uint64_t
+TimerWheel::expiryTickAfter(uint64_t delayNs) const
+{
+    uint64_t elapsedNs = this->currentNs() - m_originNs;
+    uint64_t result = (elapsedNs + delayNs + m_tickNs - 1u) / m_tickNs;
+
+    /*
+     * The deadline is rounded up from the current time itself, not from the
+     * start of the tick in progress, so a timer armed late in a tick never
+     * expires early. Nor is a timer ever scheduled for the tick in progress.
+     */
+    return std::max(result, (elapsedNs / m_tickNs) + 1u);
+}
+
+
+uint64_t
+TimerWheel::secsToTicks(double seconds) const
+{
+    uint64_t result = 0u;
+
+    /*
+     * Round up, so a period is never shorter than requested, and never make
+     * it shorter than a tick.
+     */
+    if (seconds > 0.0)
+    {
+        result = static_cast<uint64_t>(std::ceil((seconds * RF_CK_TW_NS_PER_SEC) / m_tickNs));
+    }
+
+    return (result > 0u) ? result : 1u;
+}
+
+
+uint64_t
+TimerWheel::slackToTicks(double seconds, uint64_t periodTicks) const
+{
+    uint64_t result = 0u;
+
+    /*
+     * Round down, so a timer never fires later than its slack allows, and
+     * keep a periodic timer's slack under its period, so that it is never
+     * delayed into its next expiration.
+     */
+    if (seconds > 0.0)
+    {
+        result = static_cast<uint64_t>(std::floor((seconds * RF_CK_TW_NS_PER_SEC) / m_tickNs));
+    }
+    if ((periodTicks > 0u) && (result >= periodTicks))
+    {
+        result = periodTicks - 1u;
+    }
+
+    return result;
+}
+
+
+
+int32_t
+TimerWheel::entryIndexFor(int timerId) const
+{
+    uint32_t entryIdx = 0u;
+    uint32_t generation = 0u;
+
+    if (!isWheelTimerId(timerId))
+    {
+        return -1;
+    }
+
+    entryIdx = static_cast<uint32_t>(timerId) & RF_CK_TW_INDEX_MASK;
+    generation = (static_cast<uint32_t>(timerId) >> RF_CK_TW_INDEX_BITS) & RF_CK_TW_GEN_MASK;
+    if ((entryIdx >= m_entries.size()) ||
+        (ES_FREE == m_entries[entryIdx].state) ||
+        ((m_entries[entryIdx].generation & RF_CK_TW_GEN_MASK) != generation))
+    {
+        return -1;
+    }
+
+    return static_cast<int32_t>(entryIdx);
+}
+
+
+int
+TimerWheel::makeTimerId(int32_t entryIndex) const
+{
+    return RF_CK_TW_ID_MARKER |
+        static_cast<int>((m_entries[entryIndex].generation & RF_CK_TW_GEN_MASK) << RF_CK_TW_INDEX_BITS) |
+        entryIndex;
+}
+
+
+int32_t
+TimerWheel::allocateEntry()
+{
+    int32_t entryIdx = m_freeHead;
+
+    if (-1 == entryIdx)
+    {
+        Entry newEntry;
+
+        if (m_entries.size() > RF_CK_TW_INDEX_MASK)
+        {
+            throw std::length_error("Timer wheel capacity exhausted.");
+        }
+        memset(&newEntry, 0x00, sizeof(newEntry));
+        newEntry.prev = -1;
+        newEntry.next = -1;
+        newEntry.state = ES_FREE;
+        m_entries.push_back(newEntry);
+        entryIdx = static_cast<int32_t>(m_entries.size() - 1u);
+    }
+    else
+    {
+        m_freeHead = m_entries[entryIdx].next;
+    }
+
+    m_entries[entryIdx].prev = -1;
+    m_entries[entryIdx].next = -1;
+
+    return entryIdx;
+}
+
+
+void
+TimerWheel::releaseEntry(int32_t entryIndex)
+{
+    Entry& theEntry = m_entries[entryIndex];
+
+    /*
+     * Bumping the generation invalidates every identifier handed out for
+     * this entry, as well as any reference to it in the expired list.
+     */
+    theEntry.generation++;
+    theEntry.state = ES_FREE;
+    theEntry.listener = nullptr;
+    theEntry.prev = -1;
+    theEntry.next = m_freeHead;
+    m_freeHead = entryIndex;
+    --m_activeCount;
+}
+
+
+void
+TimerWheel::link(int32_t entryIndex)
+{
+    Entry& theEntry = m_entries[entryIndex];
+    uint32_t slotIdx = static_cast<uint32_t>(theEntry.expiryTick & RF_CK_TW_SLOT_MASK);
+    Slot& theSlot = m_slots[slotIdx];
+
+    theEntry.prev = -1;
+    theEntry.next = theSlot.head;
+    if (theSlot.head != -1)
+    {
+        m_entries[theSlot.head].prev = entryIndex;
+    }
+    theSlot.head = entryIndex;
+    if (theEntry.expiryTick < theSlot.minExpiryTick)
+    {
+        theSlot.minExpiryTick = theEntry.expiryTick;
+    }
+    if ((theEntry.expiryTick + theEntry.slackTicks) < theSlot.minDeadlineTick)
+    {
+        theSlot.minDeadlineTick = theEntry.expiryTick + theEntry.slackTicks;
+    }
+    m_slotBitmap[slotIdx / 64u] |= (1uLL << (slotIdx % 64u));
+    theEntry.state = ES_LINKED;
+}
+
+
+void
+TimerWheel::unlink(int32_t entryIndex)
+{
+    Entry& theEntry = m_entries[entryIndex];
+    uint32_t slotIdx = static_cast<uint32_t>(theEntry.expiryTick & RF_CK_TW_SLOT_MASK);
+    Slot& theSlot = m_slots[slotIdx];
+
+    if (theEntry.prev != -1)
+    {
+        m_entries[theEntry.prev].next = theEntry.next;
+    }
+    else
+    {
+        theSlot.head = theEntry.next;
+    }
+    if (theEntry.next != -1)
+    {
+        m_entries[theEntry.next].prev = theEntry.prev;
+    }
+
+    /*
+     * The slot's minimum expiration and deadline are only lower bounds, so
+     * they are left as is unless the slot became empty.
+     */
+    if (-1 == theSlot.head)
+    {
+        theSlot.minExpiryTick = RF_CK_TW_NO_DEADLINE;
+        theSlot.minDeadlineTick = RF_CK_TW_NO_DEADLINE;
+        m_slotBitmap[slotIdx / 64u] &= ~(1uLL << (slotIdx % 64u));
+    }
+    theEntry.prev = -1;
+    theEntry.next = -1;
+}
+
+
+void
+TimerWheel::collectExpired(uint32_t slotIndex, uint64_t nowTick)
+{
+    Slot& theSlot = m_slots[slotIndex];
+    int32_t entryIdx = theSlot.head;
+    uint64_t newMin = RF_CK_TW_NO_DEADLINE;
+    uint64_t newMinDeadline = RF_CK_TW_NO_DEADLINE;
+
+    if ((-1 == entryIdx) || ((theSlot.minExpiryTick > nowTick) && (theSlot.minDeadlineTick > nowTick)))
+    {
+        return;
+    }
+
+    while (entryIdx != -1)
+    {
+        Entry& theEntry = m_entries[entryIdx];
+        int32_t nextIdx = theEntry.next;
+
+        if (theEntry.expiryTick <= nowTick)
+        {
+            this->unlink(entryIdx);
+            theEntry.state = ES_EXPIRED;
+            m_expired.push_back(
+                static_cast<int32_t>(((theEntry.generation & RF_CK_TW_GEN_MASK) << RF_CK_TW_INDEX_BITS) | entryIdx)
+            );
+            m_expiredTicks.push_back(theEntry.expiryTick);
+        }
+        else
+        {
+            newMin = std::min(newMin, theEntry.expiryTick);
+            newMinDeadline = std::min(newMinDeadline, theEntry.expiryTick + theEntry.slackTicks);
+        }
+        entryIdx = nextIdx;
+    }
+
+    theSlot.minExpiryTick = newMin;
+    theSlot.minDeadlineTick = newMinDeadline;
+}
+
+
+void
+TimerWheel::refreshSlot(uint32_t slotIndex)
+{
+    Slot& theSlot = m_slots[slotIndex];
+
+    theSlot.minExpiryTick = RF_CK_TW_NO_DEADLINE;
+    theSlot.minDeadlineTick = RF_CK_TW_NO_DEADLINE;
+    for (int32_t entryIdx = theSlot.head; entryIdx != -1; entryIdx = m_entries[entryIdx].next)
+    {
+        Entry const& theEntry = m_entries[entryIdx];
+
+        theSlot.minExpiryTick = std::min(theSlot.minExpiryTick, theEntry.expiryTick);
+        theSlot.minDeadlineTick = std::min(theSlot.minDeadlineTick, theEntry.expiryTick + theEntry.slackTicks);
+    }
+}
+
+
+void
+TimerWheel::countSavedWakeups(uint64_t deadlineTick)
+{
+    size_t distinctTicks = 0u;
+
+    /*
+     * Timers due past the programmed tick fired late because the loop was
+     * busy, not thanks to their slack, so they do not count.
+     */
+    if ((RF_CK_TW_NO_DEADLINE == deadlineTick) || (m_expiredTicks.size() < 2u))
+    {
+        m_expiredTicks.clear();
+        return;
+    }
+
+    std::sort(m_expiredTicks.begin(), m_expiredTicks.end());
+    for (size_t tickIdx = 0u; (tickIdx < m_expiredTicks.size()) && (m_expiredTicks[tickIdx] <= deadlineTick); ++tickIdx)
+    {
+        if ((0u == tickIdx) || (m_expiredTicks[tickIdx] != m_expiredTicks[tickIdx - 1u]))
+        {
+            ++distinctTicks;
+        }
+    }
+    if (distinctTicks > 1u)
+    {
+        m_wakeupsSaved += (distinctTicks - 1u);
+    }
+    m_expiredTicks.clear();
+}
+
+
+void
+TimerWheel::program(uint64_t deadlineTick)
+{
+    struct itimerspec timerSpec;
+    uint64_t deadlineNs = 0u;
+
+    memset(&timerSpec, 0x00, sizeof(timerSpec));
+    if (deadlineTick != RF_CK_TW_NO_DEADLINE)
+    {
+        deadlineNs = m_originNs + deadlineTick * m_tickNs;
+        nsToTimespec(deadlineNs, timerSpec.it_value);
+
+    }
+
+    if (timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &timerSpec, nullptr) == -1)
+    {
+        throw OsErrorException("timerfd_settime", errno);
+    }
+    m_programmedTick = deadlineTick;
+}
+
+
+void
+TimerWheel::programEarliest()
+{
+    uint64_t earliest = RF_CK_TW_NO_DEADLINE;
+
+    /*
+     * Only the slots flagged in the bitmap hold timers. Their minimum
+     * deadlines are lower bounds, which at worst cause a wake up that
+     * expires nothing. Every live timer is due after the last processed
+     * tick, so a bound at or before it is stale and is refreshed here;
+     * otherwise a slot visited before its bound went stale would keep the
+     * timerfd() firing.
+     */
+    for (uint32_t wordIdx = 0u; wordIdx < (NumSlots / 64u); ++wordIdx)
+    {
+        uint64_t word = m_slotBitmap[wordIdx];
+
+        while (word != 0u)
+        {
+            uint32_t slotIdx = wordIdx * 64u + static_cast<uint32_t>(__builtin_ctzll(word));
+
+            if (m_slots[slotIdx].minDeadlineTick <= m_lastProcessedTick)
+            {
+                this->refreshSlot(slotIdx);
+            }
+            if (m_slots[slotIdx].minDeadlineTick < earliest)
+            {
+                earliest = m_slots[slotIdx].minDeadlineTick;
+            }
+
+            word &= (word - 1u);
+        }
+    }
+
+    if (earliest != m_programmedTick)
+    {
+        this->program(earliest);
+    }
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
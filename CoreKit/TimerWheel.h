@@ -0,0 +1,254 @@
+/**
+ * \file TimerWheel.h
+ * \brief Contains the definition of the \c TimerWheel class.
+ * \date 2026-10-16 09:12:40
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_TIMERWHEEL_H_
+#define _FOUNDATION_COREKIT_TIMERWHEEL_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include <CoreKit/InputSource.h>
+
+namespace CoreKit
+{
+
+class InterruptListener;
+
+/**
+ * \brief Hashed timer wheel that multiplexes many timers over one \c timerfd()
+ *
+ * Every timer registered with the wheel is quantized to a configurable tick
+ * and stored in one of a fixed number of slots, selected by hashing its
+ * absolute expiration tick. Arming, cancelling and re-arming a timer are
+ * constant time operations that never involve the operating system, save
+ * for the occasional re-programming of the single \c timerfd() whenever a
+ * new timer expires before all others.\par
+ *
+ * A timer may declare a slack: how much later than its expiration it may
+ * fire. The \c timerfd() is programmed for the earliest time by which some
+ * timer \e must fire, and every timer due by then fires in that one wake
+ * up, much like the kernel's \c timerslack. \c wakeupsSaved() tells how
+ * many wake ups this spared.\par
+ *
+ * Timer identifiers produced by this class always have bit 30 set, which
+ * keeps them positive and out of the range of file descriptor numbers used
+ * as identifiers by \c TimerInputSource.
+ *
+ * \note Instances are normally created and owned by \c CoreKit::RunLoop.
+ *       See \c RunLoop::Configuration::timerWheelTick.
+ */
+class TimerWheel : public InputSource
+{
+public:
+    /**
+     * \brief Number of slots in the wheel; must be a power of two.
+     */
+    static const uint32_t NumSlots = 256u;
+
+    /**
+     * \brief Main constructor.
+     *
+     * Create the \c timerfd() facility that drives the wheel.
+     *
+     * \param[in] tickInterval - Resolution of the wheel, in seconds.
+     */
+    explicit TimerWheel(double tickInterval);
+
+    /**
+     * \brief Destructor.
+     */
+    virtual ~TimerWheel();
+
+    /**
+     * \brief Access the underlying \c timerfd() file descriptor.
+     *
+     * \return File descriptor associated with this input source.
+     */
+    virtual int fileDescriptor() const override;
+
+    /**
+     * \brief Timers carry their own listeners, so the wheel has none.
+     *
+     * \return Always \c nullptr.
+     */
+    virtual InterruptListener* interruptListener() const override;
+
+    /**
+     * \brief Expire all timers that are due and re-program the \c timerfd().
+     */
+    virtual void fireCallback() override;
+
+    /**
+     * \brief Arm a new timer.
+     *
+     * \param[in] firstTimeout - Seconds until the first expiration.
+     * \param[in] interval - Seconds between subsequent expirations; zero
+     *            for one-shot timers.
+     * \param[in] listener - Object that receives the
+     *            \c InterruptListener::timerExpired() callback.
+     * \param[in] slack - Seconds the timer may fire late so its expiration
+     *            can share a wake up with other timers; rounded down to
+     *            whole ticks, and kept under the interval.
+     *
+     * \return Identifier for the new timer.
+     */
+    int arm(double firstTimeout, double interval, InterruptListener *listener, double slack = 0.0);
+
+    /**
+     * \brief Change the slack of an existing timer.
+     *
+     * Takes effect from the timer's next expiration.
+     *
+     * \param[in] timerId - Identifier produced by \c arm().
+     * \param[in] slack - Seconds the timer may fire late.
+     *
+     * \return \c true if the timer was found; \c false otherwise.
+     */
+    bool setSlack(int timerId, double slack);
+
+    /**
+     * \brief Restart the countdown of an existing timer.
+     *
+     * The timer next expires after its original first timeout elapses,
+     * measured from the time of this call.
+     *
+     * \param[in] timerId - Identifier produced by \c arm().
+     *
+     * \return \c true if the timer was found; \c false otherwise.
+     */
+    bool rearm(int timerId);
+
+    /**
+     * \brief Cancel a timer and release its identifier.
+     *
+     * One-shot timers keep their identifier after they expire, so that
+     * they may be re-armed, until they are cancelled.
+     *
+     * \param[in] timerId - Identifier produced by \c arm().
+     *
+     * \return \c true if the timer was found; \c false otherwise.
+     */
+    bool cancel(int timerId);
+
+    /**
+     * \brief Check whether an identifier belongs to a live timer in this wheel.
+     *
+     * \param[in] timerId - Timer identifier to check.
+     *
+     * \return \c true if \c timerId names a timer in this wheel.
+     */
+    bool ownsTimerId(int timerId) const;
+
+    /**
+     * \brief Check whether an identifier has the form produced by \c arm().
+     *
+     * \param[in] timerId - Timer identifier to check.
+     *
+     * \return \c true if \c timerId could have come from a \c TimerWheel.
+     */
+    static bool isWheelTimerId(int timerId);
+
+    /**
+     * \brief Access the resolution of the wheel.
+     *
+     * \return Tick interval, in seconds.
+     */
+    double tickInterval() const;
+
+    /**
+     * \brief Count the timers currently held by the wheel.
+     *
+     * \return Number of timers that have not been cancelled.
+     */
+    inline size_t activeTimerCount() const { return m_activeCount; }
+
+    /**
+     * \brief Count the times the \c timerfd() woke up the wheel.
+     *
+     * \return Number of wake ups.
+     */
+    inline uint64_t wakeups() const { return m_wakeups; }
+
+    /**
+     * \brief Count the wake ups avoided by firing timers within their slack.
+     *
+     * Every wake up that fired timers due at \e n different ticks, all of
+     * them before the tick the \c timerfd() was programmed for, saved
+     * \e n - 1 wake ups.
+     *
+     * \return Number of wake ups saved.
+     */
+    inline uint64_t wakeupsSaved() const { return m_wakeupsSaved; }
+
+private:
+    enum EntryState
+    {
+        ES_FREE = 0,
+        ES_LINKED,
+        ES_EXPIRED,
+        ES_IDLE
+    };
+
+    struct Entry
+    {
+        uint64_t expiryTick;
+        uint64_t firstNs;
+        uint64_t periodTicks;
+        uint64_t slackTicks;
+        InterruptListener *listener;
+        int32_t prev;
+        int32_t next;
+        uint32_t generation;
+        EntryState state;
+    };
+
+    struct Slot
+    {
+        int32_t head;
+        uint64_t minExpiryTick;
+        uint64_t minDeadlineTick;
+    };
+
+    int m_timerFd;
+    uint64_t m_tickNs;
+    uint64_t m_originNs;
+    uint64_t m_lastProcessedTick;
+    uint64_t m_programmedTick;
+    bool m_dispatching;
+    size_t m_activeCount;
+    uint64_t m_wakeups;
+    uint64_t m_wakeupsSaved;
+    int32_t m_freeHead;
+    std::vector<Entry> m_entries;
+    Slot m_slots[NumSlots];
+    uint64_t m_slotBitmap[NumSlots / 64u];
+    std::vector<int32_t> m_expired;
+    std::vector<uint64_t> m_expiredTicks;
+
+    uint64_t currentNs() const;
+    uint64_t expiryTickAfter(uint64_t delayNs) const;
+    uint64_t secsToTicks(double seconds) const;
+    uint64_t slackToTicks(double seconds, uint64_t periodTicks) const;
+    int32_t entryIndexFor(int timerId) const;
+    int makeTimerId(int32_t entryIndex) const;
+    int32_t allocateEntry();
+    void releaseEntry(int32_t entryIndex);
+    void link(int32_t entryIndex);
+    void unlink(int32_t entryIndex);
+    void collectExpired(uint32_t slotIndex, uint64_t nowTick);
+    void refreshSlot(uint32_t slotIndex);
+    void countSavedWakeups(uint64_t deadlineTick);
+
+    void program(uint64_t deadlineTick);
+    void programEarliest();
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_TIMERWHEEL_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,517 @@
+/**
+ * \file WatchdogService.cpp
+ * \brief Contains the implementation of the \c WatchdogService class.
+ * \date 2026-10-16 19:02:15
+ * \author Rolando J. Nieves
+ */
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <CoreKit/OsErrorException.h>
+
+#include "WatchdogService.h"
+
+#define RF_CK_WDS_ID_MARKER (0x40000000)
+#define RF_CK_WDS_INDEX_BITS (19u)
+#define RF_CK_WDS_INDEX_MASK ((1u << RF_CK_WDS_INDEX_BITS) - 1u)
+#define RF_CK_WDS_GEN_MASK (0x7FFu)
+#define RF_CK_WDS_NO_DEADLINE (UINT64_MAX)
+#define RF_CK_WDS_NS_PER_SEC (1000000000uLL)
+
+
+/**
+ * \brief Convert Seconds to Nanoseconds, Treating Negative Values as Zero
+ */
+static uint64_t secsToNs(double seconds)
+{
+    return (seconds > 0.0) ? static_cast<uint64_t>(std::llround(seconds * RF_CK_WDS_NS_PER_SEC)) : 0u;
+}
+
+
+namespace CoreKit
+{
+
+WatchdogService::WatchdogService():
+    InputSource(),
+    m_timerFd(-1),
+    m_programmedNs(RF_CK_WDS_NO_DEADLINE),
+    m_dispatching(false),
+    m_activeCount(0u),
+    m_wakeups(0u),
+    m_expirations(0u),
+    m_freeHead(-1)
+{
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (-1 == m_timerFd)
+    {
+        throw OsErrorException("timerfd_create", errno);
+    }
+}
+
+
+WatchdogService::~WatchdogService()
+{
+    if (m_timerFd != -1)
+    {
+        close(m_timerFd);
+        m_timerFd = -1;
+    }
+}
+
+
+int
+WatchdogService::fileDescriptor() const
+{
+    return m_timerFd;
+}
+
+
+InterruptListener*
+WatchdogService::interruptListener() const
+{
+    return nullptr;
+}
+
+
+void
+WatchdogService::fireCallback()
+{
+    uint64_t expirationCount = 0u;
+    uint64_t nowNs = 0u;
+    size_t reportedCount = 0u;
+    std::vector< int > expired;
+
+    while (read(m_timerFd, &expirationCount, sizeof(expirationCount)) == sizeof(expirationCount));
+    m_programmedNs = RF_CK_WDS_NO_DEADLINE;
+    m_wakeups++;
+
+    /*
+     * Every queue is sorted by deadline, so only its head needs looking at
+     * until one is found that is not due yet.
+     */
+    nowNs = WatchdogService::currentNs();
+    for (Queue const& aQueue : m_queues)
+    {
+        while ((aQueue.head != -1) && (m_entries[aQueue.head].deadlineNs <= nowNs))
+        {
+            int32_t entryIdx = aQueue.head;
+
+            this->unlink(entryIdx);
+            m_entries[entryIdx].expiring = true;
+            m_expired.push_back(this->makeWatchdogId(entryIdx));
+        }
+    }
+
+    if (m_expired.empty())
+    {
+        this->programEarliest();
+        return;
+    }
+
+    std::sort(m_expired.begin(), m_expired.end(),
+        [this](int lhs, int rhs) {
+            return (m_entries[this->entryIndexFor(lhs)].deadlineNs < m_entries[this->entryIndexFor(rhs)].deadlineNs);
+        }
+    );
+
+    /*
+     * Callbacks may add, remove and re-arm watchdogs, so each callback is
+     * copied before it runs. A watchdog that an earlier callback removed,
+     * re-armed, reset or disarmed lost its expiring tag, and is neither
+     * called nor reported.
+     */
+    expired.swap(m_expired);
+    m_dispatching = true;
+    try
+    {
+        for (int watchdogId : expired)
+        {
+            int32_t entryIdx = this->entryIndexFor(watchdogId);
+
+            if ((-1 == entryIdx) || !m_entries[entryIdx].expiring)
+            {
+                continue;
+            }
+
+            m_entries[entryIdx].expiring = false;
+            expired[reportedCount++] = watchdogId;
+            m_expirations++;
+            if (m_entries[entryIdx].callback)
+            {
+                ExpiryCallback theCallback = m_entries[entryIdx].callback;
+
+                theCallback(watchdogId);
+            }
+        }
+        expired.resize(reportedCount);
+
+        for (size_t cbIdx = 0u; (reportedCount > 0u) && (cbIdx < m_batchCallbacks.size()); ++cbIdx)
+        {
+            BatchCallback theCallback = m_batchCallbacks[cbIdx];
+
+            theCallback(expired);
+        }
+    }
+    catch (...)
+    {
+        /*
+         * Watchdogs behind the callback that threw are not reported.
+         */
+        for (int watchdogId : expired)
+        {
+            int32_t entryIdx = this->entryIndexFor(watchdogId);
+
+            if (entryIdx != -1)
+            {
+                m_entries[entryIdx].expiring = false;
+            }
+        }
+        m_dispatching = false;
+        this->programEarliest();
+        throw;
+    }
+    m_dispatching = false;
+
+    expired.clear();
+    m_expired.swap(expired);
+    this->programEarliest();
+}
+
+
+int
+WatchdogService::add(ExpiryCallback expiryCb)
+{
+    int32_t entryIdx = m_freeHead;
+
+    if (-1 == entryIdx)
+    {
+        Entry newEntry;
+
+        if (m_entries.size() > RF_CK_WDS_INDEX_MASK)
+        {
+            throw std::length_error("Watchdog service capacity exhausted.");
+        }
+        newEntry.deadlineNs = 0u;
+        newEntry.generation = 0u;
+        m_entries.push_back(newEntry);
+        entryIdx = static_cast<int32_t>(m_entries.size() - 1u);
+    }
+    else
+    {
+        m_freeHead = m_entries[entryIdx].next;
+    }
+
+    Entry& theEntry = m_entries[entryIdx];
+    theEntry.callback = std::move(expiryCb);
+    theEntry.queue = -1;
+    theEntry.prev = -1;
+    theEntry.next = -1;
+    theEntry.inUse = true;
+    theEntry.armed = false;
+    theEntry.expiring = false;
+
+    return this->makeWatchdogId(entryIdx);
+}
+
+
+bool
+WatchdogService::remove(int watchdogId)
+{
+    int32_t entryIdx = this->entryIndexFor(watchdogId);
+
+    if (-1 == entryIdx)
+    {
+        return false;
+    }
+
+    if (m_entries[entryIdx].armed)
+    {
+        this->unlink(entryIdx);
+    }
+
+    /*
+     * Bumping the generation invalidates every identifier handed out for
+     * this entry, including any waiting to be reported as expired.
+     */
+    Entry& theEntry = m_entries[entryIdx];
+    theEntry.callback = ExpiryCallback();
+    theEntry.generation++;
+    theEntry.inUse = false;
+    theEntry.expiring = false;
+    theEntry.next = m_freeHead;
+    m_freeHead = entryIdx;
+
+    /*
+     * The timerfd() is intentionally left alone. At worst it produces one
+     * wake up with nothing to expire, after which it is re-programmed.
+     */
+    return true;
+}
+
+
+bool
+WatchdogService::activate(int watchdogId, double timeout, double slack)
+{
+    int32_t entryIdx = this->entryIndexFor(watchdogId);
+    int32_t queueIdx = -1;
+    uint64_t deadlineNs = 0u;
+
+    if (-1 == entryIdx)
+    {
+        return false;
+    }
+
+    if (m_entries[entryIdx].armed)
+    {
+        this->unlink(entryIdx);
+    }
+    m_entries[entryIdx].expiring = false;
+    queueIdx = this->queueFor(secsToNs(timeout), secsToNs(slack));
+    m_entries[entryIdx].queue = queueIdx;
+    this->append(entryIdx, WatchdogService::currentNs());
+
+    deadlineNs = m_entries[entryIdx].deadlineNs + m_queues[queueIdx].slackNs;
+    if (!m_dispatching && (deadlineNs < m_programmedNs))
+    {
+        this->program(deadlineNs);
+    }
+
+    return true;
+}
+
+
+bool
+WatchdogService::deactivate(int watchdogId)
+{
+    int32_t entryIdx = this->entryIndexFor(watchdogId);
+
+    if (-1 == entryIdx)
+    {
+        return false;
+    }
+
+    if (m_entries[entryIdx].armed)
+    {
+        this->unlink(entryIdx);
+    }
+    m_entries[entryIdx].expiring = false;
+
+    return true;
+}
+
+
+bool
+WatchdogService::reset(int watchdogId)
+{
+    int32_t entryIdx = this->entryIndexFor(watchdogId);
+
+    if ((-1 == entryIdx) || !(m_entries[entryIdx].armed || m_entries[entryIdx].expiring))
+    {
+        return false;
+    }
+
+    /*
+     * The new deadline is the latest in the queue, so the watchdog moves to
+     * the tail; it can only be later than the programmed one, so the
+     * timerfd() is left alone. A watchdog waiting to be reported as expired
+     * was only just disarmed, and is re-armed instead.
+     */
+    if (m_entries[entryIdx].armed)
+    {
+        this->unlink(entryIdx);
+    }
+    m_entries[entryIdx].expiring = false;
+    this->append(entryIdx, WatchdogService::currentNs());
+
+    return true;
+}
+
+
+bool
+WatchdogService::isActive(int watchdogId) const
+{
+    int32_t entryIdx = this->entryIndexFor(watchdogId);
+
+    return ((entryIdx != -1) && m_entries[entryIdx].armed);
+}
+
+
+void
+WatchdogService::addBatchCallback(BatchCallback batchCb)
+{
+    m_batchCallbacks.push_back(std::move(batchCb));
+}
+
+
+uint64_t
+WatchdogService::currentNs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<uint64_t>(now.tv_sec) * RF_CK_WDS_NS_PER_SEC + static_cast<uint64_t>(now.tv_nsec);
+}
+
+
+int32_t
+WatchdogService::entryIndexFor(int watchdogId) const
+{
+    uint32_t entryIdx = 0u;
+    uint32_t generation = 0u;
+
+    if ((watchdogId <= 0) || (0 == (watchdogId & RF_CK_WDS_ID_MARKER)))
+    {
+        return -1;
+    }
+
+    entryIdx = static_cast<uint32_t>(watchdogId) & RF_CK_WDS_INDEX_MASK;
+    generation = (static_cast<uint32_t>(watchdogId) >> RF_CK_WDS_INDEX_BITS) & RF_CK_WDS_GEN_MASK;
+    if ((entryIdx >= m_entries.size()) ||
+        !m_entries[entryIdx].inUse ||
+        ((m_entries[entryIdx].generation & RF_CK_WDS_GEN_MASK) != generation))
+    {
+        return -1;
+    }
+
+    return static_cast<int32_t>(entryIdx);
+}
+
+
+int
+WatchdogService::makeWatchdogId(int32_t entryIndex) const
+{
+    return RF_CK_WDS_ID_MARKER |
+        static_cast<int>((m_entries[entryIndex].generation & RF_CK_WDS_GEN_MASK) << RF_CK_WDS_INDEX_BITS) |
+        entryIndex;
+}
+
+
+int32_t
+WatchdogService::queueFor(uint64_t timeoutNs, uint64_t slackNs)
+{
+    Queue newQueue;
+
+    /*
+     * Applications use a handful of distinct timeouts, so a linear search
+     * is all it takes; queues are never discarded.
+     */
+    for (size_t queueIdx = 0u; queueIdx < m_queues.size(); ++queueIdx)
+    {
+        if ((m_queues[queueIdx].timeoutNs == timeoutNs) && (m_queues[queueIdx].slackNs == slackNs))
+        {
+            return static_cast<int32_t>(queueIdx);
+        }
+    }
+
+    newQueue.timeoutNs = timeoutNs;
+    newQueue.slackNs = slackNs;
+    newQueue.head = -1;
+    newQueue.tail = -1;
+    m_queues.push_back(newQueue);
+
+    return static_cast<int32_t>(m_queues.size() - 1u);
+}
+
+
+void
+WatchdogService::append(int32_t entryIndex, uint64_t nowNs)
+{
+    Entry& theEntry = m_entries[entryIndex];
+    Queue& theQueue = m_queues[theEntry.queue];
+
+    theEntry.deadlineNs = nowNs + theQueue.timeoutNs;
+    theEntry.prev = theQueue.tail;
+    theEntry.next = -1;
+    if (theQueue.tail != -1)
+    {
+        m_entries[theQueue.tail].next = entryIndex;
+    }
+    else
+    {
+        theQueue.head = entryIndex;
+    }
+    theQueue.tail = entryIndex;
+    theEntry.armed = true;
+    ++m_activeCount;
+}
+
+
+void
+WatchdogService::unlink(int32_t entryIndex)
+{
+    Entry& theEntry = m_entries[entryIndex];
+    Queue& theQueue = m_queues[theEntry.queue];
+
+    if (theEntry.prev != -1)
+    {
+        m_entries[theEntry.prev].next = theEntry.next;
+    }
+    else
+    {
+        theQueue.head = theEntry.next;
+    }
+    if (theEntry.next != -1)
+    {
+        m_entries[theEntry.next].prev = theEntry.prev;
+    }
+    else
+    {
+        theQueue.tail = theEntry.prev;
+    }
+    theEntry.prev = -1;
+    theEntry.next = -1;
+    theEntry.armed = false;
+    --m_activeCount;
+}
+
+
+void
+WatchdogService::program(uint64_t deadlineNs)
+{
+    struct itimerspec timerSpec;
+
+    memset(&timerSpec, 0x00, sizeof(timerSpec));
+    if (deadlineNs != RF_CK_WDS_NO_DEADLINE)
+    {
+        timerSpec.it_value.tv_sec = static_cast<time_t>(deadlineNs / RF_CK_WDS_NS_PER_SEC);
+        timerSpec.it_value.tv_nsec = static_cast<long>(deadlineNs % RF_CK_WDS_NS_PER_SEC);
+    }
+
+    if (timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &timerSpec, nullptr) == -1)
+    {
+        throw OsErrorException("timerfd_settime", errno);
+    }
+    m_programmedNs = deadlineNs;
+}
+
+
+void
+WatchdogService::programEarliest()
+{
+    uint64_t earliest = RF_CK_WDS_NO_DEADLINE;
+
+    for (Queue const& aQueue : m_queues)
+    {
+        if ((aQueue.head != -1) && ((m_entries[aQueue.head].deadlineNs + aQueue.slackNs) < earliest))
+        {
+            earliest = m_entries[aQueue.head].deadlineNs + aQueue.slackNs;
+        }
+    }
+
+    if (earliest != m_programmedNs)
+    {
+        this->program(earliest);
+    }
+}
+
+} // end namespace CoreKit
+
+// vim: set ts=4 sw=4 expandtab:
@@ -0,0 +1,238 @@
+/**
+ * \file WatchdogService.h
+ * \brief Contains the definition of the \c WatchdogService class.
+ * \date 2026-10-16 19:02:15
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_WATCHDOGSERVICE_H_
+#define _FOUNDATION_COREKIT_WATCHDOGSERVICE_H_
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+#include <CoreKit/InputSource.h>
+
+namespace CoreKit
+{
+
+class InterruptListener;
+
+/**
+ * \brief Any number of watchdogs driven by a single \c timerfd()
+ *
+ * Every armed watchdog has an absolute deadline, in nanoseconds, measured
+ * on the monotonic clock. Watchdogs armed with the same timeout (and slack)
+ * share a queue; since a reset always moves a watchdog's deadline to "now
+ * plus timeout", appending it to the tail of its queue keeps the queue
+ * sorted, so \c reset() is a constant time operation that involves neither
+ * a search nor a system call. The \c timerfd() is programmed for the
+ * earliest deadline among the queue heads; a reset that pushes that
+ * deadline out at worst causes a wake up that expires nothing.\par
+ *
+ * Watchdogs may declare a slack, by which their expiration may be delayed
+ * so that it shares a wake up with others. All watchdogs that expire in a
+ * wake up are reported together, in deadline order: first to their own
+ * callbacks, then, as one list, to the batch callbacks. A watchdog that an
+ * earlier callback re-arms, resets, disarms or removes is left out.\par
+ *
+ * Watchdog identifiers always have bit 30 set, which keeps them positive.
+ *
+ * \note Instances are normally created and owned by \c CoreKit::RunLoop.
+ *       See \c RunLoop::watchdogService(). \c CoreKit::WatchdogTimer is a
+ *       handle to a watchdog managed by this class.
+ */
+class WatchdogService : public InputSource
+{
+public:
+    /**
+     * \brief Callback told that its watchdog expired.
+     */
+    typedef std::function< void(int watchdogId) > ExpiryCallback;
+
+    /**
+     * \brief Callback told about all the watchdogs that expired in one wake up.
+     */
+    typedef std::function< void(std::vector< int > const& watchdogIds) > BatchCallback;
+
+    /**
+     * \brief Create the \c timerfd() facility that drives the service.
+     *
+     * \throw OsErrorException if the \c timerfd() can not be created.
+     */
+    WatchdogService();
+
+    /**
+     * \brief Destructor.
+     */
+    virtual ~WatchdogService();
+
+    /**
+     * \brief Access the underlying \c timerfd() file descriptor.
+     *
+     * \return File descriptor associated with this input source.
+     */
+    virtual int fileDescriptor() const override;
+
+    /**
+     * \brief Watchdogs carry their own callbacks, so the service has no listener.
+     *
+     * \return Always \c nullptr.
+     */
+    virtual InterruptListener* interruptListener() const override;
+
+    /**
+     * \brief Expire all watchdogs that are due and re-program the \c timerfd().
+     */
+    virtual void fireCallback() override;
+
+    /**
+     * \brief Create a new, disarmed, watchdog.
+     *
+     * \param[in] expiryCb - Callback told when the watchdog expires; may be
+     *            empty if only the batch callbacks are of interest.
+     *
+     * \return Identifier for the new watchdog.
+     */
+    int add(ExpiryCallback expiryCb);
+
+    /**
+     * \brief Destroy a watchdog and release its identifier.
+     *
+     * \param[in] watchdogId - Identifier produced by \c add().
+     *
+     * \return \c true if the watchdog was found; \c false otherwise.
+     */
+    bool remove(int watchdogId);
+
+    /**
+     * \brief Arm a watchdog.
+     *
+     * The watchdog expires \c timeout seconds from now unless it is reset
+     * or disarmed first. Arming an armed watchdog restarts it with the new
+     * settings.
+     *
+     * \param[in] watchdogId - Identifier produced by \c add().
+     * \param[in] timeout - Seconds without a reset before it expires.
+     * \param[in] slack - Seconds the expiration may be delayed by so it
+     *            shares a wake up with other watchdogs.
+     *
+     * \return \c true if the watchdog was found; \c false otherwise.
+     */
+    bool activate(int watchdogId, double timeout, double slack = 0.0);
+
+    /**
+     * \brief Disarm a watchdog; it keeps its identifier.
+     *
+     * \param[in] watchdogId - Identifier produced by \c add().
+     *
+     * \return \c true if the watchdog was found; \c false otherwise.
+     */
+    bool deactivate(int watchdogId);
+
+    /**
+     * \brief Restart the countdown of an armed watchdog.
+     *
+     * Meant for the hot path, e.g. every time a message arrives from the
+     * monitored peer. Resetting a disarmed watchdog does nothing, save for
+     * one whose expiration an earlier callback of the same wake up has not
+     * been told about yet; that expiration is called off, and the watchdog
+     * re-armed.
+     *
+     * \param[in] watchdogId - Identifier produced by \c add().
+     *
+     * \return \c true if the watchdog is armed; \c false otherwise.
+     */
+    bool reset(int watchdogId);
+
+    /**
+     * \brief Check whether a watchdog is armed.
+     *
+     * \param[in] watchdogId - Identifier produced by \c add().
+     *
+     * \return \c true if the watchdog exists and is armed.
+     */
+    bool isActive(int watchdogId) const;
+
+    /**
+     * \brief Register a callback told about each batch of expirations.
+     *
+     * \param[in] batchCb - Callback to add.
+     */
+    void addBatchCallback(BatchCallback batchCb);
+
+    /**
+     * \brief Count the watchdogs currently armed.
+     *
+     * \return Number of armed watchdogs.
+     */
+    inline size_t activeCount() const { return m_activeCount; }
+
+    /**
+     * \brief Count the times the \c timerfd() woke up the service.
+     *
+     * \return Number of wake ups.
+     */
+    inline uint64_t wakeups() const { return m_wakeups; }
+
+    /**
+     * \brief Count the watchdog expirations reported.
+     *
+     * \return Number of expirations.
+     */
+    inline uint64_t expirations() const { return m_expirations; }
+
+private:
+    struct Entry
+    {
+        ExpiryCallback callback;
+        uint64_t deadlineNs;
+        int32_t queue;
+        int32_t prev;
+        int32_t next;
+        uint32_t generation;
+        bool inUse;
+        bool armed;
+        bool expiring;
+    };
+
+
+    struct Queue
+    {
+        uint64_t timeoutNs;
+        uint64_t slackNs;
+        int32_t head;
+        int32_t tail;
+    };
+
+    int m_timerFd;
+    uint64_t m_programmedNs;
+    bool m_dispatching;
+    size_t m_activeCount;
+    uint64_t m_wakeups;
+    uint64_t m_expirations;
+    int32_t m_freeHead;
+    std::vector< Entry > m_entries;
+    std::vector< Queue > m_queues;
+    std::vector< int > m_expired;
+    std::vector< BatchCallback > m_batchCallbacks;
+
+    static uint64_t currentNs();
+    int32_t entryIndexFor(int watchdogId) const;
+    int makeWatchdogId(int32_t entryIndex) const;
+    int32_t queueFor(uint64_t timeoutNs, uint64_t slackNs);
+    void append(int32_t entryIndex, uint64_t nowNs);
+    void unlink(int32_t entryIndex);
+    void program(uint64_t deadlineNs);
+    void programEarliest();
+
+    WatchdogService(WatchdogService const& other);
+    WatchdogService& operator=(WatchdogService const& other);
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_WATCHDOGSERVICE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
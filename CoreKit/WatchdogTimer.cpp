@@ -18,8 +18,9 @@ namespace CoreKit
 {
 
 WatchdogTimer::WatchdogTimer(CoreKit::AppLog::Level logLevel) :
-        m_logLevel(logLevel), m_counter(0u), m_timeout(0u), m_active(false), m_callbacks(), m_timerFd(
-                -1), m_runLoop(NULL)
+        m_logLevel(logLevel), m_timeout(0u), m_interval(1.0f), m_slackFraction(
+                0.0f), m_active(false), m_callbacks(), m_watchdogId(-1), m_service(
+                NULL)
 {
 
 }
@@ -31,43 +32,37 @@ static void deleteCallback(WatchdogExpiredCallback * callback)
 
 WatchdogTimer::~WatchdogTimer()
 {
-    if (m_timerFd > 0)
-    {
-        //need try/catch here to avoid exception being thrown in destructor
-        try
-        {
-            terminate();
-        } catch (OsErrorException const & exc)
-        {
-            if (NULL != G_MyApp)
-            {
-                G_MyApp->log() << AppLog::LL_ERROR
-                        << "Watchdog timer: Exception while de-registering timer: "
-                        << exc.what() << EndLog;
-            }
-        }
-    }
+    terminate();
     for_each(m_callbacks.begin(), m_callbacks.end(), deleteCallback);
 }
 
 void WatchdogTimer::terminate()
 {
-    if (NULL != m_runLoop)
+    if (NULL != m_service)
     {
-        if (m_timerFd > 0)
+        if (m_watchdogId > 0)
         {
-            m_runLoop->deregisterTimer(m_timerFd);
-            m_timerFd = -1;
+            m_service->remove(m_watchdogId);
+            m_watchdogId = -1;
         }
     }
 }
 
-void WatchdogTimer::initialize(CoreKit::RunLoop * runLoop, float interval)
+void WatchdogTimer::initialize(CoreKit::RunLoop * runLoop, float interval, float slackFraction)
 {
     if (NULL != runLoop)
     {
-        m_runLoop = runLoop;
-        m_timerFd = m_runLoop->registerTimerWithInterval(interval, this, true);
+        m_service = runLoop->watchdogService();
+        m_interval = interval;
+        m_slackFraction = (slackFraction > 0.0f) ? slackFraction : 0.0f;
+        m_watchdogId = m_service->add(
+                [this](int watchdogId) { this->watchdogExpired(watchdogId); });
+
+        //activation may have preceded initialization
+        if (m_active)
+        {
+            this->activate(m_timeout);
+        }
     }
     else
     {
@@ -84,24 +79,35 @@ void WatchdogTimer::initialize(CoreKit::RunLoop * runLoop, float interval)
 void WatchdogTimer::activate(uint32_t timeout)
 {
     m_timeout = timeout;
-    m_counter = 0;
     m_active = true;
+    if ((NULL != m_service) && (m_watchdogId > 0))
+    {
+        m_service->activate(m_watchdogId,
+                static_cast<double>(m_interval) * timeout,
+                static_cast<double>(m_interval) * m_slackFraction);
+    }
 }
 
 void WatchdogTimer::deactivate()
 {
-    m_counter = 0;
     m_active = false;
+    if ((NULL != m_service) && (m_watchdogId > 0))
+    {
+        m_service->deactivate(m_watchdogId);
+    }
 }
 
 void WatchdogTimer::reset()
 {
-    m_counter = 0;
+    if ((NULL != m_service) && (m_watchdogId > 0))
+    {
+        m_service->reset(m_watchdogId);
+    }
 }
 
 int WatchdogTimer::getTimerFd() const
 {
-    return m_timerFd;
+    return m_watchdogId;
 }
 
 uint32_t WatchdogTimer::getTimeout() const
@@ -128,25 +134,19 @@ void WatchdogTimer::registerExpirationCallback(
     }
 }
 
-void WatchdogTimer::timerExpired(int timerFd)
+void WatchdogTimer::watchdogExpired(int watchdogId)
 {
-    if (m_active)
+    //the service disarms expired watchdogs
+    m_active = false;
+    if (NULL != G_MyApp)
     {
-        m_counter++;
-        if (m_counter >= m_timeout)
-        {
-            if (NULL != G_MyApp)
-            {
-                G_MyApp->log() << m_logLevel
-                        << "Watchdog timer: Timer expired after " << m_timeout
-                        << " ticks.  Notifying listeners" << EndLog;
-            }
-            this->deactivate();
-            for_each(m_callbacks.begin(), m_callbacks.end(),
-                    bind2nd(mem_fun(&WatchdogExpiredCallback::operator()),
-                            timerFd));
-        }
+        G_MyApp->log() << m_logLevel
+                << "Watchdog timer: Timer expired after " << m_timeout
+                << " ticks.  Notifying listeners" << EndLog;
     }
+    for_each(m_callbacks.begin(), m_callbacks.end(),
+            bind2nd(mem_fun(&WatchdogExpiredCallback::operator()),
+                    watchdogId));
 }
 
 } /* namespace GPP */
@@ -22,6 +22,7 @@
 //
 #include "RunLoop.h"
 #include "WatchdogExpiredCallback.h"
+#include "WatchdogService.h"
 #include "AppLog.h"
 
 namespace CoreKit
@@ -30,6 +31,8 @@ namespace CoreKit
 /**
  * \brief Watchdog timer class
  * Timer starts on activate and will call all callbacks unless deactivated before timeout reached.
+ * Instances are handles to watchdogs managed by the \c WatchdogService of
+ * their run loop, so any number of them share a single timer.
  * \date 2015-06-19
  * \author Ryan O'Farrell
  */
@@ -52,20 +55,23 @@ public:
      * \brief Initializes the watchdog timer with a run loop
      * \param runLoop the run loop to trigger the timer callback
      * \param interval The interval for ticks in seconds (defaults to 1 second)
-     * \throws OsErrorException if problem registering timer in RunLoop
+     * \param slackFraction fraction of the interval expiration may be delayed
+     *        by so it shares a wake up with other watchdogs (defaults to a
+     *        tenth; 0 for exact expiration)
+     * \throws OsErrorException if problem creating the run loop's watchdog service
      */
-    virtual void initialize(RunLoop * runLoop, float interval=1.0f);
+    virtual void initialize(RunLoop * runLoop, float interval=1.0f, float slackFraction=0.1f);
 
     /**
-     * \brief Terminates the Watchdog Timer instance by de-registering the timer
-     * from the Run Loop
-     * \throws OsErrorException if problem de-registering timer in RunLoop
+     * \brief Terminates the Watchdog Timer instance by removing its watchdog
+     * from the Run Loop's watchdog service
      */
     virtual void terminate();
 
     /**
      * \brief Activates the watchdog timer
-     * \param timeout time before timeout in ticks (based on timerExpired)
+     * \param timeout time before timeout in ticks; expiration happens exactly
+     *        \c timeout times the tick interval after the last reset
      */
     virtual void activate(uint32_t timeout);
 
@@ -75,13 +81,13 @@ public:
     virtual void deactivate();
 
     /**
-     * \brief Resets the watchdog timer. Sets count to 0 but does not de-activate
+     * \brief Resets the watchdog timer. Restarts the countdown but does not de-activate
      */
     virtual void reset();
 
     /*
-     * \brief Gets the timer FD for this instance
-     * \return timer FD for watchdog, -1 if not yet initialized
+     * \brief Gets the identifier for this instance, as passed to the expiration callbacks
+     * \return watchdog identifier, -1 if not yet initialized
      */
     virtual int getTimerFd() const;
 
@@ -97,13 +103,13 @@ public:
      */
     virtual void registerExpirationCallback(WatchdogExpiredCallback *callback);
 
+private:
     /**
-     * \brief Callback for tick timer expired
-     * \param timerFd timer that expired
+     * \brief Notifies the listeners once the watchdog service reports expiration
+     * \param watchdogId identifier of the expired watchdog
      */
-    virtual void timerExpired(int timerFd);
+    void watchdogExpired(int watchdogId);
 
-private:
     /**
      * \brief Private copy constructor
      * \param other object to copy
@@ -117,12 +123,13 @@ private:
      */
     WatchdogTimer& operator=(WatchdogTimer const& other);
     CoreKit::AppLog::Level m_logLevel;
-    uint32_t m_counter;
     uint32_t m_timeout;
+    float m_interval;
+    float m_slackFraction;
     bool m_active;
     std::vector<WatchdogExpiredCallback *> m_callbacks;
-    int m_timerFd;
-    RunLoop *m_runLoop;
+    int m_watchdogId;
+    WatchdogService *m_service;
 };
 
 } /* namespace GPP */
@@ -0,0 +1,189 @@
+/**
+ * \file WorkStealingDeque.h
+ * \brief Contains the definition of the \c WorkStealingDeque class template.
+ * \date 2026-10-16 17:20:36
+ * \author Rolando J. Nieves
+ */
+
+#ifndef _FOUNDATION_COREKIT_WORKSTEALINGDEQUE_H_
+#define _FOUNDATION_COREKIT_WORKSTEALINGDEQUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <CoreKit/BoundedMpmcQueue.h>
+
+namespace CoreKit
+{
+
+/**
+ * \brief Fixed capacity, lock-free, single-owner deque that others may steal from.
+ *
+ * This is the Chase-Lev work-stealing deque: the thread that owns the
+ * deque pushes and pops at the bottom, like a stack, while any other thread
+ * may take the oldest element from the top with \c steal(). The owner only
+ * contends with thieves when a single element is left.
+ *
+ * \tparam T Element type; must be trivially copyable, since a thief may
+ *           read an element while the owner overwrites it. Pointers are the
+ *           usual choice.
+ */
+template< typename T >
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable< T >::value, "WorkStealingDeque elements must be trivially copyable.");
+
+private:
+    std::atomic< T > *m_slots;
+    int64_t m_mask;
+    alignas(RF_CK_CACHE_LINE_SIZE) std::atomic< int64_t > m_top;
+    alignas(RF_CK_CACHE_LINE_SIZE) std::atomic< int64_t > m_bottom;
+
+public:
+    /**
+     * \brief Create an empty deque.
+     *
+     * \param[in] capacity - Minimum number of elements the deque must hold;
+     *            rounded up to a power of two.
+     */
+    explicit WorkStealingDeque(size_t capacity):
+        m_slots(nullptr),
+        m_mask(0),
+        m_top(0),
+        m_bottom(0)
+    {
+        size_t actualCapacity = 2u;
+
+        while (actualCapacity < capacity)
+        {
+            actualCapacity <<= 1u;
+        }
+
+        m_slots = new std::atomic< T >[actualCapacity];
+        m_mask = static_cast< int64_t >(actualCapacity) - 1;
+    }
+
+    WorkStealingDeque(WorkStealingDeque const& other) = delete;
+    WorkStealingDeque(WorkStealingDeque&& other) = delete;
+
+    /**
+     * \brief Destructor.
+     */
+    ~WorkStealingDeque()
+    {
+        delete [] m_slots;
+        m_slots = nullptr;
+    }
+
+    /**
+     * \brief Approximate the number of elements in the deque.
+     *
+     * The value is only a snapshot when other threads are active.
+     *
+     * \return Number of elements.
+     */
+    inline size_t sizeApprox() const
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        return (bottom > top) ? static_cast< size_t >(bottom - top) : 0u;
+    }
+
+    /**
+     * \brief Add an element at the bottom; owner only.
+     *
+     * \param[in] value - Element to add.
+     *
+     * \return \c true if the element was added; \c false if the deque is full.
+     */
+    bool push(T value)
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_acquire);
+
+        if ((bottom - top) > m_mask)
+        {
+            return false;
+        }
+
+        m_slots[bottom & m_mask].store(value, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /**
+     * \brief Remove the newest element; owner only.
+     *
+     * \param[out] value - Receives the element removed.
+     *
+     * \return \c true if an element was removed; \c false if the deque is
+     *         empty or a thief took the last element.
+     */
+    bool pop(T& value)
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        int64_t top = 0;
+        bool result = true;
+
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        value = m_slots[bottom & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            /*
+             * Last element; race the thieves for it.
+             */
+            result = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    /**
+     * \brief Remove the oldest element; any thread.
+     *
+     * \param[out] value - Receives the element removed.
+     *
+     * \return \c true if an element was removed; \c false if the deque is
+     *         empty or another thread won the race for the element.
+     */
+    bool steal(T& value)
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        int64_t bottom = 0;
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return false;
+        }
+
+        value = m_slots[top & m_mask].load(std::memory_order_relaxed);
+
+        return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque& operator=(WorkStealingDeque const& other) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&& other) = delete;
+};
+
+} // end namespace CoreKit
+
+#endif /* !_FOUNDATION_COREKIT_WORKSTEALINGDEQUE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
@@ -20,6 +20,8 @@ namespace NetworkKit
 }
 
 #include "TcpClient.h"
+#include "TcpCoroutine.h"
+
 #include "TcpMessageCallback.h"
 #include "TcpMessageCallbackT.h"
 #include "ConnectionCallback.h"
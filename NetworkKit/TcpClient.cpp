@@ -58,7 +58,8 @@ TcpClient::TcpClient(int i_serverPortNum, std::string i_hostname,
                 new TcpMessageInputSource(m_loop)), m_serverPortNum(
                 i_serverPortNum), m_hostname(i_hostname), m_connectionState(
                 DISCONNECTED), m_disconnectionCallbacks(), m_keepCount(-1), m_keepInterval(
-                -1), m_keepIdle(-1), m_timerFd(-1)
+                -1), m_keepIdle(-1), m_timerFd(-1), m_firstWaiter(NULL), m_lastWaiter(
+                NULL)
 {
     //register disconnection callback for this class
     m_messageInputSource->addDisconnectionCallback(
@@ -107,12 +108,9 @@ void TcpClient::timerExpired(int timerFd)
         m_connectionState = DISCONNECTED;
         if (FD_ISSET(m_messageInputSource->fileDescriptor(), &outputFd))
         {
-            if (NULL != G_MyApp)
-            {
-                G_MyApp->log() << AppLog::LL_DEBUG
-                        << "TcpClient : connect select returned, checking if connected."
-                        << EndLog;
-            }
+            RF_CK_APP_LOG(LL_DEBUG)
+                    << "TcpClient : connect select returned, checking if connected."
+                    << EndLog;
 
             //check error in sock opt to see if connected
             int errorCode = m_messageInputSource->getSocket()->getErrorCode();
@@ -129,11 +127,8 @@ void TcpClient::timerExpired(int timerFd)
             }
             else
             {
-                if (NULL != G_MyApp)
-                {
-                    G_MyApp->log() << AppLog::LL_DEBUG
-                            << "TcpClient : Client connected" << EndLog;
-                }
+                RF_CK_APP_LOG(LL_DEBUG)
+                        << "TcpClient : Client connected" << EndLog;
                 if (NULL != m_loop)
                 {
                     m_loop->registerInputSource(m_messageInputSource);
@@ -253,8 +248,11 @@ int TcpClient::connect(bool blocking)
                 m_connectionState = PENDING;
                 if (NULL != m_loop)
                 {
-                    m_timerFd = m_loop->registerTimerWithInterval(0.1, this,
-                            true);
+                    //the connect poll is not time critical, so let it
+                    //share wake ups with other housekeeping timers
+                    m_timerFd = m_loop->registerTimerWithSlack(0.1, 0.1,
+                            0.05, this);
+
                 }
                 break;
             default:
@@ -299,6 +297,8 @@ void TcpClient::onDisconnection(ConnectionNotification *notification)
             bind2nd(mem_fun(&ConnectionCallback::operator()), notification));
 
     m_connectionState = DISCONNECTED;
+
+    notifyMessageWaiters(NULL);
 }
 
 void TcpClient::findHostIpAddress()
@@ -346,8 +346,80 @@ void TcpClient::onTcpMessage(TcpMessageNotification *tcpMessageNotification)
     for_each(m_callbacks.begin(), m_callbacks.end(),
             bind2nd(mem_fun(&TcpMessageCallback::operator()),
                     tcpMessageNotification));
+
+    notifyMessageWaiters(tcpMessageNotification);
 }
 
+void TcpClient::addMessageWaiter(MessageWaiter* theWaiter)
+{
+    if (NULL == theWaiter)
+    {
+        throw PreconditionNotMetException("Can not register NULL waiter");
+    }
+
+    theWaiter->m_nextWaiter = NULL;
+    if (NULL == m_lastWaiter)
+    {
+        m_firstWaiter = theWaiter;
+    }
+    else
+    {
+        m_lastWaiter->m_nextWaiter = theWaiter;
+    }
+    m_lastWaiter = theWaiter;
+}
+
+void TcpClient::removeMessageWaiter(MessageWaiter* theWaiter)
+{
+    MessageWaiter *prevWaiter = NULL;
+    MessageWaiter *aWaiter = m_firstWaiter;
+
+    while ((aWaiter != NULL) && (aWaiter != theWaiter))
+    {
+        prevWaiter = aWaiter;
+        aWaiter = aWaiter->m_nextWaiter;
+    }
+
+    if (aWaiter != NULL)
+    {
+        if (NULL == prevWaiter)
+        {
+            m_firstWaiter = aWaiter->m_nextWaiter;
+        }
+        else
+        {
+            prevWaiter->m_nextWaiter = aWaiter->m_nextWaiter;
+        }
+        if (m_lastWaiter == aWaiter)
+        {
+            m_lastWaiter = prevWaiter;
+        }
+        aWaiter->m_nextWaiter = NULL;
+    }
+}
+
+void TcpClient::notifyMessageWaiters(
+        TcpMessageNotification const* tcpMessageNotification)
+{
+    MessageWaiter *aWaiter = m_firstWaiter;
+    MessageWaiter *nextWaiter = NULL;
+
+    /* Detach the current waiters first. Waiters usually add themselves (or
+     * a successor) back while being notified, and those are meant for the
+     * next message.
+     */
+    m_firstWaiter = NULL;
+    m_lastWaiter = NULL;
+    while (aWaiter != NULL)
+    {
+        nextWaiter = aWaiter->m_nextWaiter;
+        aWaiter->m_nextWaiter = NULL;
+        aWaiter->messageReceived(tcpMessageNotification);
+        aWaiter = nextWaiter;
+    }
+}
+
+
 void TcpClient::addDisconnectionCallback(ConnectionCallback* theCallback)
 {
     if (NULL == theCallback)
@@ -372,12 +444,9 @@ void TcpClient::removeMessageListener()
         }
         catch (CoreKit::OsErrorException &osError)
         {
-            if (NULL != G_MyApp)
-            {
-                G_MyApp->log() << AppLog::LL_DEBUG
-                        << "Error de-registering input source "
-                        << osError.what() << CoreKit::EndLog;
-            }
+            RF_CK_APP_LOG(LL_DEBUG)
+                    << "Error de-registering input source "
+                    << osError.what() << CoreKit::EndLog;
         }
     }
 }
@@ -28,6 +28,32 @@ RF_CK_FACTORY_COMPATIBLE(TcpClient)
     ;
 public:
 
+    /**
+     * \brief One-shot listener for the next message received by a \c TcpClient
+     * \details Unlike \c TcpMessageCallback instances, waiters are not owned
+     * by the client and are dropped after being notified once, which suits
+     * listeners that live on the stack or in a coroutine frame (see
+     * \c NetworkKit/TcpCoroutine.h).
+     */
+    class MessageWaiter
+    {
+    public:
+        MessageWaiter() : m_nextWaiter(NULL) {}
+        virtual ~MessageWaiter() {}
+
+        /**
+         * \brief Receive the next message
+         * \param tcpMessageNotification the message, only valid for the
+         *  duration of the call; NULL if the connection was lost instead
+         */
+        virtual void messageReceived(TcpMessageNotification const* tcpMessageNotification) = 0;
+
+    private:
+        MessageWaiter *m_nextWaiter;
+
+        friend class TcpClient;
+    };
+
     /**
      * \brief Constructor
      * \param i_serverPortNum the server port to connect to
@@ -94,6 +120,21 @@ public:
      */
     void addDisconnectionCallback(ConnectionCallback* theCallback);
 
+    /**
+     * \brief Notifies a waiter of the next message received, or of the loss of the connection
+     * \details The waiter is not owned by this class and must remain valid
+     *  until it is notified or removed
+     * \param theWaiter the waiter to notify
+     * \throw CoreKit::PreconditionNotMetException if theWaiter is NULL
+     */
+    void addMessageWaiter(MessageWaiter* theWaiter);
+
+    /**
+     * \brief Cancels a waiter added via \c addMessageWaiter
+     * \param theWaiter the waiter to cancel
+     */
+    void removeMessageWaiter(MessageWaiter* theWaiter);
+
     /**
      * \brief Callback for when the socket for this client is disconnected.
      * \details When this method is called, this class will in turn notify any registered callbacks
@@ -157,6 +198,7 @@ private:
     void deleteInputSource();
     void deleteCallbacks();
     void findHostIpAddress();
+    void notifyMessageWaiters(TcpMessageNotification const* tcpMessageNotification);
 
     enum ConnectionState
     {
@@ -189,6 +231,10 @@ private:
     int m_keepIdle;
     /** Timer FD for connect select */
     int m_timerFd;
+    /** One-shot message waiters, in the order they were added */
+    MessageWaiter *m_firstWaiter;
+    MessageWaiter *m_lastWaiter;
+
 };
 
 } /* namespace NetworkKit */
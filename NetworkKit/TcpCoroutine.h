@@ -0,0 +1,81 @@
+/**
+ * \file TcpCoroutine.h
+ * \brief Contains the coroutine awaitables for \c TcpClient.
+ * \date 2026-10-16 15:02:47
+ * \author Rolando J. Nieves
+ *
+ * Requires C++20 coroutine support; see \c CoreKit/Coroutine.h.
+ */
+
+#ifndef _FOUNDATION_NETWORKKIT_TCPCOROUTINE_H_
+#define _FOUNDATION_NETWORKKIT_TCPCOROUTINE_H_
+
+#include <CoreKit/Coroutine.h>
+
+#if defined(RF_CK_HAS_COROUTINES)
+
+#include "TcpClient.h"
+#include "TcpMessageNotification.h"
+
+namespace NetworkKit
+{
+
+/**
+ * \brief Awaitable that suspends until a \c TcpClient receives a message.
+ *
+ * The message is handed over by pointer, without copying; it remains valid
+ * until the coroutine suspends again. The pointer is \c NULL if the
+ * connection was lost before a message arrived.
+ */
+class NextMessageAwaiter : public TcpClient::MessageWaiter
+{
+public:
+    explicit NextMessageAwaiter(TcpClient& tcpClient)
+    : m_tcpClient(tcpClient), m_message(nullptr)
+    {
+
+    }
+
+    inline bool await_ready() const noexcept { return false; }
+
+    inline void await_suspend(std::coroutine_handle<> waiter)
+    {
+        m_waiter = waiter;
+        m_tcpClient.addMessageWaiter(this);
+    }
+
+    inline TcpMessageNotification const* await_resume() const noexcept { return m_message; }
+
+    virtual void messageReceived(TcpMessageNotification const* tcpMessageNotification)
+    {
+        m_message = tcpMessageNotification;
+        m_waiter.resume();
+    }
+
+private:
+    TcpClient& m_tcpClient;
+    TcpMessageNotification const *m_message;
+    std::coroutine_handle<> m_waiter;
+};
+
+
+/**
+ * \brief Wait for the next message received by a TCP client.
+ *
+ * \param[in] tcpClient - Client to receive from.
+ *
+ * \return Awaitable; \c co_await it to suspend until a message arrives or
+ *         the connection is lost.
+ */
+inline NextMessageAwaiter nextMessage(TcpClient& tcpClient)
+{
+    return NextMessageAwaiter(tcpClient);
+}
+
+} // end namespace NetworkKit
+
+#endif /* RF_CK_HAS_COROUTINES */
+
+#endif /* !_FOUNDATION_NETWORKKIT_TCPCOROUTINE_H_ */
+
+// vim: set ts=4 sw=4 expandtab:
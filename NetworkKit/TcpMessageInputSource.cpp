@@ -50,6 +50,7 @@ TcpMessageInputSource::TcpMessageInputSource(CoreKit::RunLoop *i_loop) :
                 NULL), m_buffering(false)
 {
     m_socket = construct(TcpSocket::myType());
+    this->setPreReadMode(PRM_DATA);
 }
 
 TcpMessageInputSource::TcpMessageInputSource(CoreKit::RunLoop *i_loop,
@@ -60,6 +61,7 @@ TcpMessageInputSource::TcpMessageInputSource(CoreKit::RunLoop *i_loop,
 {
     m_socket = construct(TcpSocket::myType());
     m_socket->setSockFd(i_sockFd);
+    this->setPreReadMode(PRM_DATA);
 }
 
 /**
@@ -150,82 +152,135 @@ void TcpMessageInputSource::inputAvailableFrom(InputSource *inputSource)
 
     if (0 > recvResult)
     {
-        //error reading socket
-        if (NULL != G_MyApp)
-        {
-            G_MyApp->log() << CoreKit::AppLog::LL_ERROR
-                    << "Error reading from socket number = "
-                    << m_socket->getSockFd() << "\n" << "Error number = "
-                    << errno << CoreKit::EndLog;
-        }
+        int readErrno = errno;
+
+        //error reading socket; a failing socket stays readable, so throttle
+        RF_CK_APP_LOG_LIMITED(LL_ERROR, 5u, 10.0)
+                << "Error reading from socket number = "
+                << m_socket->getSockFd() << "\n" << "Error number = "
+                << readErrno << CoreKit::EndLog;
     }
     else if (0 == recvResult)
     {
+        this->onSocketClosed();
+    }
+    else
+    {
+        m_prototypeMessageNotification->m_message.resize(
+                originalSize + recvResult);
+        this->deliverMessage();
+    }
+}
+
+void TcpMessageInputSource::dataAvailable(
+        CoreKit::PreReadData const& readData)
+{
+    size_t offset = 0;
+
+    if (NULL == m_prototypeMessageNotification)
+    {
+        bufferData(0);
+    }
+
+    if (0 > readData.result)
+    {
+        //error reading socket; a failing socket stays readable, so throttle
+        RF_CK_APP_LOG_LIMITED(LL_ERROR, 5u, 10.0)
+                << "Error reading from socket number = "
+                << m_socket->getSockFd() << "\n" << "Error number = "
+                << -readData.result << CoreKit::EndLog;
+        return;
+    }
+    else if (0 == readData.result)
+    {
+        this->onSocketClosed();
+        return;
+    }
+
+    /* The run loop reads into buffers of its own choosing, so the data is
+     * split up the same way successive read() calls would have split it.
+     */
+    while (offset < static_cast<size_t>(readData.result))
+    {
+        size_t originalSize = m_prototypeMessageNotification->m_message.size();
+        size_t chunkSize = std::min(
+                m_prototypeMessageNotification->m_message.capacity()
+                        - originalSize,
+                static_cast<size_t>(readData.result) - offset);
+
+        m_prototypeMessageNotification->m_message.resize(
+                originalSize + chunkSize);
+        memcpy(m_prototypeMessageNotification->m_message.data() + originalSize,
+                readData.data + offset, chunkSize);
+        offset += chunkSize;
+
+        this->deliverMessage();
+    }
+}
 
-        //Socket is closed, de-register from input to avoid invalid functionality
-        if (NULL != G_MyApp)
+void TcpMessageInputSource::onSocketClosed()
+{
+    //Socket is closed, de-register from input to avoid invalid functionality
+    if (NULL != G_MyApp)
+    {
+        G_MyApp->log() << CoreKit::AppLog::LL_WARNING << "Socket closed:  "
+                << m_socket->getSockFd() << CoreKit::EndLog;
+    }
+
+    if (NULL != m_loop)
+    {
+        try
         {
-            G_MyApp->log() << CoreKit::AppLog::LL_WARNING << "Socket closed:  "
-                    << m_socket->getSockFd() << CoreKit::EndLog;
+            m_loop->deregisterInputSource(this);
         }
-
-        if (NULL != m_loop)
+        catch (CoreKit::OsErrorException &osError)
         {
-            try
-            {
-                m_loop->deregisterInputSource(this);
-            }
-            catch (CoreKit::OsErrorException &osError)
+            if (NULL != G_MyApp)
             {
-                if (NULL != G_MyApp)
-                {
-                    G_MyApp->log() << AppLog::LL_WARNING
-                            << "Error de-registering input source "
-                            << osError.what() << CoreKit::EndLog;
-                }
+                G_MyApp->log() << AppLog::LL_WARNING
+                        << "Error de-registering input source "
+                        << osError.what() << CoreKit::EndLog;
             }
         }
+    }
 
-        //notify callbacks that this socket is disconnected
-        if (NULL == m_prototypeConnectionNotification)
-        {
-            m_prototypeConnectionNotification = new ConnectionNotification(m_socket,
-                    ConnectionStates::DISCONNECTED);
-        }
+    //notify callbacks that this socket is disconnected
+    if (NULL == m_prototypeConnectionNotification)
+    {
+        m_prototypeConnectionNotification = new ConnectionNotification(m_socket,
+                ConnectionStates::DISCONNECTED);
+    }
 
-        for_each(m_disconnectionCallbacks.begin(),
-                m_disconnectionCallbacks.end(),
-                bind2nd(mem_fun(&ConnectionCallback::operator()),
-                        m_prototypeConnectionNotification));
+    for_each(m_disconnectionCallbacks.begin(),
+            m_disconnectionCallbacks.end(),
+            bind2nd(mem_fun(&ConnectionCallback::operator()),
+                    m_prototypeConnectionNotification));
 
-        int closeReturn = m_socket->disconnect();
-        if (closeReturn < 0)
-        {
-            G_MyApp->log() << AppLog::LL_WARNING
-                    << "Error closing socket, error =  " << closeReturn
-                    << CoreKit::EndLog;
-        }
-
-        //clear the message notification in case this socket is later re-connected
-        m_prototypeMessageNotification->m_message.clear();
-    }
-    else
+    int closeReturn = m_socket->disconnect();
+    if (closeReturn < 0)
     {
-        m_prototypeMessageNotification->m_message.resize(
-                originalSize + recvResult);
+        G_MyApp->log() << AppLog::LL_WARNING
+                << "Error closing socket, error =  " << closeReturn
+                << CoreKit::EndLog;
+    }
 
-        if (!m_buffering
-                || m_prototypeMessageNotification->m_message.size()
-                        == m_prototypeMessageNotification->m_message.capacity())
-        {
-            clock_gettime(CLOCK_REALTIME,
-                    &(m_prototypeMessageNotification->m_acqTime));
-            for_each(m_messageCallbacks.begin(), m_messageCallbacks.end(),
-                    bind2nd(mem_fun(&TcpMessageCallback::operator()),
-                            m_prototypeMessageNotification));
+    //clear the message notification in case this socket is later re-connected
+    m_prototypeMessageNotification->m_message.clear();
+}
 
-            m_prototypeMessageNotification->m_message.clear();
-        }
+void TcpMessageInputSource::deliverMessage()
+{
+    if (!m_buffering
+            || m_prototypeMessageNotification->m_message.size()
+                    == m_prototypeMessageNotification->m_message.capacity())
+    {
+        clock_gettime(CLOCK_REALTIME,
+                &(m_prototypeMessageNotification->m_acqTime));
+        for_each(m_messageCallbacks.begin(), m_messageCallbacks.end(),
+                bind2nd(mem_fun(&TcpMessageCallback::operator()),
+                        m_prototypeMessageNotification));
+
+        m_prototypeMessageNotification->m_message.clear();
     }
 }
 
@@ -75,6 +75,14 @@ RF_CK_FACTORY_COMPATIBLE(TcpMessageInputSource)
 
     virtual void fireCallback();
 
+    /**
+     * \brief Handles data the run loop read from the socket on our behalf
+     * \details Used by run loops on the \c io_uring backend; the data is
+     * handled exactly like data read by \c inputAvailableFrom().
+     * \param readData outcome of the read
+     */
+    virtual void dataAvailable(CoreKit::PreReadData const& readData);
+
     /**
      * \brief Gets the socket instance for this input source
      * \param socket the socket to use for communication
@@ -127,6 +135,20 @@ private:
      * \param other object to assign
      */
     TcpMessageInputSource& operator=(const TcpMessageInputSource& other);
+
+    /**
+     * \brief Deregisters the socket and notifies the disconnection callbacks
+     */
+    void onSocketClosed();
+
+    /**
+     * \brief Notifies the message callbacks if a message is ready
+     * \details Without buffering, every read is a message; with buffering,
+     * only a full buffer is.
+     */
+    void deliverMessage();
+
+
     /** Connected Socket */
     TcpSocket *m_socket;
     /** Callbacks */
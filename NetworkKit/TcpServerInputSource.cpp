@@ -208,10 +208,7 @@ void TcpServerInputSource::fireCallback()
             // create the new TcpMessageListener for this connection
             m_listeners.push_back(listener);
 
-            if (NULL != G_MyApp)
-            {
-                G_MyApp->log() << AppLog::LL_DEBUG << "New connection accepted" << CoreKit::EndLog;
-            }
+            RF_CK_APP_LOG(LL_DEBUG) << "New connection accepted" << CoreKit::EndLog;
 
             ConnectionNotification *notification =
                 new ConnectionNotification(listener->getSocket(), ConnectionStates::CONNECTED);
@@ -84,14 +84,12 @@ public:
 
         if (n != dataToSend.size())
         {
-            std::stringstream errMsg;
-            errMsg << "Failed to write message to socket " << m_sockFd
-                    << " Error: " << errno;
-            if (NULL != CoreKit::G_MyApp)
-            {
-                CoreKit::G_MyApp->log() << CoreKit::AppLog::LL_WARNING << errMsg.str()
-                        << CoreKit::EndLog;
-            }
+            int sendErrno = errno;
+
+            // Fails once per message while the peer is gone, so throttle
+            RF_CK_APP_LOG_LIMITED(LL_WARNING, 5u, 10.0)
+                    << "Failed to write message to socket " << m_sockFd
+                    << " Error: " << sendErrno << CoreKit::EndLog;
         }
 
         return retCode;
@@ -5,7 +5,9 @@
  * \author Rolando J. Nieves
  */
 
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
 #include <stdexcept>
 #include <system_error>
 #include <sstream>
@@ -28,7 +30,8 @@ namespace NetworkKit
 UdpSocket::UdpSocket(std::string const& uxPath):
     m_selectedFamily(AF_UNIX),
     m_socketFd(-1),
-    m_listener(nullptr)
+    m_listener(nullptr),
+    m_pendingRead(nullptr)
 {
     memset(&m_sockaddrIp, 0x00, sizeof(m_sockaddrIp));
     memset(&m_sockaddrUn, 0x00, sizeof(m_sockaddrUn));
@@ -44,7 +47,8 @@ UdpSocket::UdpSocket(std::string const& uxPath):
 UdpSocket::UdpSocket(std::string const& ifAddr, int port):
     m_selectedFamily(AF_INET),
     m_socketFd(-1),
-    m_listener(nullptr)
+    m_listener(nullptr),
+    m_pendingRead(nullptr)
 {
     memset(&m_sockaddrUn, 0x00, sizeof(m_sockaddrUn));
     memset(&m_sockaddrIp, 0x00, sizeof(m_sockaddrIp));
@@ -202,6 +206,53 @@ UdpSocket::fireCallback()
     m_listener->inputAvailableFrom(this);
 }
 
+
+void
+UdpSocket::dataAvailable(CoreKit::PreReadData const& readData)
+{
+    m_pendingRead = &readData;
+    try
+    {
+        m_listener->inputAvailableFrom(this);
+    }
+    catch (...)
+    {
+        m_pendingRead = nullptr;
+        throw;
+    }
+    m_pendingRead = nullptr;
+}
+
+
+bool
+UdpSocket::takePendingRead(void *buffer, std::size_t bufferSize, struct sockaddr *fromAddr, socklen_t *fromAddrLen, ssize_t& result)
+{
+    if (nullptr == m_pendingRead)
+    {
+        return false;
+    }
+
+    if (m_pendingRead->result < 0)
+    {
+        errno = static_cast<int>(-m_pendingRead->result);
+        result = -1;
+    }
+    else
+    {
+        result = std::min(m_pendingRead->result, static_cast<ssize_t>(bufferSize));
+        memcpy(buffer, m_pendingRead->data, static_cast<std::size_t>(result));
+        if (m_pendingRead->peerAddress != nullptr)
+        {
+            memcpy(fromAddr, m_pendingRead->peerAddress, std::min(*fromAddrLen, m_pendingRead->peerAddressLength));
+            *fromAddrLen = m_pendingRead->peerAddressLength;
+        }
+    }
+    m_pendingRead = nullptr;
+
+    return true;
+}
+
+
 } // end namespace NetworkKit
 
 // vim: set ts=4 sw=4 expandtab:
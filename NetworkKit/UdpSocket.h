@@ -34,7 +34,24 @@ private:
     int m_selectedFamily;
     int m_socketFd;
     CoreKit::InterruptListener *m_listener;
-    
+    CoreKit::PreReadData const *m_pendingRead;
+
+    /**
+     * \brief Hand over the datagram the run loop read on our behalf, if any
+     * \details Follows the \c recvfrom() conventions; the datagram is
+     * consumed by the call.
+     * \param[out] buffer area receiving the datagram
+     * \param bufferSize size of \c buffer, in bytes
+     * \param[out] fromAddr area receiving the sender address
+     * \param[in,out] fromAddrLen size of \c fromAddr on input; size of the
+     *                sender address on output
+     * \param[out] result number of bytes placed in \c buffer, or -1 on error
+     *
+     * \return \c true if a datagram was pending; \c false if the caller
+     *         should read from the socket itself.
+     */
+    bool takePendingRead(void *buffer, std::size_t bufferSize, struct sockaddr *fromAddr, socklen_t *fromAddrLen, ssize_t& result);
+
 public:
 
     /**
@@ -145,6 +162,18 @@ public:
 
     virtual void fireCallback() override;
 
+    /**
+     * \brief Handle a datagram the run loop read on our behalf
+     * \details Only used when pre-reading is enabled via
+     * \c setPreReadMode(CoreKit::InputSource::PRM_MESSAGE) on a run loop
+     * using the \c io_uring backend. The listener is notified as usual,
+     * and the datagram is handed to the first \c receiveFrom() call it
+     * makes. Pre-reading is off by default, since datagrams longer than
+     * \c CoreKit::RunLoop::Configuration::uringBufferSize are truncated.
+     * \param readData outcome of the read
+     */
+    virtual void dataAvailable(CoreKit::PreReadData const& readData) override;
+
     // Copy and move not allowed
     UdpSocket(UdpSocket const& other) = delete;
     UdpSocket(UdpSocket&& other) = delete;
@@ -87,14 +87,28 @@ UdpSocket::receiveFrom(std::string& uxPath, ByteVector& packetContents)
 
     memset(&fromAddr, 0x00, sizeof(fromAddr));
 
-    ssize_t result = recvfrom(
-        m_socketFd,
-        packetContents.data(),
-        packetContents.size(),
-        MSG_DONTWAIT,
-        reinterpret_cast< struct sockaddr* >(&fromAddr),
-        &fromAddrLen
-    );
+    ssize_t result = -1;
+
+    if
+    (
+        !this->takePendingRead(
+            packetContents.data(),
+            packetContents.size(),
+            reinterpret_cast< struct sockaddr* >(&fromAddr),
+            &fromAddrLen,
+            result
+        )
+    )
+    {
+        result = recvfrom(
+            m_socketFd,
+            packetContents.data(),
+            packetContents.size(),
+            MSG_DONTWAIT,
+            reinterpret_cast< struct sockaddr* >(&fromAddr),
+            &fromAddrLen
+        );
+    }
 
     if
     (
@@ -138,14 +152,28 @@ UdpSocket::receiveFrom(std::string& ipAddr, int& port, ByteVector& packetContent
     memset(&fromAddr, 0x00, sizeof(fromAddr));
     memset(&addrArea[0], 0x00, INET_ADDRSTRLEN);
 
-    ssize_t result = recvfrom(
-        m_socketFd,
-        packetContents.data(),
-        packetContents.size(),
-        MSG_DONTWAIT,
-        reinterpret_cast< struct sockaddr* >(&fromAddr),
-        &fromAddrLen
-    );
+    ssize_t result = -1;
+
+    if
+    (
+        !this->takePendingRead(
+            packetContents.data(),
+            packetContents.size(),
+            reinterpret_cast< struct sockaddr* >(&fromAddr),
+            &fromAddrLen,
+            result
+        )
+    )
+    {
+        result = recvfrom(
+            m_socketFd,
+            packetContents.data(),
+            packetContents.size(),
+            MSG_DONTWAIT,
+            reinterpret_cast< struct sockaddr* >(&fromAddr),
+            &fromAddrLen
+        );
+    }
 
     if ((result >= 0) && (fromAddr.sin_family == AF_INET))
     {
@@ -89,7 +89,7 @@ SerialIo::~SerialIo()
     {
         if (NULL != m_log)
         {
-            *m_log << AppLog::LL_DEBUG << "Error de-registering input source " << osError.what() << CoreKit::EndLog;
+            RF_CK_LOG(*m_log, LL_DEBUG) << "Error de-registering input source " << osError.what() << CoreKit::EndLog;
         }
     }
 	this->closeSerialPort();
@@ -229,7 +229,7 @@ void SerialIo::stopSerialIo()
         {
             if (NULL != m_log)
             {
-                *m_log << AppLog::LL_DEBUG << "Error de-registering input source " << osError.what() << CoreKit::EndLog;
+                RF_CK_LOG(*m_log, LL_DEBUG) << "Error de-registering input source " << osError.what() << CoreKit::EndLog;
             }
         }
 	}
@@ -0,0 +1,426 @@
+/**
+ * \file BinaryLogDecoder.cpp
+ * \brief Renders the records of a \c CoreKit::BinaryLog file as text.
+ * \date 2026-10-16 21:05:37
+ * \author Rolando J. Nieves
+ */
+
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <CoreKit/BinaryLog.h>
+
+using CoreKit::BinaryLogDescriptorEntry;
+using CoreKit::BinaryLogFileHeader;
+using CoreKit::BinaryLogRecord;
+using std::string;
+using std::vector;
+
+/**
+ * \brief Size of the buffer each conversion is rendered in.
+ */
+#define RF_BLD_FIELD_SIZE (512u)
+
+
+namespace
+{
+
+/**
+ * \brief Call site as recorded in the descriptor area.
+ */
+struct CallSite
+{
+    string fileName;
+    unsigned lineNumber;
+    string format;
+};
+
+
+/**
+ * \brief Argument as decoded from a record.
+ */
+struct Argument
+{
+    char tag;
+    uint64_t bits;
+    string text;
+};
+
+
+/**
+ * \brief Record located in the ring.
+ */
+struct Located
+{
+    uint64_t sequence;
+    BinaryLogRecord const *record;
+
+    bool operator<(Located const& other) const { return (sequence < other.sequence); }
+};
+
+
+void
+usage(char const *progName)
+{
+    std::cerr << "Usage: " << progName << " [--sites] <binary log file>" << std::endl
+        << "  --sites  Follow each record with the source file and line that wrote it." << std::endl;
+}
+
+
+/**
+ * \brief Render a nanosecond time stamp the way \c AppLog does, to the
+ *        nanosecond.
+ */
+string
+renderTimestamp(uint64_t timestamp)
+{
+    time_t epochTime = static_cast< time_t >(timestamp / 1000000000uLL);
+    struct tm timeStruct;
+    char timeText[64];
+    char fullText[96];
+
+    memset(&timeStruct, 0, sizeof(timeStruct));
+    gmtime_r(&epochTime, &timeStruct);
+    strftime(timeText, sizeof(timeText), "%FT%T", &timeStruct);
+    snprintf(fullText, sizeof(fullText), "%s.%09lluZ", timeText,
+        static_cast< unsigned long long >(timestamp % 1000000000uLL));
+
+    return string(fullText);
+}
+
+
+vector< Argument >
+decodeArguments(BinaryLogRecord const *record, size_t payloadRoom)
+{
+    vector< Argument > result;
+    unsigned char const *cursor = reinterpret_cast< unsigned char const* >(record + 1);
+    size_t remaining = std::min< size_t >(record->argBytes, payloadRoom);
+
+    while (remaining > 0u)
+    {
+        Argument anArg;
+
+        anArg.tag = static_cast< char >(cursor[0]);
+        anArg.bits = 0u;
+        if (RF_CK_BLOG_ARG_STRING == anArg.tag)
+        {
+            size_t textLength = (remaining >= 2u) ? cursor[1] : 0u;
+
+            if ((remaining < 2u) || ((2u + textLength) > remaining))
+            {
+                break;
+            }
+            anArg.text.assign(reinterpret_cast< char const* >(cursor + 2), textLength);
+            cursor += 2u + textLength;
+            remaining -= 2u + textLength;
+        }
+        else
+        {
+            if (remaining < 9u)
+            {
+                break;
+            }
+            memcpy(&anArg.bits, cursor + 1, 8u);
+            cursor += 9u;
+            remaining -= 9u;
+        }
+        result.push_back(anArg);
+    }
+
+    return result;
+}
+
+
+/**
+ * \brief Apply one \c printf() conversion to a decoded argument.
+ *
+ * Length modifiers in the format are replaced to suit the width the value
+ * was recorded with, and a value whose type does not suit the conversion
+ * is rendered with one that does.
+ */
+string
+renderConversion(string const& flagsAndWidth, char conversion, Argument const& anArg)
+{
+    char fieldText[RF_BLD_FIELD_SIZE];
+    string spec = "%" + flagsAndWidth;
+    int64_t signedValue = 0;
+    double doubleValue = 0.0;
+
+    memcpy(&signedValue, &anArg.bits, sizeof(signedValue));
+    memcpy(&doubleValue, &anArg.bits, sizeof(doubleValue));
+    fieldText[0] = '\0';
+
+    if (RF_CK_BLOG_ARG_STRING == anArg.tag)
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + "s").c_str(), anArg.text.c_str());
+    }
+    else if (RF_CK_BLOG_ARG_DOUBLE == anArg.tag)
+    {
+        if (strchr("fFeEgGaA", conversion) == nullptr)
+        {
+            conversion = 'g';
+        }
+        snprintf(fieldText, sizeof(fieldText), (spec + conversion).c_str(), doubleValue);
+    }
+    else if (RF_CK_BLOG_ARG_POINTER == anArg.tag)
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + "p").c_str(),
+            reinterpret_cast< void* >(static_cast< uintptr_t >(anArg.bits)));
+    }
+    else if ('c' == conversion)
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + "c").c_str(), static_cast< int >(anArg.bits));
+    }
+    else if (strchr("di", conversion) != nullptr)
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + "lld").c_str(),
+            (RF_CK_BLOG_ARG_SIGNED == anArg.tag) ? static_cast< long long >(signedValue) : static_cast< long long >(anArg.bits));
+    }
+    else if (strchr("uoxX", conversion) != nullptr)
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + "ll" + conversion).c_str(), static_cast< unsigned long long >(anArg.bits));
+    }
+    else if (strchr("fFeEgGaA", conversion) != nullptr)
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + conversion).c_str(),
+            (RF_CK_BLOG_ARG_SIGNED == anArg.tag) ? static_cast< double >(signedValue) : static_cast< double >(anArg.bits));
+    }
+    else if (RF_CK_BLOG_ARG_SIGNED == anArg.tag)
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + "lld").c_str(), static_cast< long long >(signedValue));
+    }
+    else
+    {
+        snprintf(fieldText, sizeof(fieldText), (spec + "llu").c_str(), static_cast< unsigned long long >(anArg.bits));
+    }
+
+    return string(fieldText);
+}
+
+
+string
+renderRecord(string const& format, vector< Argument > const& args)
+{
+    string result;
+    size_t argIdx = 0u;
+    size_t fmtIdx = 0u;
+
+    while (fmtIdx < format.size())
+    {
+        if (format[fmtIdx] != '%')
+        {
+            result.push_back(format[fmtIdx++]);
+            continue;
+        }
+        if (((fmtIdx + 1u) < format.size()) && ('%' == format[fmtIdx + 1u]))
+        {
+            result.push_back('%');
+            fmtIdx += 2u;
+            continue;
+        }
+
+        string flagsAndWidth;
+
+        ++fmtIdx;
+        while ((fmtIdx < format.size()) && (strchr("-+ #0123456789.", format[fmtIdx]) != nullptr))
+        {
+            flagsAndWidth.push_back(format[fmtIdx++]);
+        }
+        while ((fmtIdx < format.size()) && (strchr("hljztL", format[fmtIdx]) != nullptr))
+        {
+            ++fmtIdx;
+        }
+        if (fmtIdx >= format.size())
+        {
+            break;
+        }
+
+        char conversion = format[fmtIdx++];
+
+        if (argIdx < args.size())
+        {
+            result += renderConversion(flagsAndWidth, conversion, args[argIdx++]);
+        }
+        else
+        {
+            result += "<missing>";
+        }
+    }
+
+    return result;
+}
+
+} // end anonymous namespace
+
+
+int
+main(int argc, char *argv[])
+{
+    string filePath;
+    bool showSites = false;
+    vector< char > fileData;
+    BinaryLogFileHeader const *header = nullptr;
+    std::map< uint32_t, CallSite > callSites;
+    vector< Located > records;
+    size_t slotsOffset = 0u;
+    uint64_t expectedSequence = 0u;
+
+    for (int argIdx = 1; argIdx < argc; ++argIdx)
+    {
+        if (strcmp(argv[argIdx], "--sites") == 0)
+        {
+            showSites = true;
+        }
+        else if (filePath.empty() && (argv[argIdx][0] != '-'))
+        {
+            filePath = argv[argIdx];
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (filePath.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    /*
+     * Read a copy rather than map the file, so a log still being written
+     * can be decoded as it stood.
+     */
+    std::ifstream logFile(filePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (!logFile)
+    {
+        std::cerr << "ERROR: Can not open \"" << filePath << "\": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    fileData.assign(std::istreambuf_iterator< char >(logFile), std::istreambuf_iterator< char >());
+
+    header = reinterpret_cast< BinaryLogFileHeader const* >(fileData.data());
+    if ((fileData.size() < sizeof(BinaryLogFileHeader)) ||
+        (memcmp(header->magic, RF_CK_BLOG_MAGIC, sizeof(header->magic)) != 0))
+    {
+        std::cerr << "ERROR: \"" << filePath << "\" is not a binary log file." << std::endl;
+        return 1;
+    }
+    if (header->version != RF_CK_BLOG_VERSION)
+    {
+        std::cerr << "ERROR: \"" << filePath << "\" has layout version " << header->version
+            << "; only version " << RF_CK_BLOG_VERSION << " is supported." << std::endl;
+        return 1;
+    }
+    slotsOffset = header->headerSize + header->descriptorAreaSize;
+    if ((header->slotSize < sizeof(BinaryLogRecord)) ||
+        (fileData.size() < (slotsOffset + (header->slotCount * header->slotSize))))
+    {
+        std::cerr << "ERROR: \"" << filePath << "\" is truncated." << std::endl;
+        return 1;
+    }
+
+    size_t descOffset = 0u;
+    size_t descBytes = std::min< size_t >(header->descriptorBytes.load(), header->descriptorAreaSize);
+
+    while ((descOffset + sizeof(BinaryLogDescriptorEntry)) <= descBytes)
+    {
+        BinaryLogDescriptorEntry const *entry =
+            reinterpret_cast< BinaryLogDescriptorEntry const* >(fileData.data() + header->headerSize + descOffset);
+        char const *entryText = reinterpret_cast< char const* >(entry + 1);
+        size_t entryBytes = sizeof(BinaryLogDescriptorEntry) + entry->fileLength + entry->formatLength;
+
+        if ((descOffset + entryBytes) > descBytes)
+        {
+            break;
+        }
+        callSites[entry->id].fileName.assign(entryText, entry->fileLength);
+        callSites[entry->id].lineNumber = entry->line;
+        callSites[entry->id].format.assign(entryText + entry->fileLength, entry->formatLength);
+        descOffset += (entryBytes + 7u) & ~static_cast< size_t >(7u);
+    }
+
+    /*
+     * A writer that takes over a slot clears its sequence number before
+     * touching the rest, and the numbers only grow, so a slot copied while
+     * it was being overwritten no longer holds the sequence number it was
+     * copied with.
+     */
+    logFile.clear();
+    for (uint64_t slotIdx = 0u; slotIdx < header->slotCount; ++slotIdx)
+    {
+        size_t slotOffset = slotsOffset + (slotIdx * header->slotSize);
+        BinaryLogRecord const *record = reinterpret_cast< BinaryLogRecord const* >(fileData.data() + slotOffset);
+        uint64_t storedSequence = record->sequence.load();
+        uint64_t currentSequence = 0u;
+
+        // A slot only ever holds sequence numbers that map to it.
+        if ((storedSequence == 0u) || (((storedSequence - 1u) % header->slotCount) != slotIdx))
+        {
+            continue;
+        }
+        if (!logFile.seekg(slotOffset) || !logFile.read(reinterpret_cast< char* >(&currentSequence), sizeof(currentSequence)))
+        {
+            std::cerr << "ERROR: Can not read \"" << filePath << "\" again: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        if (currentSequence == storedSequence)
+        {
+            Located aRecord = { storedSequence - 1u, record };
+
+            records.push_back(aRecord);
+        }
+    }
+    std::sort(records.begin(), records.end());
+
+    for (vector< Located >::const_iterator recIt = records.begin(); recIt != records.end(); ++recIt)
+    {
+        BinaryLogRecord const *record = recIt->record;
+        vector< Argument > args = decodeArguments(record, header->slotSize - sizeof(BinaryLogRecord));
+        std::map< uint32_t, CallSite >::const_iterator siteIt = callSites.find(record->descriptorId);
+
+        if (recIt->sequence != expectedSequence)
+        {
+            std::cout << "(" << (recIt->sequence - expectedSequence) << " records overwritten or incomplete)" << std::endl;
+        }
+        expectedSequence = recIt->sequence + 1u;
+
+        std::cout << "[" << renderTimestamp(record->timestamp) << "] [" << recIt->sequence << "]: ";
+        if (siteIt != callSites.end())
+        {
+            std::cout << renderRecord(siteIt->second.format, args);
+        }
+        else
+        {
+            std::cout << "<call site " << record->descriptorId << " not recorded>";
+            for (vector< Argument >::const_iterator argIt = args.begin(); argIt != args.end(); ++argIt)
+            {
+                std::cout << " " << renderConversion("", argIt->tag, *argIt);
+            }
+        }
+        if (record->flags & RF_CK_BLOG_TRUNCATED)
+        {
+            std::cout << " <arguments truncated>";
+        }
+        if (showSites && (siteIt != callSites.end()))
+        {
+            std::cout << " (" << siteIt->second.fileName << ":" << siteIt->second.lineNumber << ")";
+        }
+        std::cout << '\n';
+    }
+
+    return 0;
+}
+
+// vim: set ts=4 sw=4 expandtab: